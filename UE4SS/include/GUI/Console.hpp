@@ -1,11 +1,12 @@
 #pragma once
 
+#include <cstdint>
+#include <deque>
 #include <mutex>
 #include <string>
 #include <vector>
 
 #include <DynamicOutput/OutputDevice.hpp>
-#include <TextEditor.h>
 #include <imgui.h>
 
 using namespace RC;
@@ -15,30 +16,49 @@ namespace RC::GUI
     class Console
     {
       private:
-        char m_input_buffer[256]{};
-        std::vector<std::string> m_lines{};
-        ImGuiTextFilter m_filter{};
-        float m_previous_max_scroll_y{};
-        float m_current_console_output_width{};
-        std::mutex m_lines_mutex{};
-        TextEditor m_text_editor{};
-        TextEditor::Breakpoints m_breakpoints{};
-        const size_t m_maximum_num_lines{50000};
+        struct Line
+        {
+            std::string text{};
+            Color::Color color{};
+        };
 
-      public:
-        Console()
+        // A line that's wider than the console is split into several rows, only lines that pass the filter have rows
+        struct Row
         {
-            m_text_editor.SetConsoleMode(true);
-            m_text_editor.SetColorizerEnable(false);
-            m_text_editor.SetLanguageDefinition(GetLanguageDefinitionNone());
-            m_text_editor.SetPalette(GetPalette());
-            m_text_editor.SetBreakpoints(m_breakpoints);
-            m_text_editor.SetTextFilter(&m_filter);
-        }
+            uint64_t line_index{};
+            uint32_t begin{};
+            uint32_t end{};
+        };
+
+      private:
+        const size_t m_maximum_num_lines{50000};
+
+        // Lines are added here by whichever thread logs them and moved to 'm_lines' by the render thread once per frame
+        // That way logging only ever waits for another thread that's logging, and never for a frame to be rendered
+        std::mutex m_pending_lines_mutex{};
+        std::deque<Line> m_pending_lines{};
+
+        // Everything below is only used by the render thread
+        std::deque<Line> m_taken_lines{};
+
+        // A ring of the newest 'm_maximum_num_lines' lines, the oldest line is overwritten once it's full
+        std::vector<Line> m_lines{};
+        uint64_t m_num_lines_added{};
+
+        std::deque<Row> m_rows{};
+        float m_wrap_width{};
+        bool m_should_rebuild_rows{};
+
+        ImGuiTextFilter m_filter{};
 
       private:
-        auto GetLanguageDefinitionNone() -> const TextEditor::LanguageDefinition&;
-        auto GetPalette() const -> const TextEditor::Palette&;
+        auto get_oldest_line_index() const -> uint64_t;
+        auto get_line(uint64_t line_index) const -> const Line&;
+        auto take_pending_lines() -> void;
+        auto add_rows(uint64_t line_index) -> void;
+        auto rebuild_rows() -> void;
+        auto render_row(const Row& row) -> void;
+        auto copy_filtered_lines_to_clipboard() -> void;
 
       public:
         auto render() -> void;
@@ -65,6 +65,20 @@ namespace RC
             int64_t LiveViewObjectsPerGroup{64 * 1024 / 2};
         } Debug;
 
+        struct SectionLogging
+        {
+            bool AsyncLogging{true};
+            int64_t AsyncLoggingQueueSize{8192};
+            File::StringType AsyncLoggingQueueFullPolicy{STR("Block")};
+            bool VerboseLogging{true};
+            bool BinaryLogging{false};
+            int64_t MaxLogFileSize{0};
+            int64_t MaxRotatedLogFiles{5};
+            int64_t DeduplicationWindow{0};
+            int64_t RateLimitBurst{200};
+            int64_t RateLimitPerSecond{0};
+        } Logging;
+
         struct SectionCrashDump
         {
             bool EnableDumping{true};
@@ -75,6 +89,7 @@ namespace RC
         {
             int64_t SigScannerNumThreads{8};
             int64_t SigScannerMultithreadingModuleSizeThreshold{16777216};
+            File::StringType SigScannerMethod{STR("Simd")};
         } Threads;
 
         struct SectionMemory
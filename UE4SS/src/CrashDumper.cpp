@@ -10,6 +10,9 @@
 #include <Windows.h>
 #include <dbghelp.h>
 
+#include <DynamicOutput/AsyncOutput.hpp>
+#include <DynamicOutput/BinaryLog.hpp>
+
 namespace fs = std::filesystem;
 
 using std::chrono::seconds;
@@ -24,6 +27,10 @@ namespace RC
 
     LONG WINAPI ExceptionHandler(_EXCEPTION_POINTERS* exception_pointers)
     {
+        // Whatever was logged right before the crash is usually the most useful part of the log, so it's written out before anything else can go wrong
+        Output::flush_on_crash();
+        Output::BinaryLog::flush_on_crash();
+
         const auto now = time_point_cast<seconds>(system_clock::now());
         const std::wstring dump_path = (fs::current_path() / std::format("crash_{:%Y_%m_%d_%H_%M_%S}.dmp", now)).wstring();
 
@@ -1,5 +1,8 @@
-#include <ctype.h>
+#include <algorithm>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
 
 #include <DynamicOutput/DynamicOutput.hpp>
 #include <GUI/Console.hpp>
@@ -11,206 +14,257 @@
 
 namespace RC::GUI
 {
-    // Wrapper for CalcTextSizeA.
-    auto CalcTextSize(const char* text, float max_width, const char** remaining = nullptr) -> ImVec2
+    static auto LogLevel_to_ImColor(Color::Color color) -> std::pair<ImColor, ImColor>
     {
-        ImGuiContext& g = *GImGui;
-        ImFont* font = g.Font;
-        const float font_size = g.FontSize;
-        ImVec2 text_size = font->CalcTextSizeA(font_size, max_width, -1.0f, text, nullptr, remaining);
-        text_size.x = IM_FLOOR(text_size.x + 0.99999f);
-        return text_size;
+        switch (color)
+        {
+        case Color::Default:
+            return {g_imgui_text_editor_default_bg_color, g_imgui_text_editor_default_text_color};
+        case Color::NoColor:
+            return {g_imgui_text_editor_normal_bg_color, g_imgui_text_editor_normal_text_color};
+        case Color::Cyan:
+            return {g_imgui_text_editor_verbose_bg_color, g_imgui_text_editor_verbose_text_color};
+        case Color::Yellow:
+            return {g_imgui_text_editor_warning_bg_color, g_imgui_text_editor_warning_text_color};
+        case Color::Red:
+            return {g_imgui_text_editor_error_bg_color, g_imgui_text_editor_error_text_color};
+        case Color::Green:
+            return {g_imgui_text_editor_default_bg_color, g_imgui_text_green_color};
+        case Color::Blue:
+            return {g_imgui_text_editor_default_bg_color, g_imgui_text_blue_color};
+        case Color::Purple:
+            return {g_imgui_text_editor_default_bg_color, g_imgui_text_purple_color};
+        }
+
+        throw std::runtime_error{"[LogLevel_to_ImColor] Unhandled log_level"};
     }
 
-    auto Console::GetLanguageDefinitionNone() -> const TextEditor::LanguageDefinition&
+    auto Console::get_oldest_line_index() const -> uint64_t
     {
-        static bool inited = false;
-        static TextEditor::LanguageDefinition langDef;
-        if (!inited)
-        {
-            langDef.mName = "None";
-            inited = true;
-        }
-        return langDef;
+        return m_num_lines_added > m_maximum_num_lines ? m_num_lines_added - m_maximum_num_lines : 0;
     }
 
-    auto Console::GetPalette() const -> const TextEditor::Palette&
+    auto Console::get_line(uint64_t line_index) const -> const Line&
     {
-        const static TextEditor::Palette p = {{
-                ImGui::ColorConvertFloat4ToU32(ImVec4{0.800f, 0.800f, 0.800f, 1.0f}), // Default
-                0xffd69c56,                                                           // Keyword
-                0xff00ff00,                                                           // Number
-                0xff7070e0,                                                           // String
-                0xff70a0e0,                                                           // Char literal
-                0xffffffff,                                                           // Punctuation
-                0xff408080,                                                           // Preprocessor
-                0xffaaaaaa,                                                           // Identifier
-                0xff9bc64d,                                                           // Known identifier
-                0xffc040a0,                                                           // Preproc identifier
-                0xff206020,                                                           // Comment (single line)
-                0xff406020,                                                           // Comment (multi line)
-                ImGui::ColorConvertFloat4ToU32(ImVec4{0.156f, 0.156f, 0.156f, 1.0f}), // Background
-                0xffe0e0e0,                                                           // Cursor
-                ImGui::ColorConvertFloat4ToU32(ImVec4{0.65f, 0.24f, 0.57f, 0.38f}),   // Selection
-                0x800020ff,                                                           // ErrorMarker
-                0x40f08000,                                                           // Breakpoint
-                0xff707000,                                                           // Line number
-                0x40000000,                                                           // Current line fill
-                0x40808080,                                                           // Current line fill (inactive)
-                0x40a0a0a0,                                                           // Current line edge
-        }};
-        return p;
+        return m_lines[line_index % m_maximum_num_lines];
     }
 
-    auto Console::render() -> void
+    auto Console::take_pending_lines() -> void
     {
-        /*
-        auto max_line_width = m_current_console_output_width - 10.0f;
-        std::string console_buffer{};
         {
-            std::lock_guard<std::mutex> guard(m_lines_mutex);
-            for (const auto& line : m_lines)
+            std::lock_guard<std::mutex> guard(m_pending_lines_mutex);
+            if (m_pending_lines.empty())
             {
-                if (!m_filter.PassFilter(line.c_str()))
-                {
-                    continue;
-                }
-                const char* remaining{};
-                auto line_width = CalcTextSize(line.c_str(), m_current_console_output_width, &remaining).x;
-                auto max_string_length = remaining - line.c_str();
-                if (max_string_length > 0 && line_width > max_line_width)
-                {
-                    auto num_lines = static_cast<int>(std::ceil(line.length() / max_string_length)) + 1;
-                    int last_line{};
-                    for (int i = 0; num_lines > 0 && i < num_lines; ++i)
-                    {
-                        console_buffer.append(line.substr(last_line, max_string_length));
-                        console_buffer.append("\n");
-                        last_line = last_line + max_string_length;
-                    }
-                }
-                else
-                {
-                    console_buffer.append(line);
-                    console_buffer.append("\n");
-                }
+                return;
             }
+            m_taken_lines.swap(m_pending_lines);
         }
 
-        const float footer_height_to_reserve = (ImGui::GetStyle().ItemSpacing.y * 10.0f) + ImGui::GetFrameHeightWithSpacing();
-        ImGui_InputTextMultiline_WithAutoScroll("##consolebuffer", console_buffer.data(), console_buffer.size() + 1, {-10, -footer_height_to_reserve},
-        ImGuiInputTextFlags_ReadOnly, nullptr, nullptr, &m_previous_max_scroll_y); m_current_console_output_width = ImGui::CalcItemWidth();
+        for (auto& line : m_taken_lines)
+        {
+            const auto line_index = m_num_lines_added++;
+            if (m_lines.size() < m_maximum_num_lines)
+            {
+                m_lines.emplace_back(std::move(line));
+            }
+            else
+            {
+                m_lines[line_index % m_maximum_num_lines] = std::move(line);
+            }
 
-        ImGui::Separator();
+            // All rows are about to be rebuilt anyway
+            if (m_should_rebuild_rows)
+            {
+                continue;
+            }
 
-        ImGui::BeginDisabled(true);
-        bool reclaim_focus{};
-        ImGuiInputTextFlags input_text_flags = ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_CallbackCompletion |
-        ImGuiInputTextFlags_CallbackHistory; auto text_edit_callback_wrapper = [](ImGuiInputTextCallbackData* data) -> int { Console* console =
-        static_cast<Console*>(data->UserData); Output::send(STR("text_edit_callback_wrapper\n"));
-            //return console->text_edit_callback(data);
-            return 0;
-        };
-        ImGui::PushItemWidth(-12.0f);
-        if (ImGui::InputText("##console_input_buffer", m_input_buffer, IM_ARRAYSIZE(m_input_buffer), input_text_flags, text_edit_callback_wrapper, this))
-        {
-            Output::send(STR("ConsoleInput\n"));
-            reclaim_focus = true;
+            const auto& text = get_line(line_index).text;
+            if (m_filter.PassFilter(text.data(), text.data() + text.size()))
+            {
+                add_rows(line_index);
+            }
         }
-        ImGui::PopItemWidth();
+        m_taken_lines.clear();
+    }
 
-        ImGui::SetItemDefaultFocus();
-        if (reclaim_focus)
+    auto Console::add_rows(uint64_t line_index) -> void
+    {
+        const auto& text = get_line(line_index).text;
+        if (text.empty())
         {
-            ImGui::SetKeyboardFocusHere(-1);
+            m_rows.emplace_back(Row{line_index, 0, 0});
+            return;
         }
-        ImGui::EndDisabled();
-        //*/
 
-        /**/
-        const float footer_height_to_reserve = (ImGui::GetStyle().ItemSpacing.y * 10.0f) + ImGui::GetFrameHeightWithSpacing();
+        ImFont* font = ImGui::GetFont();
+        const float scale = ImGui::GetFontSize() / font->FontSize;
+        const char* text_begin = text.data();
+        const char* text_end = text_begin + text.size();
+        const char* row_begin = text_begin;
+        while (row_begin < text_end)
         {
-            std::lock_guard<std::mutex> guard(m_lines_mutex);
-            m_text_editor.Render("TextEditor", {-10, -footer_height_to_reserve});
+            const char* row_end = m_wrap_width > 0.0f ? font->CalcWordWrapPositionA(scale, row_begin, text_end, m_wrap_width) : text_end;
+            if (row_end <= row_begin)
+            {
+                // The console is narrower than a single character, it still gets a row to itself
+                unsigned int c{};
+                row_end = row_begin + std::max(ImTextCharFromUtf8(&c, row_begin, text_end), 1);
+            }
+            m_rows.emplace_back(Row{line_index, static_cast<uint32_t>(row_begin - text_begin), static_cast<uint32_t>(row_end - text_begin)});
+
+            // The spaces that a line was wrapped on aren't shown at the start of the next row
+            row_begin = row_end;
+            while (row_begin < text_end && *row_begin == ' ')
+            {
+                ++row_begin;
+            }
         }
-        ImGui_AutoScroll("TextEditor", &m_previous_max_scroll_y);
-        //*/
     }
 
-    auto Console::render_search_box() -> void
+    auto Console::rebuild_rows() -> void
     {
-        m_filter.Draw("Search log", 200);
+        m_rows.clear();
+        for (auto line_index = get_oldest_line_index(); line_index < m_num_lines_added; ++line_index)
+        {
+            const auto& text = get_line(line_index).text;
+            if (m_filter.PassFilter(text.data(), text.data() + text.size()))
+            {
+                add_rows(line_index);
+            }
+        }
+        m_should_rebuild_rows = false;
     }
 
-    static auto LogLevel_to_ImColor(Color::Color color) -> std::pair<ImColor, ImColor>
+    auto Console::render_row(const Row& row) -> void
     {
-        switch (color)
+        const auto& line = get_line(row.line_index);
+        const auto [bg_color, text_color] = LogLevel_to_ImColor(line.color);
+        if (line.color != Color::Default && line.color != Color::NoColor)
         {
-        case Color::Default:
-            return {g_imgui_text_editor_default_bg_color, g_imgui_text_editor_default_text_color};
-        case Color::NoColor:
-            return {g_imgui_text_editor_normal_bg_color, g_imgui_text_editor_normal_text_color};
-        case Color::Cyan:
-            return {g_imgui_text_editor_verbose_bg_color, g_imgui_text_editor_verbose_text_color};
-        case Color::Yellow:
-            return {g_imgui_text_editor_warning_bg_color, g_imgui_text_editor_warning_text_color};
-        case Color::Red:
-            return {g_imgui_text_editor_error_bg_color, g_imgui_text_editor_error_text_color};
-        case Color::Green:
-            return {g_imgui_text_editor_default_bg_color, g_imgui_text_green_color};
-        case Color::Blue:
-            return {g_imgui_text_editor_default_bg_color, g_imgui_text_blue_color};
-        case Color::Purple:
-            return {g_imgui_text_editor_default_bg_color, g_imgui_text_purple_color};
+            const ImVec2 row_min = ImGui::GetCursorScreenPos();
+            const ImVec2 row_max{row_min.x + ImGui::GetContentRegionAvail().x, row_min.y + ImGui::GetTextLineHeightWithSpacing()};
+            ImGui::GetWindowDrawList()->AddRectFilled(row_min, row_max, bg_color);
         }
 
-        throw std::runtime_error{"[LogLevel_to_ImColor] Unhandled log_level"};
+        ImGui::PushStyleColor(ImGuiCol_Text, text_color.Value);
+        ImGui::TextUnformatted(line.text.data() + row.begin, line.text.data() + row.end);
+        ImGui::PopStyleColor();
     }
 
-    auto Console::add_line(const std::string& line, Color::Color color) -> void
+    auto Console::copy_filtered_lines_to_clipboard() -> void
     {
-        std::lock_guard<std::mutex> guard(m_lines_mutex);
-        if (m_text_editor.GetTotalLines() < 0)
+        std::string text{};
+        std::optional<uint64_t> previous_line_index{};
+        for (const auto& row : m_rows)
         {
-            throw std::runtime_error{"Somehow we negative amount of lines in the console"};
+            if (previous_line_index == row.line_index)
+            {
+                continue;
+            }
+            text.append(get_line(row.line_index).text);
+            text.push_back('\n');
+            previous_line_index = row.line_index;
         }
-        if (static_cast<size_t>(m_text_editor.GetTotalLines()) >= m_maximum_num_lines)
+        ImGui::SetClipboardText(text.c_str());
+    }
+
+    auto Console::render() -> void
+    {
+        const float footer_height_to_reserve = (ImGui::GetStyle().ItemSpacing.y * 10.0f) + ImGui::GetFrameHeightWithSpacing();
+        ImGui::BeginChild("##console_output", {-10, -footer_height_to_reserve});
+
+        const float wrap_width = ImGui::GetContentRegionAvail().x;
+        if (wrap_width != m_wrap_width)
         {
-            m_text_editor.ClearLines();
+            m_wrap_width = wrap_width;
+            m_should_rebuild_rows = true;
         }
-        if (m_lines.size() >= m_maximum_num_lines)
+
+        // The scroll values are from the previous frame, so this is whether the user had scrolled to the bottom before the new lines were added
+        const bool was_scrolled_to_bottom = ImGui::GetScrollY() >= ImGui::GetScrollMaxY();
+        const float row_height = ImGui::GetTextLineHeightWithSpacing();
+
+        take_pending_lines();
+        if (m_should_rebuild_rows)
         {
-            m_lines.clear();
+            rebuild_rows();
         }
-        if (color != Color::Default && color != Color::NoColor)
+        else
         {
-            m_text_editor.GetLineColorMarkers().emplace(m_text_editor.GetTotalLines() + 1, LogLevel_to_ImColor(color));
+            // Rows of lines that were overwritten in the ring are at the front, and the rest must be moved up by as much to stay where the user left them
+            const auto oldest_line_index = get_oldest_line_index();
+            size_t num_rows_removed{};
+            while (!m_rows.empty() && m_rows.front().line_index < oldest_line_index)
+            {
+                m_rows.pop_front();
+                ++num_rows_removed;
+            }
+            if (num_rows_removed > 0 && !was_scrolled_to_bottom)
+            {
+                ImGui::SetScrollY(std::max(0.0f, ImGui::GetScrollY() - static_cast<float>(num_rows_removed) * row_height));
+            }
         }
-        m_lines.emplace_back(line);
-        m_text_editor.AddTextLine(line);
-    }
 
-    auto Console::add_line(const std::wstring& line, Color::Color color) -> void
-    {
-        auto ansi_string = to_string(line);
-        std::lock_guard<std::mutex> guard(m_lines_mutex);
-        if (m_text_editor.GetTotalLines() < 0)
+        // Only the rows that are visible are actually drawn
+        ImGuiListClipper clipper{};
+        clipper.Begin(static_cast<int>(m_rows.size()), row_height);
+        while (clipper.Step())
         {
-            throw std::runtime_error{"Somehow we negative amount of lines in the console"};
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+            {
+                render_row(m_rows[i]);
+            }
         }
-        if (static_cast<size_t>(m_text_editor.GetTotalLines()) >= m_maximum_num_lines)
+
+        if (was_scrolled_to_bottom)
         {
-            m_text_editor.ClearLines();
+            ImGui::SetScrollHereY(1.0f);
         }
-        if (m_lines.size() >= m_maximum_num_lines)
+
+        if (ImGui::BeginPopupContextWindow())
         {
-            m_lines.clear();
+            if (ImGui::MenuItem(m_filter.IsActive() ? "Copy filtered lines" : "Copy all lines"))
+            {
+                copy_filtered_lines_to_clipboard();
+            }
+            ImGui::EndPopup();
         }
-        if (color != Color::Default && color != Color::NoColor)
+
+        ImGui::EndChild();
+    }
+
+    auto Console::render_search_box() -> void
+    {
+        if (m_filter.Draw("Search log", 200))
         {
-            m_text_editor.GetLineColorMarkers().emplace(m_text_editor.GetTotalLines() + 1, LogLevel_to_ImColor(color));
+            m_should_rebuild_rows = true;
         }
-        m_lines.emplace_back(ansi_string);
-        m_text_editor.AddTextLine(ansi_string);
+    }
+
+    auto Console::add_line(const std::string& line, Color::Color color) -> void
+    {
+        // Every line in a multi-line message is its own line in the console, so that it can be filtered on its own
+        std::lock_guard<std::mutex> guard(m_pending_lines_mutex);
+        size_t line_begin{};
+        while (true)
+        {
+            const auto line_end = line.find('\n', line_begin);
+            m_pending_lines.emplace_back(Line{line.substr(line_begin, line_end == std::string::npos ? line_end : line_end - line_begin), color});
+            if (m_pending_lines.size() > m_maximum_num_lines)
+            {
+                // The GUI isn't taking any lines, either it's not being rendered or it's behind, only the newest lines would be kept anyway
+                m_pending_lines.pop_front();
+            }
+            if (line_end == std::string::npos)
+            {
+                break;
+            }
+            line_begin = line_end + 1;
+        }
+    }
+
+    auto Console::add_line(const std::wstring& line, Color::Color color) -> void
+    {
+        add_line(to_string(line), color);
     }
 } // namespace RC::GUI
@@ -373,7 +373,7 @@ namespace RC::GUI
                                     File::OpenFor::Reading,
                                     File::OverwriteExistingFile::No,
                                     File::CreateIfNonExistent::Yes);
-        auto json_file_contents = json_file.read_all();
+        auto json_file_contents = json_file.read_all_view();
         if (json_file_contents.empty())
         {
             return;
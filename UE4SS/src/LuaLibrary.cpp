@@ -5,6 +5,7 @@
 #include <Helpers/String.hpp>
 #include <LuaLibrary.hpp>
 #include <LuaMadeSimple/LuaMadeSimple.hpp>
+#include <Mod/LuaMod.hpp>
 #include <UE4SSProgram.hpp>
 #include <Unreal/FOutputDevice.hpp>
 #include <Unreal/UnrealInitializer.hpp>
@@ -49,6 +50,16 @@ namespace RC::LuaLibrary
         // The output device is at the top of the stack, therefore we must call this function after retrieving all of the params.
         auto* output_device = get_outputdevice_ref(lua);
 
+        // Everything that a mod prints is rate limited together, scripts that aren't mods like the signature scripts are never rate limited
+        File::StringViewType mod_name{};
+        const bool has_mod = lua_getglobal(lua.get_lua_state(), "ModRef") != LUA_TNIL;
+        lua.discard_value(-1);
+        if (has_mod)
+        {
+            mod_name = get_mod_ref(lua)->get_name();
+        }
+        Output::ScopedOutputSource output_source{mod_name};
+
         if (stack_size == 1)
         {
             auto formatted_string = std::format(STR("[Lua] {}"), format.c_str());
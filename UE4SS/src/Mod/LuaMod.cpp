@@ -7,6 +7,7 @@
 #include <stdexcept>
 #include <string>
 
+#include <DynamicOutput/BinaryLog.hpp>
 #include <DynamicOutput/DynamicOutput.hpp>
 #include <ExceptionHandling.hpp>
 #include <Helpers/Format.hpp>
@@ -1390,9 +1391,9 @@ Overloads:
                 if (native_hook_pre_id_it != LuaMod::m_generic_hook_id_to_native_hook_id.end() &&
                     native_hook_post_id_it != LuaMod::m_generic_hook_id_to_native_hook_id.end())
                 {
-                    Output::send<LogLevel::Verbose>(STR("Unregistering native hook with pre-id: {}\n"), native_hook_pre_id_it->first);
+                    OUTPUT_SEND_BINARY(LogLevel::Verbose, STR("Unregistering native hook with pre-id: {}\n"), native_hook_pre_id_it->first);
                     unreal_function->UnregisterHook(static_cast<int32_t>(native_hook_pre_id_it->second));
-                    Output::send<LogLevel::Verbose>(STR("Unregistering native hook with post-id: {}\n"), native_hook_post_id_it->first);
+                    OUTPUT_SEND_BINARY(LogLevel::Verbose, STR("Unregistering native hook with post-id: {}\n"), native_hook_post_id_it->first);
                     unreal_function->UnregisterHook(static_cast<int32_t>(native_hook_post_id_it->second));
 
                     // LuaUnrealScriptFunctionData contains the hook's lua registry references, captured in RegisterHook in two different lua states.
@@ -1418,7 +1419,7 @@ Overloads:
                     if (auto callback_data_it = LuaMod::m_script_hook_callbacks.find(unreal_function->GetFullName());
                         callback_data_it != LuaMod::m_script_hook_callbacks.end())
                     {
-                        Output::send<LogLevel::Verbose>(STR("Unregistering script hook with id: {}\n"), post_id);
+                        OUTPUT_SEND_BINARY(LogLevel::Verbose, STR("Unregistering script hook with id: {}\n"), post_id);
                         auto& registry_indexes = callback_data_it->second.registry_indexes;
                         registry_indexes.erase(std::remove_if(registry_indexes.begin(),
                                                               registry_indexes.end(),
@@ -3012,10 +3013,14 @@ Overloads:
                 generic_pre_id = m_last_generic_hook_id;
                 m_generic_hook_id_to_native_hook_id.emplace(++m_last_generic_hook_id, post_id);
                 generic_post_id = m_last_generic_hook_id;
-                Output::send<LogLevel::Verbose>(STR("[RegisterHook] Registered native hook ({}, {}) for {}\n"),
-                                                generic_pre_id,
-                                                generic_post_id,
-                                                unreal_function->GetFullName());
+                if (Output::is_log_level_enabled(LogLevel::Verbose))
+                {
+                    OUTPUT_SEND_BINARY(LogLevel::Verbose,
+                                       STR("[RegisterHook] Registered native hook ({}, {}) for {}\n"),
+                                       generic_pre_id,
+                                       generic_post_id,
+                                       unreal_function->GetFullName());
+                }
             }
             else if (func_ptr && func_ptr == Unreal::UObject::ProcessInternalInternal.get_function_address() &&
                      !unreal_function->HasAnyFunctionFlags(Unreal::EFunctionFlags::FUNC_Native))
@@ -3025,10 +3030,14 @@ Overloads:
                 callback_data->second.registry_indexes.emplace_back(LuaMod::LuaCallbackData::RegistryIndex{lua_callback_registry_index, m_last_generic_hook_id});
                 generic_pre_id = m_last_generic_hook_id;
                 generic_post_id = m_last_generic_hook_id;
-                Output::send<LogLevel::Verbose>(STR("[RegisterHook] Registered script hook ({}, {}) for {}\n"),
-                                                generic_pre_id,
-                                                generic_post_id,
-                                                unreal_function->GetFullName());
+                if (Output::is_log_level_enabled(LogLevel::Verbose))
+                {
+                    OUTPUT_SEND_BINARY(LogLevel::Verbose,
+                                       STR("[RegisterHook] Registered script hook ({}, {}) for {}\n"),
+                                       generic_pre_id,
+                                       generic_post_id,
+                                       unreal_function->GetFullName());
+                }
             }
             else
             {
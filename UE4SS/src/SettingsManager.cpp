@@ -95,6 +95,18 @@ namespace RC
         }
         REGISTER_INT64_SETTING(Debug.LiveViewObjectsPerGroup, section_debug, LiveViewObjectsPerGroup);
 
+        constexpr static File::CharType section_logging[] = STR("Logging");
+        REGISTER_BOOL_SETTING(Logging.AsyncLogging, section_logging, AsyncLogging)
+        REGISTER_INT64_SETTING(Logging.AsyncLoggingQueueSize, section_logging, AsyncLoggingQueueSize)
+        REGISTER_STRING_SETTING(Logging.AsyncLoggingQueueFullPolicy, section_logging, AsyncLoggingQueueFullPolicy)
+        REGISTER_BOOL_SETTING(Logging.VerboseLogging, section_logging, VerboseLogging)
+        REGISTER_BOOL_SETTING(Logging.BinaryLogging, section_logging, BinaryLogging)
+        REGISTER_INT64_SETTING(Logging.MaxLogFileSize, section_logging, MaxLogFileSize)
+        REGISTER_INT64_SETTING(Logging.MaxRotatedLogFiles, section_logging, MaxRotatedLogFiles)
+        REGISTER_INT64_SETTING(Logging.DeduplicationWindow, section_logging, DeduplicationWindow)
+        REGISTER_INT64_SETTING(Logging.RateLimitBurst, section_logging, RateLimitBurst)
+        REGISTER_INT64_SETTING(Logging.RateLimitPerSecond, section_logging, RateLimitPerSecond)
+
         constexpr static File::CharType section_crash_dump[] = STR("CrashDump");
         REGISTER_BOOL_SETTING(CrashDump.EnableDumping, section_crash_dump, EnableDumping);
         REGISTER_BOOL_SETTING(CrashDump.FullMemoryDump, section_crash_dump, FullMemoryDump);
@@ -102,6 +114,7 @@ namespace RC
         constexpr static File::CharType section_threads[] = STR("Threads");
         REGISTER_INT64_SETTING(Threads.SigScannerNumThreads, section_threads, SigScannerNumThreads)
         REGISTER_INT64_SETTING(Threads.SigScannerMultithreadingModuleSizeThreshold, section_threads, SigScannerMultithreadingModuleSizeThreshold)
+        REGISTER_STRING_SETTING(Threads.SigScannerMethod, section_threads, SigScannerMethod)
 
         constexpr static File::CharType section_memory[] = STR("Memory");
         REGISTER_INT64_SETTING(Memory.MaxMemoryUsageDuringAssetLoading, section_memory, MaxMemoryUsageDuringAssetLoading)
@@ -1,6 +1,7 @@
 #include <DynamicOutput/DynamicOutput.hpp>
 #include <LuaLibrary.hpp>
 #include <LuaMadeSimple/LuaMadeSimple.hpp>
+#include <SigScanner/Resolver.hpp>
 #include <SigScanner/SinglePassSigScanner.hpp>
 #include <Signatures.hpp>
 #include <Unreal/FMemory.hpp>
@@ -11,6 +12,7 @@
 #include <Unreal/UObjectArray.hpp>
 #include <Unreal/UnrealInitializer.hpp>
 #include <filesystem>
+#include <optional>
 
 namespace RC
 {
@@ -35,10 +37,12 @@ namespace RC
 
         constexpr const char* global_register_func_name = "Register";
         constexpr const char* global_on_match_found_func_name = "OnMatchFound";
+        constexpr const char* global_resolver_func_name = "Resolver";
 
-        if (!lua.is_global_function(global_register_func_name) || !lua.is_global_function(global_on_match_found_func_name))
+        const bool has_resolver = lua.is_global_function(global_resolver_func_name);
+        if (!lua.is_global_function(global_register_func_name) || (!has_resolver && !lua.is_global_function(global_on_match_found_func_name)))
         {
-            Output::send(STR("Lua functions 'Register' and 'OnMatchFound' must be present in {}\n"), script_file_path_and_name);
+            Output::send(STR("Lua functions 'Register' and either 'OnMatchFound' or 'Resolver' must be present in {}\n"), script_file_path_and_name);
             throw std::runtime_error{"See error message above"};
         }
 
@@ -49,21 +53,47 @@ namespace RC
             throw std::runtime_error{"Lua function 'Register' must return a string that contains the signature to scan for"};
         }
 
+        // Compiled once here so that a broken signature is reported as an error in the script instead of in the middle of the scan
+        // Scripts have always been allowed to write a wildcard byte as a single '?'
+        SignatureData signature_data{.signature = normalize_signature(lua.get_string())};
+        signature_data.packed_signature = make_packed_signature(signature_data.signature);
+
+        // A resolver replaces 'OnMatchFound', it's evaluated natively on the scanner threads instead of calling into Lua for every match
+        std::optional<Resolver> resolver{};
+        if (has_resolver)
+        {
+            lua.call_function(global_resolver_func_name, 0, 1);
+            if (!lua.is_string())
+            {
+                throw std::runtime_error{"Lua function 'Resolver' must return a string that contains the steps to resolve a match with"};
+            }
+            resolver = Resolver::parse(lua.get_string());
+        }
+
         signature_containers.emplace_back(SignatureContainer{{
-                                                                     {lua.get_string().data()},
+                                                                     std::move(signature_data),
                                                              },
                                                              // On Match Found
-                                                             [&lua, match_found_func](SignatureContainer& self) -> bool {
-                                                                 lua.prepare_function_call(global_on_match_found_func_name);
-                                                                 lua.set_integer(reinterpret_cast<uintptr_t>(static_cast<void*>(self.get_match_address())));
-                                                                 lua.call_function(1, 1);
-
-                                                                 if (!lua.is_integer())
+                                                             [&lua, match_found_func, resolver](SignatureContainer& self) -> bool {
+                                                                 void* found_address{};
+                                                                 if (resolver)
                                                                  {
-                                                                     return false;
+                                                                     found_address = resolver->resolve(self.get_match_address(), &SinglePassScanner::is_readable);
+                                                                 }
+                                                                 else
+                                                                 {
+                                                                     lua.prepare_function_call(global_on_match_found_func_name);
+                                                                     lua.set_integer(reinterpret_cast<uintptr_t>(static_cast<void*>(self.get_match_address())));
+                                                                     lua.call_function(1, 1);
+
+                                                                     if (!lua.is_integer())
+                                                                     {
+                                                                         return false;
+                                                                     }
+
+                                                                     found_address = reinterpret_cast<void*>(lua.get_integer());
                                                                  }
 
-                                                                 void* found_address = reinterpret_cast<void*>(lua.get_integer());
                                                                  if (!found_address)
                                                                  {
                                                                      return false;
@@ -84,7 +114,10 @@ namespace RC
                                                              // On Scan Completed
                                                              [scan_complete_func]([[maybe_unused]] const SignatureContainer& self) {
                                                                  scan_complete_func(self.get_did_succeed() ? DidLuaScanSucceed::Yes : DidLuaScanSucceed::No);
-                                                             }});
+                                                             },
+                                                             false,
+                                                             // Every override is for a function or for code that references a global variable
+                                                             ScanSection::Code});
 
         // lua_close(lua.get_lua_state());
     }
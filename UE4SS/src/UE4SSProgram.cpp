@@ -14,6 +14,7 @@
 #include <unordered_set>
 
 #include <Profiler/Profiler.hpp>
+#include <DynamicOutput/BinaryLog.hpp>
 #include <DynamicOutput/DynamicOutput.hpp>
 #include <ExceptionHandling.hpp>
 #include <GUI/ConsoleOutputDevice.hpp>
@@ -188,8 +189,12 @@ namespace RC
             m_debugging_gui.set_gfx_backend(settings_manager.Debug.GraphicsAPI);
 
             // Setup the log file
-            auto& file_device = Output::set_default_devices<Output::NewFileDevice>();
+            auto& file_device = Output::set_default_devices<Output::BufferedFileDevice>();
             file_device.set_file_name_and_path(m_log_directory / m_log_file_name);
+            Output::BufferedFileDeviceOptions file_device_options{};
+            file_device_options.max_file_size = static_cast<uint64_t>(std::max<int64_t>(settings_manager.Logging.MaxLogFileSize, 0));
+            file_device_options.max_rotated_files = static_cast<uint32_t>(std::clamp<int64_t>(settings_manager.Logging.MaxRotatedLogFiles, 0, 100));
+            file_device.set_options(file_device_options);
 
             create_simple_console();
 
@@ -205,6 +210,48 @@ namespace RC
                 }
             }
 
+            if (!settings_manager.Logging.VerboseLogging)
+            {
+                Output::DefaultTargets::set_log_level_mask(Output::AllLogLevels & ~Output::log_level_bit(LogLevel::Verbose));
+            }
+
+            Output::OutputFilterOptions output_filter_options{};
+            output_filter_options.deduplication_window = std::chrono::milliseconds{std::max<int64_t>(settings_manager.Logging.DeduplicationWindow, 0)};
+            output_filter_options.rate_limit_burst =
+                    static_cast<uint32_t>(std::clamp<int64_t>(settings_manager.Logging.RateLimitBurst, 1, std::numeric_limits<uint32_t>::max()));
+            output_filter_options.rate_limit_per_second =
+                    static_cast<uint32_t>(std::clamp<int64_t>(settings_manager.Logging.RateLimitPerSecond, 0, std::numeric_limits<uint32_t>::max()));
+            Output::set_output_filter_options(output_filter_options);
+
+            // Every default device has been set by now, they can't be added once async output is enabled
+            if (settings_manager.Logging.AsyncLogging)
+            {
+                Output::AsyncOutputOptions async_output_options{};
+                if (settings_manager.Logging.AsyncLoggingQueueSize > 0)
+                {
+                    async_output_options.queue_size = static_cast<size_t>(settings_manager.Logging.AsyncLoggingQueueSize);
+                }
+                if (String::iequal(settings_manager.Logging.AsyncLoggingQueueFullPolicy, STR("Drop")))
+                {
+                    async_output_options.full_queue_policy = Output::FullQueuePolicy::Drop;
+                }
+                Output::enable_async_output(async_output_options);
+            }
+
+            if (settings_manager.Logging.BinaryLogging)
+            {
+                auto binary_log_path = m_log_directory / m_log_file_name;
+                binary_log_path.replace_extension(STR(".binlog"));
+                try
+                {
+                    Output::BinaryLog::open(binary_log_path);
+                }
+                catch (std::exception& e)
+                {
+                    Output::send<LogLevel::Warning>(STR("Binary logging is disabled: {}\n"), to_wstring(e.what()));
+                }
+            }
+
             // This is experimental code that's here only for future reference
             /*
             Unreal::UnrealInitializer::SetupUnrealModules();
@@ -260,6 +307,12 @@ namespace RC
                                                                       L"");
             m_load_library_ex_w_hook->hook();
 
+            // The hooks above only see the LoadLibrary calls of the game executable, plugins are also loaded by other modules and as dependencies
+            if (!SinglePassScanner::start_watching_module_loads())
+            {
+                Output::send<LogLevel::Warning>(STR("Could not watch for modules being loaded, signatures in modules that aren't loaded yet won't be found\n"));
+            }
+
             Unreal::UnrealInitializer::SetupUnrealModules();
 
             setup_mods();
@@ -304,9 +357,30 @@ namespace RC
         // Shut down the event loop
         m_processing_events = false;
 
+        // The pending containers belong to mods that are about to be destroyed, so no more scans can be allowed to call into them
+        SinglePassScanner::stop_watching_module_loads();
+        for (const auto& module_name : SinglePassScanner::get_pending_module_names())
+        {
+            Output::send<LogLevel::Warning>(STR("Signatures for module '{}' were never scanned for because it was never loaded\n"), module_name);
+        }
+
+        // Also outputs the 'repeated N times' messages that the output filter is still holding back
+        try
+        {
+            Output::flush();
+        }
+        catch (std::exception&)
+        {
+            // The devices are closed right after this, whatever couldn't be flushed is written by their destructors
+        }
+
+        // Everything that's still queued, including the warnings above, is output before any device is closed
+        Output::disable_async_output();
+
         // It's possible that main() will destroy the default devices (they are static)
         // However it's also possible that this program object is constructed in a context where main() is not gonna immediately exit
         // Because of that and because the default devices are created in the constructor, it's preferred to explicitly close all default devices in the destructor
+        Output::BinaryLog::close();
         Output::close_all_default_devices();
     }
 
@@ -332,6 +406,20 @@ namespace RC
                 }
             }
 
+            // Slowest module first, 'scan' is the time spent by all threads combined
+            Output::send(STR("Signature scan timings ({} threads):\n"), SinglePassScanner::m_num_threads);
+            for (const auto& module_stats : SinglePassScanner::get_module_scan_stats())
+            {
+                auto module_name = to_wstring(ScanTargetToString(module_stats.scan_target));
+                Output::send(STR("{}: {} scans, {:.2f} MB, {:.2f} MB avoided, wall={:.2f}ms, scan={:.2f}ms\n"),
+                             module_name.c_str(),
+                             module_stats.num_scans,
+                             static_cast<double>(module_stats.num_bytes_scanned) / (1024.0 * 1024.0),
+                             static_cast<double>(module_stats.num_bytes_avoided) / (1024.0 * 1024.0),
+                             std::chrono::duration<double, std::milli>(module_stats.wall_time).count(),
+                             std::chrono::duration<double, std::milli>(module_stats.scan_time).count());
+            }
+
             fire_unreal_init_for_cpp_mods();
             setup_unreal_properties();
             UAssetRegistry::SetMaxMemoryUsageDuringAssetLoading(settings_manager.Memory.MaxMemoryUsageDuringAssetLoading);
@@ -468,7 +556,7 @@ namespace RC
         if (std::filesystem::exists(file_path))
         {
             auto file = File::open(file_path);
-            if (auto file_contents = file.read_all(); !file_contents.empty())
+            if (auto file_contents = file.read_all_view(); !file_contents.empty())
             {
                 Ini::Parser parser;
                 parser.parse(file_contents);
@@ -495,6 +583,9 @@ namespace RC
         config.SecondsToScanBeforeGivingUp = settings_manager.General.SecondsToScanBeforeGivingUp;
         config.bUseUObjectArrayCache = settings_manager.General.UseUObjectArrayCache;
 
+        // The results of the signature scanner are cached next to the other caches and are reused for as long as the game executable doesn't change
+        SinglePassScanner::set_scan_cache_file(config.bEnableCache ? config.CachePath / "SignatureScanCache.bin" : std::filesystem::path{});
+
         // Retrieve from the config file the number of threads to be used for aob scanning
         {
             // The config system only directly supports signed 64-bit integers
@@ -521,6 +612,30 @@ namespace RC
             }
         }
 
+        {
+            const auto& scan_method_from_config = settings_manager.Threads.SigScannerMethod;
+            if (scan_method_from_config == STR("Scalar"))
+            {
+                SinglePassScanner::m_scan_method = SinglePassScanner::ScanMethod::Scalar;
+            }
+            else if (scan_method_from_config == STR("StdFind"))
+            {
+                SinglePassScanner::m_scan_method = SinglePassScanner::ScanMethod::StdFind;
+            }
+            else if (scan_method_from_config == STR("Simd"))
+            {
+                SinglePassScanner::m_scan_method = SinglePassScanner::ScanMethod::Simd;
+            }
+            else if (scan_method_from_config == STR("MultiPattern"))
+            {
+                SinglePassScanner::m_scan_method = SinglePassScanner::ScanMethod::MultiPattern;
+            }
+            else
+            {
+                Output::send<LogLevel::Warning>(STR("Unknown SigScannerMethod '{}' in UE4SS-settings.ini, using the default method\n"), scan_method_from_config);
+            }
+        }
+
         // Version override from ini file
         {
             int64_t major_version = settings_manager.EngineVersionOverride.MajorVersion;
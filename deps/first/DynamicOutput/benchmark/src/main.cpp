@@ -0,0 +1,433 @@
+// Benchmarks the static Output::send functions against each kind of device, with and without async output
+// Every thread sends a mix of messages that look like what UE4SS and its mods actually log, and every call is timed on its own
+// The devices that keep their output also count the lines they received, so the benchmark doubles as a check that no message was lost
+//
+// Usage: DynamicOutputBenchmark [--threads=1,2,4,8,16,32] [--devices=null,memory,file,buffered] [--modes=sync,async] [--messages=200000] [--dir=<path>]
+// The number of messages is per run and is split between the threads, files are written to the temp directory unless '--dir' is given
+// Latencies include the cost of reading the clock twice, which is roughly 20-50 ns on most machines
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <latch>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <DynamicOutput/BufferedFileDevice.hpp>
+#include <DynamicOutput/FileDevice.hpp>
+#include <DynamicOutput/Output.hpp>
+
+using namespace RC;
+
+enum class DeviceKind
+{
+    Null,
+    Memory,
+    File,
+    BufferedFile,
+};
+
+enum class Mode
+{
+    Sync,
+    Async,
+};
+
+struct Options
+{
+    std::vector<uint32_t> thread_counts{1, 2, 4, 8, 16, 32};
+    std::vector<DeviceKind> device_kinds{DeviceKind::Null, DeviceKind::Memory, DeviceKind::File, DeviceKind::BufferedFile};
+    std::vector<Mode> modes{Mode::Sync, Mode::Async};
+    size_t num_messages{200000};
+    std::filesystem::path directory{std::filesystem::temp_directory_path()};
+};
+
+// Does nothing with the message, what's left is the cost of 'send' itself
+class NullDevice : public Output::OutputDevice
+{
+  public:
+    auto receive(File::StringViewType) const -> void override
+    {
+    }
+};
+
+// Formats every message like a real device would and keeps it in memory, without any I/O
+class MemoryDevice : public Output::OutputDevice
+{
+  private:
+    // The buffer is emptied whenever it gets this large, so that long runs don't keep growing
+    static constexpr size_t MaxBufferSize = 16 * 1024 * 1024;
+
+    mutable std::mutex m_mutex{};
+    mutable File::StringType m_buffer{};
+    mutable uint64_t m_num_bytes{};
+    mutable uint64_t m_num_lines{};
+
+  public:
+    auto receive(File::StringViewType fmt) const -> void override
+    {
+        const auto message = m_formatter(fmt);
+
+        std::lock_guard lock{m_mutex};
+        if (m_buffer.size() + message.size() > MaxBufferSize)
+        {
+            m_buffer.clear();
+        }
+        m_buffer.append(message);
+        m_num_bytes += message.size() * sizeof(File::CharType);
+        m_num_lines += std::ranges::count(message, STR('\n'));
+    }
+
+    auto get_num_bytes() const -> uint64_t
+    {
+        std::lock_guard lock{m_mutex};
+        return m_num_bytes;
+    }
+
+    auto get_num_lines() const -> uint64_t
+    {
+        std::lock_guard lock{m_mutex};
+        return m_num_lines;
+    }
+};
+
+static auto device_kind_to_string(DeviceKind device_kind) -> const char*
+{
+    switch (device_kind)
+    {
+    case DeviceKind::Null:
+        return "null";
+    case DeviceKind::Memory:
+        return "memory";
+    case DeviceKind::File:
+        return "file";
+    case DeviceKind::BufferedFile:
+        return "buffered";
+    }
+
+    return "unknown";
+}
+
+static auto mode_to_string(Mode mode) -> const char*
+{
+    switch (mode)
+    {
+    case Mode::Sync:
+        return "sync";
+    case Mode::Async:
+        return "async";
+    }
+
+    return "unknown";
+}
+
+static auto split(std::string_view list) -> std::vector<std::string_view>
+{
+    std::vector<std::string_view> parts{};
+    while (!list.empty())
+    {
+        const auto comma = list.find(',');
+        parts.emplace_back(list.substr(0, comma));
+        if (comma == std::string_view::npos)
+        {
+            break;
+        }
+        list.remove_prefix(comma + 1);
+    }
+    return parts;
+}
+
+static auto parse_options(int argc, char* argv[]) -> Options
+{
+    Options options{};
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg{argv[i]};
+        const auto equals = arg.find('=');
+        const auto name = arg.substr(0, equals);
+        const auto value = equals == std::string_view::npos ? std::string_view{} : arg.substr(equals + 1);
+
+        if (name == "--threads")
+        {
+            options.thread_counts.clear();
+            for (const auto part : split(value))
+            {
+                options.thread_counts.emplace_back(std::max(1u, static_cast<uint32_t>(std::stoul(std::string{part}))));
+            }
+        }
+        else if (name == "--devices")
+        {
+            options.device_kinds.clear();
+            for (const auto part : split(value))
+            {
+                if (part == "null") options.device_kinds.emplace_back(DeviceKind::Null);
+                else if (part == "memory") options.device_kinds.emplace_back(DeviceKind::Memory);
+                else if (part == "file") options.device_kinds.emplace_back(DeviceKind::File);
+                else if (part == "buffered") options.device_kinds.emplace_back(DeviceKind::BufferedFile);
+                else
+                {
+                    std::fprintf(stderr, "Unknown device: %.*s\n", static_cast<int>(part.size()), part.data());
+                    std::exit(2);
+                }
+            }
+        }
+        else if (name == "--modes")
+        {
+            options.modes.clear();
+            for (const auto part : split(value))
+            {
+                if (part == "sync") options.modes.emplace_back(Mode::Sync);
+                else if (part == "async") options.modes.emplace_back(Mode::Async);
+                else
+                {
+                    std::fprintf(stderr, "Unknown mode: %.*s\n", static_cast<int>(part.size()), part.data());
+                    std::exit(2);
+                }
+            }
+        }
+        else if (name == "--messages")
+        {
+            options.num_messages = std::max<size_t>(1, std::stoull(std::string{value}));
+        }
+        else if (name == "--dir")
+        {
+            options.directory = std::filesystem::path{value};
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            std::exit(2);
+        }
+    }
+
+    return options;
+}
+
+// A few messages in the shape of what's commonly logged, the log levels are picked so that every default device outputs them
+static auto send_message(size_t thread_index, size_t message_index) -> void
+{
+    static constexpr File::StringViewType mod_names[] = {STR("ConsoleCommandsMod"), STR("BPModLoaderMod"), STR("CheatManagerEnablerMod"), STR("Keybinds")};
+    static constexpr File::StringViewType object_names[] = {
+            STR("/Script/Engine.Actor:ReceiveBeginPlay"),
+            STR("/Game/Blueprints/BP_PlayerCharacter.BP_PlayerCharacter_C"),
+            STR("/Script/CoreUObject.Object"),
+            STR("/Game/Maps/MainMenu.MainMenu:PersistentLevel"),
+    };
+
+    const auto name_index = (thread_index + message_index) % 4;
+    switch (message_index % 5)
+    {
+    case 0:
+        Output::send<LogLevel::Normal>(STR("[{}] Loaded {} in {} ms\n"), mod_names[name_index], object_names[name_index], message_index % 97);
+        break;
+    case 1:
+        Output::send<LogLevel::Verbose>(STR("Found {} at 0x{:016X}\n"), object_names[name_index], 0x7FF600000000ull + message_index * 16);
+        break;
+    case 2:
+        Output::send<LogLevel::Default>(STR("[PS] Scan finished in {:.2f} ms, {} of {} signatures found\n"), message_index * 0.125, message_index % 32, 32);
+        break;
+    case 3:
+        Output::send<LogLevel::Warning>(STR("[{}] Thread {} couldn't find '{}', using the fallback\n"), mod_names[name_index], thread_index, object_names[name_index]);
+        break;
+    case 4:
+        Output::send<LogLevel::Default>(STR("Hooked UEngine::Tick\n"));
+        break;
+    }
+}
+
+struct RunResult
+{
+    double messages_per_second{};
+    uint64_t p50_ns{};
+    uint64_t p99_ns{};
+    uint64_t p999_ns{};
+    uint64_t num_bytes{};
+
+    // Empty if the device doesn't keep what it receives
+    std::optional<uint64_t> num_lines{};
+};
+
+static auto count_lines_in_file(const std::filesystem::path& file_path) -> uint64_t
+{
+    std::ifstream file{file_path, std::ios::binary};
+    uint64_t num_lines{};
+    std::vector<char> buffer(1024 * 1024);
+    while (file)
+    {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        num_lines += std::count(buffer.data(), buffer.data() + file.gcount(), '\n');
+    }
+    return num_lines;
+}
+
+static auto get_percentile(std::vector<uint32_t>& latencies, double percentile) -> uint64_t
+{
+    if (latencies.empty())
+    {
+        return 0;
+    }
+    const auto index = std::min(latencies.size() - 1, static_cast<size_t>(static_cast<double>(latencies.size()) * percentile));
+    std::nth_element(latencies.begin(), latencies.begin() + static_cast<ptrdiff_t>(index), latencies.end());
+    return latencies[index];
+}
+
+static auto run(const Options& options, DeviceKind device_kind, Mode mode, uint32_t num_threads) -> RunResult
+{
+    const auto file_path = options.directory / "DynamicOutputBenchmark.log";
+    std::error_code ec{};
+    std::filesystem::remove(file_path, ec);
+
+    const MemoryDevice* memory_device{};
+    switch (device_kind)
+    {
+    case DeviceKind::Null:
+        Output::set_default_devices<NullDevice>();
+        break;
+    case DeviceKind::Memory:
+        memory_device = &Output::set_default_devices<MemoryDevice>();
+        break;
+    case DeviceKind::File:
+        Output::set_default_devices<Output::FileDevice>().set_file_name_and_path(file_path.wstring());
+        break;
+    case DeviceKind::BufferedFile:
+        Output::set_default_devices<Output::BufferedFileDevice>().set_file_name_and_path(file_path.wstring());
+        break;
+    }
+
+    if (mode == Mode::Async)
+    {
+        Output::enable_async_output();
+    }
+
+    // Devices open their files on the first message, which is done here so that it isn't raced by the threads or counted as a call
+    Output::send<LogLevel::Default>(STR("DynamicOutputBenchmark run started\n"));
+
+    const auto messages_per_thread = std::max<size_t>(1, options.num_messages / num_threads);
+    std::vector<std::vector<uint32_t>> latencies_per_thread(num_threads);
+    std::latch start_latch{static_cast<ptrdiff_t>(num_threads) + 1};
+    std::vector<std::thread> threads{};
+    for (uint32_t thread_index = 0; thread_index < num_threads; ++thread_index)
+    {
+        threads.emplace_back([&, thread_index] {
+            auto& latencies = latencies_per_thread[thread_index];
+            latencies.reserve(messages_per_thread);
+            start_latch.arrive_and_wait();
+
+            for (size_t message_index = 0; message_index < messages_per_thread; ++message_index)
+            {
+                const auto call_start = std::chrono::steady_clock::now();
+                send_message(thread_index, message_index);
+                const auto call_end = std::chrono::steady_clock::now();
+                const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(call_end - call_start).count();
+                latencies.emplace_back(static_cast<uint32_t>(std::min<int64_t>(nanoseconds, UINT32_MAX)));
+            }
+        });
+    }
+
+    start_latch.arrive_and_wait();
+    const auto start = std::chrono::steady_clock::now();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // The run isn't over until everything that was sent has reached the device
+    Output::flush();
+    const auto end = std::chrono::steady_clock::now();
+
+    RunResult result{};
+    const auto num_sent = messages_per_thread * num_threads;
+    result.messages_per_second = static_cast<double>(num_sent) / std::chrono::duration<double>(end - start).count();
+
+    std::vector<uint32_t> latencies{};
+    latencies.reserve(num_sent);
+    for (const auto& thread_latencies : latencies_per_thread)
+    {
+        latencies.insert(latencies.end(), thread_latencies.begin(), thread_latencies.end());
+    }
+    result.p50_ns = get_percentile(latencies, 0.50);
+    result.p99_ns = get_percentile(latencies, 0.99);
+    result.p999_ns = get_percentile(latencies, 0.999);
+
+    if (memory_device)
+    {
+        result.num_bytes = memory_device->get_num_bytes();
+        result.num_lines = memory_device->get_num_lines();
+    }
+
+    // Closes the files so that their sizes are final
+    Output::close_all_default_devices();
+
+    if (device_kind == DeviceKind::File || device_kind == DeviceKind::BufferedFile)
+    {
+        result.num_bytes = std::filesystem::file_size(file_path, ec);
+        result.num_lines = count_lines_in_file(file_path);
+        std::filesystem::remove(file_path, ec);
+    }
+
+    return result;
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    const auto options = parse_options(argc, argv);
+
+    std::printf("Messages per run: %zu, files are written to: %s\n\n", options.num_messages, options.directory.string().c_str());
+    std::printf("%-10s %-6s %8s %14s %10s %10s %10s %14s %8s\n", "Device", "Mode", "Threads", "Messages/s", "p50 (ns)", "p99 (ns)", "p999 (ns)", "Bytes", "Check");
+
+    bool all_passed{true};
+    for (const auto device_kind : options.device_kinds)
+    {
+        for (const auto mode : options.modes)
+        {
+            for (const auto num_threads : options.thread_counts)
+            {
+                const auto result = run(options, device_kind, mode, num_threads);
+
+                // Every message is a single line, plus the line that starts the run
+                // Async output blocks instead of dropping messages by default, so nothing may be missing
+                const auto num_sent = std::max<size_t>(1, options.num_messages / num_threads) * num_threads + 1;
+                const char* check = "-";
+                if (result.num_lines)
+                {
+                    const bool passed = *result.num_lines == num_sent;
+                    all_passed = all_passed && passed;
+                    check = passed ? "OK" : "FAIL";
+                    if (!passed)
+                    {
+                        std::fprintf(stderr,
+                                     "  %s %s with %u threads: %zu messages were sent but %llu lines were output\n",
+                                     device_kind_to_string(device_kind),
+                                     mode_to_string(mode),
+                                     num_threads,
+                                     num_sent,
+                                     static_cast<unsigned long long>(*result.num_lines));
+                    }
+                }
+
+                std::printf("%-10s %-6s %8u %14.0f %10llu %10llu %10llu %14llu %8s\n",
+                            device_kind_to_string(device_kind),
+                            mode_to_string(mode),
+                            num_threads,
+                            result.messages_per_second,
+                            static_cast<unsigned long long>(result.p50_ns),
+                            static_cast<unsigned long long>(result.p99_ns),
+                            static_cast<unsigned long long>(result.p999_ns),
+                            static_cast<unsigned long long>(result.num_bytes),
+                            check);
+                std::fflush(stdout);
+            }
+        }
+    }
+
+    return all_passed ? 0 : 1;
+}
@@ -0,0 +1,923 @@
+// Turns a binary log written by 'Output::BinaryLog' back into the text that 'Output::send' would've produced
+// The format strings are stored in the log itself, so this doesn't need the game or the UE4SS build that wrote it
+//
+// Usage: binlogdecode <binary-log> [--output=<text-file>] [--no-timestamps] [--log-level-mask=N]
+// Log levels are bit indices, '--log-level-mask' only keeps messages whose level bit is set, e.g. 0x4 for just Verbose (1 << 2)
+// A log that ends in the middle of a record, which happens if the game crashed before the log was flushed, is decoded up to that record
+// The process exits with 2 if the input was invalid
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <DynamicOutput/BinaryLogFormat.hpp>
+
+using namespace RC::Output::BinaryLog;
+
+struct Options
+{
+    std::filesystem::path input_file{};
+    std::filesystem::path output_file{};
+    bool timestamps{true};
+    std::optional<uint32_t> log_level_mask{};
+};
+
+struct DecodedCallSite
+{
+    std::string fmt{};
+    int32_t log_level{};
+    std::vector<ArgType> arg_types{};
+};
+
+struct DecodedArg
+{
+    ArgType type{};
+    int64_t signed_value{};
+    uint64_t unsigned_value{};
+    double float_value{};
+    std::string string_value{};
+};
+
+class TruncatedLogError : public std::runtime_error
+{
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+class Reader
+{
+  private:
+    const std::vector<uint8_t>& m_data;
+    size_t m_offset{};
+
+  public:
+    explicit Reader(const std::vector<uint8_t>& data) : m_data(data)
+    {
+    }
+
+  public:
+    auto get_offset() const -> size_t
+    {
+        return m_offset;
+    }
+
+    auto is_at_end() const -> bool
+    {
+        return m_offset == m_data.size();
+    }
+
+    auto read_bytes(size_t size) -> const uint8_t*
+    {
+        if (m_data.size() - m_offset < size)
+        {
+            throw TruncatedLogError{"the log ends in the middle of a record"};
+        }
+        const auto bytes = m_data.data() + m_offset;
+        m_offset += size;
+        return bytes;
+    }
+
+    template <typename T>
+    auto read() -> T
+    {
+        T value{};
+        std::memcpy(&value, read_bytes(sizeof(T)), sizeof(T));
+        return value;
+    }
+};
+
+[[noreturn]] static auto exit_with_usage(const char* error) -> void
+{
+    std::fprintf(stderr, "%s\n", error);
+    std::fprintf(stderr, "Usage: binlogdecode <binary-log> [--output=<text-file>] [--no-timestamps] [--log-level-mask=N]\n");
+    std::exit(2);
+}
+
+static auto parse_options(int argc, char* argv[]) -> Options
+{
+    Options options{};
+    std::vector<std::string_view> positional_args{};
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg{argv[i]};
+        if (!arg.starts_with("--"))
+        {
+            positional_args.emplace_back(arg);
+            continue;
+        }
+
+        const auto equals = arg.find('=');
+        const auto name = arg.substr(0, equals);
+        const auto value = equals == std::string_view::npos ? std::string_view{} : arg.substr(equals + 1);
+
+        if (name == "--output")
+        {
+            options.output_file = value;
+        }
+        else if (name == "--no-timestamps")
+        {
+            options.timestamps = false;
+        }
+        else if (name == "--log-level-mask")
+        {
+            // Accepts decimal and 0x prefixed hex
+            try
+            {
+                size_t num_parsed{};
+                const auto mask = std::stoull(std::string{value}, &num_parsed, 0);
+                if (num_parsed != value.size() || mask > 0xFFFFFFFF)
+                {
+                    exit_with_usage("Invalid log level mask");
+                }
+                options.log_level_mask = static_cast<uint32_t>(mask);
+            }
+            catch (const std::exception&)
+            {
+                exit_with_usage("Invalid log level mask");
+            }
+        }
+        else
+        {
+            exit_with_usage("Unknown option");
+        }
+    }
+
+    if (positional_args.size() != 1)
+    {
+        exit_with_usage("Expected a binary log");
+    }
+    options.input_file = positional_args[0];
+
+    return options;
+}
+
+static auto append_utf8(std::string& out, uint32_t code_point) -> void
+{
+    if (code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF))
+    {
+        code_point = 0xFFFD;
+    }
+
+    if (code_point < 0x80)
+    {
+        out += static_cast<char>(code_point);
+    }
+    else if (code_point < 0x800)
+    {
+        out += static_cast<char>(0xC0 | (code_point >> 6));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else if (code_point < 0x10000)
+    {
+        out += static_cast<char>(0xE0 | (code_point >> 12));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else
+    {
+        out += static_cast<char>(0xF0 | (code_point >> 18));
+        out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+}
+
+// Wide characters are UTF-16 when the log was written on Windows and UTF-32 everywhere else
+static auto read_wide_string(Reader& reader, uint32_t length, uint32_t wide_char_size) -> std::string
+{
+    const auto bytes = reader.read_bytes(static_cast<size_t>(length) * wide_char_size);
+    std::string out{};
+    out.reserve(length);
+
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        if (wide_char_size == 4)
+        {
+            uint32_t code_point{};
+            std::memcpy(&code_point, bytes + i * 4, 4);
+            append_utf8(out, code_point);
+            continue;
+        }
+
+        uint16_t unit{};
+        std::memcpy(&unit, bytes + i * 2, 2);
+        if (unit >= 0xD800 && unit <= 0xDBFF && i + 1 < length)
+        {
+            uint16_t low_unit{};
+            std::memcpy(&low_unit, bytes + (i + 1) * 2, 2);
+            if (low_unit >= 0xDC00 && low_unit <= 0xDFFF)
+            {
+                append_utf8(out, 0x10000 + ((unit - 0xD800) << 10) + (low_unit - 0xDC00));
+                ++i;
+                continue;
+            }
+        }
+        append_utf8(out, unit);
+    }
+
+    return out;
+}
+
+static auto read_string(Reader& reader, uint32_t char_size) -> std::string
+{
+    const auto length = reader.read<uint32_t>();
+    if (char_size == 1)
+    {
+        const auto bytes = reader.read_bytes(length);
+        return {reinterpret_cast<const char*>(bytes), length};
+    }
+    return read_wide_string(reader, length, char_size);
+}
+
+static auto read_arg(Reader& reader, ArgType type, uint32_t wide_char_size) -> DecodedArg
+{
+    DecodedArg arg{type};
+    switch (type)
+    {
+    case ArgType::Bool:
+        arg.unsigned_value = reader.read<uint8_t>() != 0;
+        break;
+    case ArgType::Char:
+        arg.unsigned_value = reader.read<uint8_t>();
+        break;
+    case ArgType::WideChar:
+        arg.unsigned_value = wide_char_size == 4 ? reader.read<uint32_t>() : reader.read<uint16_t>();
+        break;
+    case ArgType::Int8:
+        arg.signed_value = reader.read<int8_t>();
+        break;
+    case ArgType::Int16:
+        arg.signed_value = reader.read<int16_t>();
+        break;
+    case ArgType::Int32:
+        arg.signed_value = reader.read<int32_t>();
+        break;
+    case ArgType::Int64:
+        arg.signed_value = reader.read<int64_t>();
+        break;
+    case ArgType::UInt8:
+        arg.unsigned_value = reader.read<uint8_t>();
+        break;
+    case ArgType::UInt16:
+        arg.unsigned_value = reader.read<uint16_t>();
+        break;
+    case ArgType::UInt32:
+        arg.unsigned_value = reader.read<uint32_t>();
+        break;
+    case ArgType::UInt64:
+    case ArgType::Pointer:
+        arg.unsigned_value = reader.read<uint64_t>();
+        break;
+    case ArgType::Float:
+        arg.float_value = reader.read<float>();
+        break;
+    case ArgType::Double:
+        arg.float_value = reader.read<double>();
+        break;
+    case ArgType::String:
+        arg.string_value = read_string(reader, 1);
+        break;
+    case ArgType::WideString:
+        arg.string_value = read_string(reader, wide_char_size);
+        break;
+    default:
+        throw std::runtime_error{"unknown argument type"};
+    }
+    return arg;
+}
+
+namespace Format
+{
+    // Everything that std::format accepts after the ':' in a replacement field, except for locale specific formatting
+    struct Spec
+    {
+        std::string fill{" "};
+        char align{};
+        char sign{'-'};
+        bool alternate{};
+        bool zero_pad{};
+        size_t width{};
+        std::optional<size_t> precision{};
+        char type{};
+    };
+
+    static auto utf8_char_size(char first) -> size_t
+    {
+        const auto byte = static_cast<uint8_t>(first);
+        if (byte >= 0xF0) return 4;
+        if (byte >= 0xE0) return 3;
+        if (byte >= 0xC0) return 2;
+        return 1;
+    }
+
+    static auto count_code_points(std::string_view text) -> size_t
+    {
+        size_t count{};
+        for (const auto c : text)
+        {
+            count += (static_cast<uint8_t>(c) & 0xC0) != 0x80;
+        }
+        return count;
+    }
+
+    static auto pad(std::string_view text, const Spec& spec, char default_align) -> std::string
+    {
+        const size_t length = count_code_points(text);
+        if (length >= spec.width)
+        {
+            return std::string{text};
+        }
+
+        const size_t padding = spec.width - length;
+        const char align = spec.align ? spec.align : default_align;
+        const size_t before = align == '<' ? 0 : align == '^' ? padding / 2 : padding;
+
+        std::string out{};
+        for (size_t i = 0; i < before; ++i)
+        {
+            out += spec.fill;
+        }
+        out += text;
+        for (size_t i = before; i < padding; ++i)
+        {
+            out += spec.fill;
+        }
+        return out;
+    }
+
+    // Numbers are split into a sign and prefix, which zero padding goes after, and the digits
+    static auto pad_number(std::string_view sign_and_prefix, std::string_view digits, const Spec& spec) -> std::string
+    {
+        if (spec.zero_pad && !spec.align)
+        {
+            const size_t length = sign_and_prefix.size() + digits.size();
+            std::string out{sign_and_prefix};
+            if (length < spec.width)
+            {
+                out.append(spec.width - length, '0');
+            }
+            out += digits;
+            return out;
+        }
+
+        std::string text{sign_and_prefix};
+        text += digits;
+        return pad(text, spec, '>');
+    }
+
+    static auto get_sign(bool is_negative, const Spec& spec) -> std::string_view
+    {
+        if (is_negative) return "-";
+        if (spec.sign == '+') return "+";
+        if (spec.sign == ' ') return " ";
+        return "";
+    }
+
+    static auto format_integer(bool is_negative, uint64_t magnitude, const Spec& spec) -> std::string
+    {
+        if (spec.type == 'c')
+        {
+            std::string text{};
+            append_utf8(text, static_cast<uint32_t>(magnitude));
+            return pad(text, spec, '<');
+        }
+
+        int base = 10;
+        std::string_view prefix{};
+        switch (spec.type)
+        {
+        case 'b':
+            base = 2;
+            prefix = "0b";
+            break;
+        case 'B':
+            base = 2;
+            prefix = "0B";
+            break;
+        case 'o':
+            base = 8;
+            prefix = magnitude != 0 ? "0" : "";
+            break;
+        case 'x':
+            base = 16;
+            prefix = "0x";
+            break;
+        case 'X':
+            base = 16;
+            prefix = "0X";
+            break;
+        default:
+            break;
+        }
+
+        char buffer[64]{};
+        const auto result = std::to_chars(std::begin(buffer), std::end(buffer), magnitude, base);
+        std::string digits{buffer, result.ptr};
+        if (spec.type == 'X')
+        {
+            for (auto& c : digits)
+            {
+                c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            }
+        }
+
+        std::string sign_and_prefix{get_sign(is_negative, spec)};
+        if (spec.alternate)
+        {
+            sign_and_prefix += prefix;
+        }
+        return pad_number(sign_and_prefix, digits, spec);
+    }
+
+    static auto format_float(double value, const Spec& spec) -> std::string
+    {
+        const bool is_negative = std::signbit(value);
+        const double magnitude = is_negative ? -value : value;
+
+        char buffer[512]{};
+        std::to_chars_result result{};
+        const char type = static_cast<char>(std::tolower(static_cast<unsigned char>(spec.type)));
+        if (type == 'f')
+        {
+            result = std::to_chars(std::begin(buffer), std::end(buffer), magnitude, std::chars_format::fixed, static_cast<int>(spec.precision.value_or(6)));
+        }
+        else if (type == 'e')
+        {
+            result = std::to_chars(std::begin(buffer), std::end(buffer), magnitude, std::chars_format::scientific, static_cast<int>(spec.precision.value_or(6)));
+        }
+        else if (type == 'g')
+        {
+            result = std::to_chars(std::begin(buffer), std::end(buffer), magnitude, std::chars_format::general, static_cast<int>(spec.precision.value_or(6)));
+        }
+        else if (type == 'a')
+        {
+            result = spec.precision ? std::to_chars(std::begin(buffer), std::end(buffer), magnitude, std::chars_format::hex, static_cast<int>(*spec.precision))
+                                    : std::to_chars(std::begin(buffer), std::end(buffer), magnitude, std::chars_format::hex);
+        }
+        else if (spec.precision)
+        {
+            result = std::to_chars(std::begin(buffer), std::end(buffer), magnitude, std::chars_format::general, static_cast<int>(*spec.precision));
+        }
+        else
+        {
+            result = std::to_chars(std::begin(buffer), std::end(buffer), magnitude);
+        }
+
+        std::string digits{buffer, result.ptr};
+        if (spec.type == 'E' || spec.type == 'F' || spec.type == 'G' || spec.type == 'A')
+        {
+            for (auto& c : digits)
+            {
+                c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            }
+        }
+        if (spec.alternate && digits.find_first_of(".eEnN") == std::string::npos)
+        {
+            digits += '.';
+        }
+
+        return pad_number(get_sign(is_negative, spec), digits, spec);
+    }
+
+    static auto format_arg(const DecodedArg& arg, const Spec& spec) -> std::string
+    {
+        const bool is_presented_as_integer = spec.type != 0 && spec.type != 's' && spec.type != 'c';
+
+        switch (arg.type)
+        {
+        case ArgType::Bool:
+            if (is_presented_as_integer)
+            {
+                return format_integer(false, arg.unsigned_value, spec);
+            }
+            return pad(arg.unsigned_value ? "true" : "false", spec, '<');
+        case ArgType::Char:
+        case ArgType::WideChar:
+            if (is_presented_as_integer)
+            {
+                return format_integer(false, arg.unsigned_value, spec);
+            }
+            {
+                Spec char_spec = spec;
+                char_spec.type = 'c';
+                return format_integer(false, arg.unsigned_value, char_spec);
+            }
+        case ArgType::Int8:
+        case ArgType::Int16:
+        case ArgType::Int32:
+        case ArgType::Int64:
+            return format_integer(arg.signed_value < 0, arg.signed_value < 0 ? 0 - static_cast<uint64_t>(arg.signed_value) : arg.signed_value, spec);
+        case ArgType::UInt8:
+        case ArgType::UInt16:
+        case ArgType::UInt32:
+        case ArgType::UInt64:
+            return format_integer(false, arg.unsigned_value, spec);
+        case ArgType::Float:
+        case ArgType::Double:
+            return format_float(arg.float_value, spec);
+        case ArgType::Pointer: {
+            Spec pointer_spec = spec;
+            pointer_spec.type = spec.type == 'P' ? 'X' : 'x';
+            pointer_spec.alternate = true;
+            return format_integer(false, arg.unsigned_value, pointer_spec);
+        }
+        case ArgType::String:
+        case ArgType::WideString: {
+            std::string_view text{arg.string_value};
+            if (spec.precision)
+            {
+                // The precision is the number of characters to keep, not bytes
+                size_t offset{};
+                for (size_t i = 0; i < *spec.precision && offset < text.size(); ++i)
+                {
+                    offset += utf8_char_size(text[offset]);
+                }
+                text = text.substr(0, std::min(offset, text.size()));
+            }
+            return pad(text, spec, '<');
+        }
+        }
+        return {};
+    }
+
+    class Formatter
+    {
+      private:
+        std::string_view m_fmt;
+        const std::vector<DecodedArg>& m_args;
+        size_t m_next_arg_index{};
+
+      public:
+        Formatter(std::string_view fmt, const std::vector<DecodedArg>& args) : m_fmt(fmt), m_args(args)
+        {
+        }
+
+      public:
+        auto format() -> std::string
+        {
+            std::string out{};
+            size_t i{};
+            while (i < m_fmt.size())
+            {
+                const char c = m_fmt[i];
+                if (c == '}')
+                {
+                    if (i + 1 < m_fmt.size() && m_fmt[i + 1] == '}')
+                    {
+                        out += '}';
+                        i += 2;
+                        continue;
+                    }
+                    throw std::runtime_error{"unmatched '}' in the format string"};
+                }
+                if (c != '{')
+                {
+                    out += c;
+                    ++i;
+                    continue;
+                }
+                if (i + 1 < m_fmt.size() && m_fmt[i + 1] == '{')
+                {
+                    out += '{';
+                    i += 2;
+                    continue;
+                }
+
+                const auto end = find_field_end(i);
+                out += format_field(m_fmt.substr(i + 1, end - i - 1));
+                i = end + 1;
+            }
+            return out;
+        }
+
+      private:
+        // Nested fields are only allowed for the width and the precision, so they don't contain any fields themselves
+        auto find_field_end(size_t start) const -> size_t
+        {
+            size_t depth{};
+            for (size_t i = start; i < m_fmt.size(); ++i)
+            {
+                if (m_fmt[i] == '{')
+                {
+                    ++depth;
+                }
+                else if (m_fmt[i] == '}' && --depth == 0)
+                {
+                    return i;
+                }
+            }
+            throw std::runtime_error{"unterminated replacement field in the format string"};
+        }
+
+        auto get_arg(std::string_view arg_id) -> const DecodedArg&
+        {
+            size_t index = m_next_arg_index;
+            if (arg_id.empty())
+            {
+                ++m_next_arg_index;
+            }
+            else if (std::from_chars(arg_id.data(), arg_id.data() + arg_id.size(), index).ec != std::errc{})
+            {
+                throw std::runtime_error{"named arguments aren't supported"};
+            }
+
+            if (index >= m_args.size())
+            {
+                throw std::runtime_error{"the format string refers to an argument that wasn't logged"};
+            }
+            return m_args[index];
+        }
+
+        // Parses a width or a precision, which is either a number or a nested replacement field with an integer argument
+        auto parse_count(std::string_view spec, size_t& i) -> size_t
+        {
+            if (spec[i] == '{')
+            {
+                const auto end = spec.find('}', i);
+                const auto& arg = get_arg(spec.substr(i + 1, end - i - 1));
+                i = end + 1;
+                if (arg.type >= ArgType::Int8 && arg.type <= ArgType::Int64)
+                {
+                    if (arg.signed_value < 0) throw std::runtime_error{"negative width or precision"};
+                    return static_cast<size_t>(arg.signed_value);
+                }
+                if (arg.type >= ArgType::UInt8 && arg.type <= ArgType::UInt64)
+                {
+                    return static_cast<size_t>(arg.unsigned_value);
+                }
+                throw std::runtime_error{"the width or precision argument isn't an integer"};
+            }
+
+            size_t count{};
+            const auto result = std::from_chars(spec.data() + i, spec.data() + spec.size(), count);
+            i = result.ptr - spec.data();
+            return count;
+        }
+
+        auto format_field(std::string_view field) -> std::string
+        {
+            const auto colon = field.find(':');
+            const auto& arg = get_arg(field.substr(0, colon));
+            if (colon == std::string_view::npos)
+            {
+                return format_arg(arg, {});
+            }
+
+            const auto spec_text = field.substr(colon + 1);
+            Spec spec{};
+            size_t i{};
+
+            const auto is_align = [](char c) {
+                return c == '<' || c == '>' || c == '^';
+            };
+            if (!spec_text.empty())
+            {
+                const auto fill_size = utf8_char_size(spec_text[0]);
+                if (fill_size < spec_text.size() && is_align(spec_text[fill_size]) && spec_text[0] != '{' && spec_text[0] != '}')
+                {
+                    spec.fill = spec_text.substr(0, fill_size);
+                    spec.align = spec_text[fill_size];
+                    i = fill_size + 1;
+                }
+                else if (is_align(spec_text[0]))
+                {
+                    spec.align = spec_text[0];
+                    i = 1;
+                }
+            }
+            if (i < spec_text.size() && (spec_text[i] == '+' || spec_text[i] == '-' || spec_text[i] == ' '))
+            {
+                spec.sign = spec_text[i++];
+            }
+            if (i < spec_text.size() && spec_text[i] == '#')
+            {
+                spec.alternate = true;
+                ++i;
+            }
+            if (i < spec_text.size() && spec_text[i] == '0')
+            {
+                spec.zero_pad = true;
+                ++i;
+            }
+            if (i < spec_text.size() && (std::isdigit(static_cast<unsigned char>(spec_text[i])) || spec_text[i] == '{'))
+            {
+                spec.width = parse_count(spec_text, i);
+            }
+            if (i < spec_text.size() && spec_text[i] == '.')
+            {
+                ++i;
+                spec.precision = i < spec_text.size() ? parse_count(spec_text, i) : 0;
+            }
+            if (i < spec_text.size() && spec_text[i] == 'L')
+            {
+                ++i;
+            }
+            if (i < spec_text.size())
+            {
+                spec.type = spec_text[i++];
+            }
+            if (i != spec_text.size())
+            {
+                throw std::runtime_error{"invalid format spec"};
+            }
+
+            return format_arg(arg, spec);
+        }
+    };
+} // namespace Format
+
+static auto format_timestamp(int64_t nanoseconds) -> std::string
+{
+    const auto seconds = static_cast<std::time_t>(nanoseconds / 1'000'000'000);
+    const auto milliseconds = (nanoseconds / 1'000'000) % 1000;
+
+    std::tm time{};
+#ifdef _WIN32
+    localtime_s(&time, &seconds);
+#else
+    localtime_r(&seconds, &time);
+#endif
+
+    char buffer[64]{};
+    const auto length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &time);
+    return std::string{buffer, length} + "." + std::to_string(1000 + milliseconds).substr(1);
+}
+
+static auto read_file(const std::filesystem::path& path) -> std::vector<uint8_t>
+{
+    std::ifstream file{path, std::ios::binary | std::ios::ate};
+    if (!file)
+    {
+        throw std::runtime_error{"could not open '" + path.string() + "'"};
+    }
+    const auto size = static_cast<size_t>(file.tellg());
+    std::vector<uint8_t> data(size);
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(size));
+    return data;
+}
+
+int main(int argc, char* argv[])
+{
+    const auto options = parse_options(argc, argv);
+
+    std::vector<uint8_t> data{};
+    try
+    {
+        data = read_file(options.input_file);
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        return 2;
+    }
+
+    std::FILE* out = stdout;
+    if (!options.output_file.empty())
+    {
+        out = std::fopen(options.output_file.string().c_str(), "wb");
+        if (!out)
+        {
+            std::fprintf(stderr, "Error: could not open '%s'\n", options.output_file.string().c_str());
+            return 2;
+        }
+    }
+
+    Reader reader{data};
+    size_t record_offset{};
+    size_t num_messages{};
+    size_t num_invalid_messages{};
+    try
+    {
+        if (data.size() < sizeof(FileMagic) + sizeof(uint32_t) * 3 || std::memcmp(reader.read_bytes(sizeof(FileMagic)), FileMagic, sizeof(FileMagic)) != 0)
+        {
+            throw std::runtime_error{"not a binary log"};
+        }
+        if (const auto version = reader.read<uint32_t>(); version != FileVersion)
+        {
+            throw std::runtime_error{"unsupported binary log version " + std::to_string(version)};
+        }
+        const auto char_size = reader.read<uint32_t>();
+        if (char_size != 1 && char_size != 2 && char_size != 4)
+        {
+            throw std::runtime_error{"invalid character size " + std::to_string(char_size)};
+        }
+        const auto wide_char_size = reader.read<uint32_t>();
+        if (wide_char_size != 2 && wide_char_size != 4)
+        {
+            throw std::runtime_error{"invalid wide character size " + std::to_string(wide_char_size)};
+        }
+
+        std::unordered_map<uint32_t, DecodedCallSite> call_sites{};
+        std::vector<DecodedArg> args{};
+        while (!reader.is_at_end())
+        {
+            record_offset = reader.get_offset();
+            const auto record_type = reader.read<RecordType>();
+
+            if (record_type == RecordType::CallSite)
+            {
+                const auto id = reader.read<uint32_t>();
+                auto& call_site = call_sites[id];
+                call_site.log_level = reader.read<int32_t>();
+                const auto num_args = reader.read<uint8_t>();
+                call_site.arg_types.resize(num_args);
+                for (auto& arg_type : call_site.arg_types)
+                {
+                    arg_type = reader.read<ArgType>();
+                }
+                call_site.fmt = read_string(reader, char_size);
+                continue;
+            }
+
+            if (record_type != RecordType::Message)
+            {
+                throw std::runtime_error{"unknown record type at offset " + std::to_string(record_offset)};
+            }
+
+            const auto id = reader.read<uint32_t>();
+            const auto timestamp = reader.read<int64_t>();
+            const auto payload_size = reader.read<uint32_t>();
+            const auto payload_start = reader.get_offset();
+            const auto call_site_it = call_sites.find(id);
+            if (call_site_it == call_sites.end())
+            {
+                throw std::runtime_error{"message at offset " + std::to_string(record_offset) + " has no call site"};
+            }
+            const auto& call_site = call_site_it->second;
+
+            args.clear();
+            for (const auto arg_type : call_site.arg_types)
+            {
+                args.emplace_back(read_arg(reader, arg_type, wide_char_size));
+            }
+            if (reader.get_offset() - payload_start != payload_size)
+            {
+                throw std::runtime_error{"the payload of the message at offset " + std::to_string(record_offset) + " doesn't match its call site"};
+            }
+
+            // Same as 'Output::is_log_level_in_mask', levels that don't fit in the mask are never filtered
+            if (options.log_level_mask && call_site.log_level >= 0 && call_site.log_level < 32 &&
+                (*options.log_level_mask & (1u << call_site.log_level)) == 0)
+            {
+                continue;
+            }
+
+            std::string text{};
+            try
+            {
+                text = Format::Formatter{call_site.fmt, args}.format();
+            }
+            catch (const std::exception& e)
+            {
+                // One bad format string shouldn't hide the rest of the log
+                text = "<" + std::string{e.what()} + ": " + call_site.fmt + ">\n";
+                ++num_invalid_messages;
+            }
+
+            if (options.timestamps)
+            {
+                std::fprintf(out, "[%s] ", format_timestamp(timestamp).c_str());
+            }
+            std::fwrite(text.data(), 1, text.size(), out);
+            ++num_messages;
+        }
+    }
+    catch (const TruncatedLogError& e)
+    {
+        std::fprintf(stderr, "Warning: %s, decoded up to offset %zu\n", e.what(), record_offset);
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        if (out != stdout) std::fclose(out);
+        return 2;
+    }
+
+    if (out != stdout)
+    {
+        std::fclose(out);
+    }
+    std::fprintf(stderr, "Decoded %zu messages", num_messages);
+    if (num_invalid_messages > 0)
+    {
+        std::fprintf(stderr, ", %zu of them had a format string that couldn't be applied", num_invalid_messages);
+    }
+    std::fprintf(stderr, "\n");
+    return 0;
+}
@@ -0,0 +1,59 @@
+#ifndef UE4SS_REWRITTEN_ASYNCOUTPUT_HPP
+#define UE4SS_REWRITTEN_ASYNCOUTPUT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <DynamicOutput/Common.hpp>
+#include <File/Macros.hpp>
+
+namespace RC::Output
+{
+    // What 'send' does when the async queue is full
+    enum class FullQueuePolicy
+    {
+        // Waits for the output thread to make room, no message is ever lost
+        Block,
+
+        // Discards the message, the number of discarded messages is logged once there's room again
+        Drop,
+    };
+
+    struct AsyncOutputOptions
+    {
+        // The number of messages that can be waiting to be output, rounded up to a power of two
+        size_t queue_size{8192};
+        FullQueuePolicy full_queue_policy{FullQueuePolicy::Block};
+    };
+
+    // Makes the static 'send' functions hand their messages to a dedicated output thread instead of writing to the default devices on the calling thread
+    // The message is still formatted by the caller, so arguments don't have to outlive the call, but the devices are only ever called by the output thread
+    // Messages from one thread are always output in the order that they were sent in
+    // All default devices must be set before this is called, 'Targets' objects aren't affected and always output on the calling thread
+    RC_DYNOUT_API auto enable_async_output(const AsyncOutputOptions& options = {}) -> void;
+
+    // Outputs every queued message and stops the output thread, 'send' outputs on the calling thread again afterwards
+    // This is also done by 'close_all_default_devices'
+    RC_DYNOUT_API auto disable_async_output() -> void;
+
+    RC_DYNOUT_API auto is_async_output_enabled() -> bool;
+
+    // Blocks until every message that was sent before this call has been output, and then flushes the default devices that buffer their output
+    // This also flushes the devices when async output isn't enabled
+    // Throws if a device couldn't be flushed, such as a BufferedFileDevice that another thread held on to for too long, but only after trying every device
+    RC_DYNOUT_API auto flush() -> void;
+
+    // Meant to be called from a crash handler, where the output thread may never get to run again
+    // Outputs whatever is queued on the calling thread, unless the output thread is stuck in a device for too long, and then flushes the default devices
+    RC_DYNOUT_API auto flush_on_crash() -> void;
+
+    RC_DYNOUT_API auto get_num_dropped_messages() -> uint64_t;
+
+    namespace Internal
+    {
+        // Returns false if async output isn't enabled, the caller should output the message itself in that case
+        RC_DYNOUT_API auto try_send_async(File::StringViewType content, int32_t optional_arg) -> bool;
+    } // namespace Internal
+} // namespace RC::Output
+
+#endif // UE4SS_REWRITTEN_ASYNCOUTPUT_HPP
@@ -0,0 +1,195 @@
+#ifndef UE4SS_REWRITTEN_BINARYLOG_HPP
+#define UE4SS_REWRITTEN_BINARYLOG_HPP
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <DynamicOutput/BinaryLogFormat.hpp>
+#include <DynamicOutput/Common.hpp>
+#include <DynamicOutput/Output.hpp>
+
+// Logs to the binary log instead of the default devices, falls back to 'Output::send' when the binary log isn't open
+// The format string is only stored once per call site, every message is just the call site id and the raw bytes of the arguments
+// OUTPUT_SEND_BINARY(LogLevel::Verbose, STR("Hook {} called with {} params\n"), hook_id, num_params);
+#define OUTPUT_SEND_BINARY(log_level, ...)                                                                                                                     \
+    do                                                                                                                                                         \
+    {                                                                                                                                                          \
+        static ::RC::Output::BinaryLog::CallSite rc_binary_log_call_site{};                                                                                    \
+        ::RC::Output::BinaryLog::send(rc_binary_log_call_site, log_level, __VA_ARGS__);                                                                        \
+    } while (false)
+
+namespace RC::Output::BinaryLog
+{
+    // One per 'OUTPUT_SEND_BINARY', the id is 0 until the call site is first used
+    struct CallSite
+    {
+        std::atomic<uint32_t> id{};
+    };
+
+    // Creates or truncates 'file_path', throws std::runtime_error if it can't be opened
+    // Every call site that's already been used is written to the new file right away
+    RC_DYNOUT_API auto open(const std::filesystem::path& file_path) -> void;
+    RC_DYNOUT_API auto close() -> void;
+    RC_DYNOUT_API auto is_open() -> bool;
+
+    // Messages are buffered and written by a background thread once a buffer is full or a second has passed, this waits until whatever is buffered has been written
+    RC_DYNOUT_API auto flush() -> void;
+
+    // Like 'flush', but writes on the calling thread and gives up instead of waiting if a thread that crashed might be holding the lock
+    RC_DYNOUT_API auto flush_on_crash() -> void;
+
+    namespace Internal
+    {
+        template <typename T>
+        constexpr bool is_narrow_string = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> || std::is_same_v<T, const char*> ||
+                                          std::is_same_v<T, char*>;
+
+        template <typename T>
+        constexpr bool is_wide_string = std::is_same_v<T, std::wstring> || std::is_same_v<T, std::wstring_view> || std::is_same_v<T, const wchar_t*> ||
+                                        std::is_same_v<T, wchar_t*>;
+
+        template <typename T>
+        constexpr auto get_arg_type() -> ArgType
+        {
+            if constexpr (std::is_same_v<T, bool>) return ArgType::Bool;
+            else if constexpr (std::is_same_v<T, char>) return ArgType::Char;
+            else if constexpr (std::is_same_v<T, wchar_t>) return ArgType::WideChar;
+            else if constexpr (is_narrow_string<T>) return ArgType::String;
+            else if constexpr (is_wide_string<T>) return ArgType::WideString;
+            else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>) return ArgType::Pointer;
+            else if constexpr (std::is_floating_point_v<T>) return sizeof(T) == sizeof(float) ? ArgType::Float : ArgType::Double;
+            else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            {
+                if constexpr (sizeof(T) == 1) return ArgType::Int8;
+                else if constexpr (sizeof(T) == 2) return ArgType::Int16;
+                else if constexpr (sizeof(T) == 4) return ArgType::Int32;
+                else return ArgType::Int64;
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                if constexpr (sizeof(T) == 1) return ArgType::UInt8;
+                else if constexpr (sizeof(T) == 2) return ArgType::UInt16;
+                else if constexpr (sizeof(T) == 4) return ArgType::UInt32;
+                else return ArgType::UInt64;
+            }
+            else
+            {
+                static_assert(std::is_void_v<T> && !std::is_void_v<T>, "This type of argument can't be written to the binary log, convert it to a string or a number first.");
+            }
+        }
+
+        // Arrays like string literals are logged as the pointer they decay to
+        template <typename T>
+        using ArgStorageType = std::decay_t<T>;
+
+        template <typename T>
+        auto get_string_view(const T& arg)
+        {
+            if constexpr (std::is_pointer_v<T>)
+            {
+                using CharType = std::remove_cv_t<std::remove_pointer_t<T>>;
+                return arg ? std::basic_string_view<CharType>{arg} : std::basic_string_view<CharType>{};
+            }
+            else
+            {
+                return std::basic_string_view<typename T::value_type>{arg};
+            }
+        }
+
+        template <typename T>
+        auto get_arg_size(const T& arg) -> size_t
+        {
+            if constexpr (is_narrow_string<T> || is_wide_string<T>)
+            {
+                const auto view = get_string_view(arg);
+                return sizeof(uint32_t) + view.size() * sizeof(typename decltype(view)::value_type);
+            }
+            else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>)
+            {
+                return sizeof(uint64_t);
+            }
+            else if constexpr (std::is_floating_point_v<T> && sizeof(T) > sizeof(double))
+            {
+                return sizeof(double);
+            }
+            else
+            {
+                return sizeof(T);
+            }
+        }
+
+        template <typename T>
+        auto write_arg(uint8_t*& out, const T& arg) -> void
+        {
+            if constexpr (is_narrow_string<T> || is_wide_string<T>)
+            {
+                const auto view = get_string_view(arg);
+                const auto size = static_cast<uint32_t>(view.size());
+                std::memcpy(out, &size, sizeof(size));
+                out += sizeof(size);
+                std::memcpy(out, view.data(), view.size() * sizeof(typename decltype(view)::value_type));
+                out += view.size() * sizeof(typename decltype(view)::value_type);
+            }
+            else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>)
+            {
+                const auto value = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(static_cast<const void*>(arg)));
+                std::memcpy(out, &value, sizeof(value));
+                out += sizeof(value);
+            }
+            else if constexpr (std::is_floating_point_v<T> && sizeof(T) > sizeof(double))
+            {
+                const auto value = static_cast<double>(arg);
+                std::memcpy(out, &value, sizeof(value));
+                out += sizeof(value);
+            }
+            else
+            {
+                std::memcpy(out, &arg, sizeof(T));
+                out += sizeof(T);
+            }
+        }
+
+        RC_DYNOUT_API auto register_call_site(CallSite& call_site, File::StringViewType fmt, int32_t log_level, std::span<const ArgType> arg_types) -> uint32_t;
+
+        // The payload is written to a buffer owned by the calling thread first so the log is only locked while it's copied into the shared buffer
+        RC_DYNOUT_API auto get_payload_buffer(size_t payload_size) -> uint8_t*;
+        RC_DYNOUT_API auto write_message(uint32_t call_site_id) -> void;
+    } // namespace Internal
+
+    template <typename... Args>
+    auto send(CallSite& call_site, int32_t log_level, File::StringViewType fmt, const Args&... args) -> void
+    {
+        static_assert(sizeof...(Args) <= MaxArgs);
+
+        if (!is_open())
+        {
+            Output::send(fmt, static_cast<LogLevel::LogLevel>(log_level), args...);
+            return;
+        }
+
+        if (!is_log_level_in_mask(DefaultTargets::get_log_level_mask(), log_level))
+        {
+            return;
+        }
+
+        auto call_site_id = call_site.id.load(std::memory_order_acquire);
+        if (call_site_id == 0)
+        {
+            static constexpr std::array<ArgType, sizeof...(Args)> arg_types{Internal::get_arg_type<Internal::ArgStorageType<Args>>()...};
+            call_site_id = Internal::register_call_site(call_site, fmt, log_level, arg_types);
+        }
+
+        const size_t payload_size = (size_t{0} + ... + Internal::get_arg_size<Internal::ArgStorageType<Args>>(args));
+        [[maybe_unused]] auto out = Internal::get_payload_buffer(payload_size);
+        (Internal::write_arg<Internal::ArgStorageType<Args>>(out, args), ...);
+        Internal::write_message(call_site_id);
+    }
+} // namespace RC::Output::BinaryLog
+
+#endif // UE4SS_REWRITTEN_BINARYLOG_HPP
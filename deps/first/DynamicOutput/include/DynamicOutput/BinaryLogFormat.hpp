@@ -0,0 +1,51 @@
+#ifndef UE4SS_REWRITTEN_BINARYLOGFORMAT_HPP
+#define UE4SS_REWRITTEN_BINARYLOGFORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// The layout of the files that 'BinaryLog' writes, shared with the decoder so it doesn't need anything else from DynamicOutput
+// All integers are little endian and nothing is padded
+//
+// File header: 8 byte magic, u32 version, u32 size of a format string character in bytes, u32 size of a wchar_t in bytes
+// Followed by records that each start with a u8 'RecordType'
+namespace RC::Output::BinaryLog
+{
+    constexpr char FileMagic[8] = {'U', 'E', '4', 'S', 'S', 'B', 'L', 'G'};
+    constexpr uint32_t FileVersion = 1;
+
+    enum class RecordType : uint8_t
+    {
+        // u32 call site id, i32 log level, u8 number of args, u8 'ArgType' per arg, u32 length of the format string in characters, the characters
+        // Always comes before the first message of its call site
+        CallSite = 1,
+
+        // u32 call site id, i64 nanoseconds since the unix epoch, u32 size of the payload in bytes, the payload
+        // The payload is every arg in order, strings are a u32 length in characters followed by the characters and everything else is the raw value
+        Message = 2,
+    };
+
+    enum class ArgType : uint8_t
+    {
+        Bool,
+        Char,
+        WideChar,
+        Int8,
+        Int16,
+        Int32,
+        Int64,
+        UInt8,
+        UInt16,
+        UInt32,
+        UInt64,
+        Float,
+        Double,
+        Pointer,
+        String,
+        WideString,
+    };
+
+    constexpr size_t MaxArgs = 255;
+} // namespace RC::Output::BinaryLog
+
+#endif // UE4SS_REWRITTEN_BINARYLOGFORMAT_HPP
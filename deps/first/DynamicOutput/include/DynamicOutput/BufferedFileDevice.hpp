@@ -0,0 +1,88 @@
+#ifndef UE4SS_REWRITTEN_BUFFEREDFILEDEVICE_HPP
+#define UE4SS_REWRITTEN_BUFFEREDFILEDEVICE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#include <DynamicOutput/Common.hpp>
+#include <DynamicOutput/Macros.hpp>
+#include <DynamicOutput/OutputDevice.hpp>
+#include <File/File.hpp>
+
+namespace RC::Output
+{
+    struct BufferedFileDeviceOptions
+    {
+        // Buffered output is written once there's this many bytes of it
+        size_t flush_size{64 * 1024};
+
+        // Or once the oldest buffered message is this old, which is checked by a timer thread so a message isn't held back until the next one is sent
+        // The async output thread also flushes whenever nothing has been sent for a moment, and messages with the Error log level are written right away
+        std::chrono::milliseconds flush_interval{1000};
+
+        // The file is rotated before it grows past this size, 0 lets it grow forever
+        uint64_t max_file_size{};
+
+        // The number of rotated files that are kept, 'UE4SS.1.log' is the newest one and 'UE4SS.<max_rotated_files>.log' the oldest
+        // 0 just starts the file over when it's full
+        uint32_t max_rotated_files{5};
+    };
+
+    // Note: Like FileDevice, 'Output::send()' must only be called after 'BufferedFileDevice::set_file_name_and_path()' has been called
+
+    // Outputs to a file on a drive, like NewFileDevice, but collects the output in memory and writes it as UTF-8 in large blocks
+    // Behavior defined as:
+    // Delete the file and any rotated files from a previous session, then create the file
+    // Keep it open until ~BufferedFileDevice, which writes whatever is still buffered
+    // Rotate the file once it reaches the size limit
+    // Safe to use from multiple threads, and 'flush' is safe to call from a crash handler
+    // 'flush' throws std::runtime_error if another thread holds on to the buffer for too long, the buffered output is written by the next message or timer tick instead
+    class RC_DYNOUT_API BufferedFileDevice : public OutputDevice
+    {
+      private:
+        using ClockType = std::chrono::steady_clock;
+
+        mutable std::timed_mutex m_mutex{};
+        mutable File::Handle m_file{};
+        std::filesystem::path m_file_name_and_path{};
+        BufferedFileDeviceOptions m_options{};
+
+        mutable File::StringType m_buffer{};
+        mutable size_t m_buffer_size_in_bytes{};
+        mutable uint64_t m_file_size{};
+        mutable ClockType::time_point m_oldest_buffered_time{};
+
+        // Writes the buffer once its oldest message is 'flush_interval' old even if nothing else is sent
+        mutable std::condition_variable_any m_flush_condition{};
+        mutable std::thread m_flush_thread{};
+        mutable bool m_should_stop_flushing{};
+
+      public:
+        ~BufferedFileDevice() override;
+
+      private:
+        auto start_device() const -> void;
+        auto get_rotated_file_path(uint32_t index) const -> std::filesystem::path;
+        auto rotate() const -> void;
+        auto write_buffer() const -> void;
+        auto flush_thread_main() const -> void;
+        auto receive_message(File::StringViewType fmt, bool should_write_now) const -> void;
+
+      public:
+        // OutputDevice Interface -> START
+        auto has_optional_arg() const -> bool override;
+        auto receive(File::StringViewType fmt) const -> void override;
+        auto receive_with_optional_arg(File::StringViewType fmt, int32_t optional_arg = 0) const -> void override;
+        auto flush() const -> void override;
+        // OutputDevice Interface -> END
+
+        auto set_file_name_and_path(const File::StringType& file_name_and_path) -> void;
+        auto set_options(const BufferedFileDeviceOptions& options) -> void;
+    };
+} // namespace RC::Output
+
+#endif // UE4SS_REWRITTEN_BUFFEREDFILEDEVICE_HPP
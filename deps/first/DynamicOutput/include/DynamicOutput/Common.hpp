@@ -1,5 +1,12 @@
 #pragma once
 
+// __declspec only exists on Windows, everything except the console device is also built elsewhere (see benchmark/CMakeLists.txt)
+#ifndef _WIN32
+#ifndef RC_DYNOUT_API
+#define RC_DYNOUT_API
+#endif
+#endif
+
 #ifndef RC_DYNAMIC_OUTPUT_EXPORTS
 #ifndef RC_DYNAMIC_OUTPUT_BUILD_STATIC
 #ifndef RC_DYNOUT_API
@@ -5,6 +5,7 @@
 #include <source_location> // Line numbers etc...
 #include <tuple>
 
+#include <DynamicOutput/BufferedFileDevice.hpp> // File on drive that's written in large blocks and rotated once it gets too big
 #include <DynamicOutput/DebugConsoleDevice.hpp> // stdout
 #include <DynamicOutput/FileDevice.hpp>         // File on drive
 #include <DynamicOutput/Macros.hpp>             // Internal & external utility macros
@@ -16,4 +16,15 @@
                                   "construct a Targets object and supply your own devices.")                                                                   \
     }
 
+// Sends to the default devices like 'Output::send<log_level>(...)', but the arguments aren't even evaluated if no default device outputs 'log_level'
+// OUTPUT_SEND_IF_ENABLED(LogLevel::Verbose, STR("Registered hook for {}\n"), function->GetFullName());
+#define OUTPUT_SEND_IF_ENABLED(log_level, ...)                                                                                                                 \
+    do                                                                                                                                                         \
+    {                                                                                                                                                          \
+        if (::RC::Output::is_log_level_enabled(log_level))                                                                                                     \
+        {                                                                                                                                                      \
+            ::RC::Output::send<log_level>(__VA_ARGS__);                                                                                                        \
+        }                                                                                                                                                      \
+    } while (false)
+
 #endif // DYNAMIC_OUTPUT_MACROS_HPP
@@ -2,6 +2,7 @@
 #define UE4SS_REWRITTEN_OUTPUT_HPP
 
 #include <array>
+#include <atomic>
 #include <format>
 #include <memory>
 #include <source_location>
@@ -11,9 +12,11 @@
 #include <typeinfo>
 #include <vector>
 
+#include <DynamicOutput/AsyncOutput.hpp>
 #include <DynamicOutput/Common.hpp>
 #include <DynamicOutput/Macros.hpp>
 #include <DynamicOutput/OutputDevice.hpp>
+#include <DynamicOutput/OutputFilter.hpp>
 #include <File/InternalFile.hpp>
 
 #if RC_IS_ANSI == 1
@@ -57,6 +60,68 @@ namespace RC::Output
         return *ret;
     }
 
+#if RC_IS_ANSI == 1
+    using FormatArgsType = std::format_args;
+#else
+    using FormatArgsType = std::wformat_args;
+#endif
+
+    namespace Internal
+    {
+        auto RC_DYNOUT_API acquire_format_buffer(File::StringType& fallback_buffer) -> File::StringType*;
+        auto RC_DYNOUT_API release_format_buffer(File::StringType* buffer) -> void;
+        auto RC_DYNOUT_API format_into(File::StringType& buffer, File::StringViewType fmt, FormatArgsType fmt_args) -> void;
+
+        // A message that's formatted once and then handed to every device as a view
+        // The text is formatted into a buffer that's reused by the calling thread, so logging doesn't allocate once the buffer has grown
+        // A device that logs from inside 'receive' gets a buffer of its own instead of overwriting the one that's being output
+        class FormattedMessage
+        {
+          private:
+            File::StringType m_fallback_buffer{};
+            File::StringType* m_buffer{};
+
+          public:
+            FormattedMessage(File::StringViewType fmt, FormatArgsType fmt_args) : m_buffer(acquire_format_buffer(m_fallback_buffer))
+            {
+                try
+                {
+                    format_into(*m_buffer, fmt, fmt_args);
+                }
+                catch (...)
+                {
+                    release_format_buffer(m_buffer);
+                    throw;
+                }
+            }
+            FormattedMessage(const FormattedMessage&) = delete;
+            auto operator=(const FormattedMessage&) -> FormattedMessage& = delete;
+            ~FormattedMessage()
+            {
+                release_format_buffer(m_buffer);
+            }
+
+          public:
+            auto get() const -> File::StringViewType
+            {
+                return *m_buffer;
+            }
+        };
+
+        // Devices that take an optional arg get 'optional_arg', the others only get the content
+        auto RC_DYNOUT_API write_to_devices(const OutputDevicesContainerType& devices, File::StringViewType content, int32_t optional_arg) -> void;
+
+        // The message is formatted once by the caller and then either queued for the output thread or output to every default device right away
+        // Messages go through the output filter first, 'fmt' is the format string that 'content' came from or empty if it wasn't formatted
+        auto RC_DYNOUT_API send_to_default_devices(File::StringViewType content, int32_t optional_arg, File::StringViewType fmt = {}) -> void;
+
+        // Always outputs on the calling thread, this is what the output thread calls for each queued message
+        auto RC_DYNOUT_API write_to_default_devices(File::StringViewType content, int32_t optional_arg) -> void;
+
+        // Makes every default device that buffers its output write it out, rethrows the first exception from a device once every device has been flushed
+        auto RC_DYNOUT_API flush_default_devices() -> void;
+    } // namespace Internal
+
     // Static container to hold default values
     class DefaultTargets
     {
@@ -68,13 +133,32 @@ namespace RC::Output
         static inline OutputDevicesContainerType default_devices{};
         static inline int32_t default_log_level{LogLevel::Normal};
 
+        // Applies to every default device on top of their own masks
+        static inline uint32_t log_level_mask{AllLogLevels};
+
+        // The log levels that at least one default device outputs, what the static 'send' functions check before formatting anything
+        static inline std::atomic<uint32_t> enabled_log_levels{};
+
       public:
         RC_DYNOUT_API auto static set_default_log_level(int32_t log_level) -> void;
         RC_DYNOUT_API auto static get_default_log_level() -> int32_t;
         RC_DYNOUT_API auto static get_default_devices_ref() -> OutputDevicesContainerType&;
         RC_DYNOUT_API auto static close_all_default_devices() -> void;
+        RC_DYNOUT_API auto static set_log_level_mask(uint32_t new_log_level_mask) -> void;
+        RC_DYNOUT_API auto static get_log_level_mask() -> uint32_t;
+        RC_DYNOUT_API auto static is_log_level_enabled(int32_t log_level) -> bool;
+
+        // Called whenever the default devices or any log level mask changes
+        RC_DYNOUT_API auto static update_enabled_log_levels() -> void;
     };
 
+    // Returns false if no default device outputs 'log_level', the static 'send' functions check this before formatting
+    // Use 'OUTPUT_SEND_IF_ENABLED' to also skip evaluating the arguments
+    auto inline is_log_level_enabled(int32_t log_level) -> bool
+    {
+        return DefaultTargets::is_log_level_enabled(log_level);
+    }
+
     // RAII class for making output devices not immediately close after calling send()
     // Cannot be used with default devices as those are already fully persistent, simply use the static Output::send() function instead
     template <typename OutputDeviceType, typename... OutputDeviceTypes>
@@ -102,6 +186,16 @@ namespace RC::Output
             open_device<DeviceTypeWorkaround, DeviceTypes...>();
         }
 
+        auto write_to_opened_devices(File::StringViewType content, int32_t optional_arg) -> void
+        {
+            if (m_opened_devices.empty())
+            {
+                THROW_INTERNAL_FILE_ERROR("[Output::send] Attempted to send but there were no opened devices.");
+            }
+
+            Internal::write_to_devices(m_opened_devices, content, optional_arg);
+        }
+
       public:
         Targets()
         {
@@ -111,136 +205,39 @@ namespace RC::Output
         template <EnumType OptionalArg>
         auto send(File::StringViewType content, OptionalArg optional_arg) -> void
         {
-            if (m_opened_devices.empty())
-            {
-                THROW_INTERNAL_FILE_ERROR("[Output::send] Attempted to send but there were no opened devices.");
-            }
-
-            for (const auto& device : m_opened_devices)
-            {
-                ASSERT_OUTPUT_DEVICE_IS_VALID(device)
-
-                if (device->has_optional_arg())
-                {
-                    device->receive_with_optional_arg(std::vformat(content), RC_STD_MAKE_FORMAT_ARGS(static_cast<int32_t>(optional_arg)));
-                }
-                else
-                {
-                    device->receive(std::vformat(content));
-                }
-            }
+            write_to_opened_devices(content, static_cast<int32_t>(optional_arg));
         }
 
         template <typename... FmtArgs>
         auto send(File::StringViewType content, FmtArgs... fmt_args) -> void
         {
-            if (m_opened_devices.empty())
-            {
-                THROW_INTERNAL_FILE_ERROR("[Output::send] Attempted to send but there were no opened devices.");
-            }
-
-            for (const auto& device : m_opened_devices)
-            {
-                ASSERT_OUTPUT_DEVICE_IS_VALID(device)
-
-                if (device->has_optional_arg())
-                {
-                    device->receive_with_optional_arg(std::vformat(content, RC_STD_MAKE_FORMAT_ARGS(fmt_args...)), 0);
-                }
-                else
-                {
-                    device->receive(std::vformat(content, RC_STD_MAKE_FORMAT_ARGS(fmt_args...)));
-                }
-            }
+            const Internal::FormattedMessage message{content, RC_STD_MAKE_FORMAT_ARGS(fmt_args...)};
+            write_to_opened_devices(message.get(), 0);
         }
 
         template <EnumType OptionalArg, typename... FmtArgs>
         auto send(File::StringViewType content, OptionalArg optional_arg, FmtArgs... fmt_args) -> void
         {
-            if (m_opened_devices.empty())
-            {
-                THROW_INTERNAL_FILE_ERROR("[Output::send] Attempted to send but there were no opened devices.");
-            }
-
-            for (const auto& device : m_opened_devices)
-            {
-                ASSERT_OUTPUT_DEVICE_IS_VALID(device)
-                if (device->has_optional_arg())
-                {
-                    device->receive_with_optional_arg(std::vformat(content, fmt_args...), RC_STD_MAKE_FORMAT_ARGS(static_cast<int32_t>(optional_arg)));
-                }
-                else
-                {
-                    device->receive(std::vformat(content, RC_STD_MAKE_FORMAT_ARGS(fmt_args...)));
-                }
-            }
+            const Internal::FormattedMessage message{content, RC_STD_MAKE_FORMAT_ARGS(fmt_args...)};
+            write_to_opened_devices(message.get(), static_cast<int32_t>(optional_arg));
         }
 
         auto send(const File::StringType& content) -> void
         {
-            if (m_opened_devices.empty())
-            {
-                THROW_INTERNAL_FILE_ERROR("[Output::send] Attempted to send but there were no opened devices.");
-            }
-
-            for (const auto& device : m_opened_devices)
-            {
-                ASSERT_OUTPUT_DEVICE_IS_VALID(device)
-
-                if (device->has_optional_arg())
-                {
-                    device->receive_with_optional_arg(content, 0);
-                }
-                else
-                {
-                    device->receive(content);
-                }
-            }
+            write_to_opened_devices(content, 0);
         }
 
         template <int32_t optional_arg, typename FmtArg, typename... FmtArgs>
         auto send(File::StringViewType content, FmtArg fmt_arg, FmtArgs... fmt_args) -> void
         {
-            if (m_opened_devices.empty())
-            {
-                THROW_INTERNAL_FILE_ERROR("[Output::send] Attempted to send but there were no opened devices.");
-            }
-
-            for (const auto& device : m_opened_devices)
-            {
-                ASSERT_OUTPUT_DEVICE_IS_VALID(device)
-                if (device->has_optional_arg())
-                {
-                    device->receive_with_optional_arg(std::vformat(content, RC_STD_MAKE_FORMAT_ARGS(fmt_arg, fmt_args...)), optional_arg);
-                }
-                else
-                {
-                    device->receive(std::vformat(content, RC_STD_MAKE_FORMAT_ARGS(fmt_args...)));
-                }
-            }
+            const Internal::FormattedMessage message{content, RC_STD_MAKE_FORMAT_ARGS(fmt_arg, fmt_args...)};
+            write_to_opened_devices(message.get(), optional_arg);
         }
 
         template <int32_t optional_arg>
         auto send(const File::StringType& content) -> void
         {
-            if (m_opened_devices.empty())
-            {
-                THROW_INTERNAL_FILE_ERROR("[Output::send] Attempted to send but there were no opened devices.");
-            }
-
-            for (const auto& device : m_opened_devices)
-            {
-                ASSERT_OUTPUT_DEVICE_IS_VALID(device)
-
-                if (device->has_optional_arg())
-                {
-                    device->receive_with_optional_arg(content, optional_arg);
-                }
-                else
-                {
-                    device->receive(content);
-                }
-            }
+            write_to_opened_devices(content, optional_arg);
         }
 
         template <typename DeviceType>
@@ -255,20 +252,33 @@ namespace RC::Output
     template <typename DeviceType>
     auto set_default_devices() -> DeviceType&
     {
-        return *static_cast<DeviceType*>(DefaultTargets::get_default_devices_ref().emplace_back(std::make_unique<DeviceType>()).get());
+        if (is_async_output_enabled())
+        {
+            THROW_INTERNAL_FILE_ERROR("[Output::set_default_devices] Default devices can't be added while async output is enabled.")
+        }
+        auto& device = *static_cast<DeviceType*>(DefaultTargets::get_default_devices_ref().emplace_back(std::make_unique<DeviceType>()).get());
+        DefaultTargets::update_enabled_log_levels();
+        return device;
     }
 
     // Version of set_default_devices() that can take multiple devices
     template <typename DeviceType, typename DeviceTypeWorkaround, typename... DeviceTypes>
     auto set_default_devices() -> void
     {
+        // Checked before anything is added, the output thread reads the devices without locking
+        if (is_async_output_enabled())
+        {
+            THROW_INTERNAL_FILE_ERROR("[Output::set_default_devices] Default devices can't be added while async output is enabled.")
+        }
         DefaultTargets::get_default_devices_ref().emplace_back(std::make_unique<DeviceType>());
         set_default_devices<DeviceTypeWorkaround, DeviceTypes...>();
     }
 
     auto inline clear_all_default_devices() -> void
     {
+        disable_async_output();
         DefaultTargets::get_default_devices_ref().clear();
+        DefaultTargets::update_enabled_log_levels();
     }
 
     // Sets the log level that will be used if one isn't explicitly provided with the 'send' function
@@ -281,37 +291,23 @@ namespace RC::Output
     template <typename... FmtArgs>
     auto send(File::StringViewType content, FmtArgs... fmt_args) -> void
     {
-        for (const auto& device : DefaultTargets::get_default_devices_ref())
+        if (!is_log_level_enabled(LogLevel::Default))
         {
-            ASSERT_DEFAULT_OUTPUT_DEVICE_IS_VALID(device)
-
-            if (device->has_optional_arg())
-            {
-                device->receive_with_optional_arg(std::vformat(content, RC_STD_MAKE_FORMAT_ARGS(fmt_args...)), 0);
-            }
-            else
-            {
-                device->receive(std::vformat(content, RC_STD_MAKE_FORMAT_ARGS(fmt_args...)));
-            }
+            return;
         }
+        const Internal::FormattedMessage message{content, RC_STD_MAKE_FORMAT_ARGS(fmt_args...)};
+        Internal::send_to_default_devices(message.get(), 0, content);
     }
 
     template <EnumType OptionalArg, typename... FmtArgs>
     auto send(File::StringViewType content, OptionalArg optional_arg, FmtArgs... fmt_args) -> void
     {
-        for (const auto& device : DefaultTargets::get_default_devices_ref())
+        if (!is_log_level_enabled(static_cast<int32_t>(optional_arg)))
         {
-            ASSERT_DEFAULT_OUTPUT_DEVICE_IS_VALID(device)
-
-            if (device->has_optional_arg())
-            {
-                device->receive_with_optional_arg(std::vformat(content, RC_STD_MAKE_FORMAT_ARGS(fmt_args...)), static_cast<int32_t>(optional_arg));
-            }
-            else
-            {
-                device->receive(std::vformat(content, RC_STD_MAKE_FORMAT_ARGS(fmt_args...)));
-            }
+            return;
         }
+        const Internal::FormattedMessage message{content, RC_STD_MAKE_FORMAT_ARGS(fmt_args...)};
+        Internal::send_to_default_devices(message.get(), static_cast<int32_t>(optional_arg), content);
     }
 
     auto RC_DYNOUT_API send(File::StringViewType content) -> void;
@@ -319,55 +315,24 @@ namespace RC::Output
     template <EnumType OptionalArg>
     auto send(File::StringViewType content, OptionalArg optional_arg) -> void
     {
-        for (const auto& device : DefaultTargets::get_default_devices_ref())
-        {
-            ASSERT_DEFAULT_OUTPUT_DEVICE_IS_VALID(device)
-
-            if (device->has_optional_arg())
-            {
-                device->receive_with_optional_arg(content, optional_arg);
-            }
-            else
-            {
-                device->receive(content);
-            }
-        }
+        Internal::send_to_default_devices(content, static_cast<int32_t>(optional_arg));
     }
 
     template <int32_t optional_arg, typename... FmtArgs>
     auto send(File::StringViewType content, FmtArgs... fmt_args) -> void
     {
-        for (const auto& device : DefaultTargets::get_default_devices_ref())
+        if (!is_log_level_enabled(optional_arg))
         {
-            ASSERT_DEFAULT_OUTPUT_DEVICE_IS_VALID(device)
-
-            if (device->has_optional_arg())
-            {
-                device->receive_with_optional_arg(std::vformat(content, RC_STD_MAKE_FORMAT_ARGS(fmt_args...)), optional_arg);
-            }
-            else
-            {
-                device->receive(std::vformat(content, RC_STD_MAKE_FORMAT_ARGS(fmt_args...)));
-            }
+            return;
         }
+        const Internal::FormattedMessage message{content, RC_STD_MAKE_FORMAT_ARGS(fmt_args...)};
+        Internal::send_to_default_devices(message.get(), optional_arg, content);
     }
 
     template <int32_t optional_arg>
     auto send(File::StringViewType content) -> void
     {
-        for (const auto& device : DefaultTargets::get_default_devices_ref())
-        {
-            ASSERT_DEFAULT_OUTPUT_DEVICE_IS_VALID(device)
-
-            if (device->has_optional_arg())
-            {
-                device->receive_with_optional_arg(content, optional_arg);
-            }
-            else
-            {
-                device->receive(content);
-            }
-        }
+        Internal::send_to_default_devices(content, optional_arg);
     }
 
     template <typename DeviceType>
@@ -1,6 +1,8 @@
 #ifndef UE4SS_REWRITTEN_OUTPUTDEVICE_HPP
 #define UE4SS_REWRITTEN_OUTPUTDEVICE_HPP
 
+#include <cstdint>
+
 #include <DynamicOutput/Common.hpp>
 #include <DynamicOutput/Macros.hpp>
 #include <File/Macros.hpp>
@@ -38,6 +40,20 @@ namespace RC
 
 namespace RC::Output
 {
+    // Log levels are bit indices in a log level mask, a mask with every bit set outputs everything
+    // Optional args that are too large to be a bit in the mask are never filtered
+    constexpr uint32_t AllLogLevels = 0xFFFFFFFF;
+
+    constexpr auto log_level_bit(int32_t log_level) -> uint32_t
+    {
+        return log_level >= 0 && log_level < 32 ? 1u << log_level : 0;
+    }
+
+    constexpr auto is_log_level_in_mask(uint32_t log_level_mask, int32_t log_level) -> bool
+    {
+        return log_level < 0 || log_level >= 32 || (log_level_mask & log_level_bit(log_level)) != 0;
+    }
+
     class RC_DYNOUT_API OutputDevice
     {
       protected:
@@ -49,6 +65,9 @@ namespace RC::Output
         using Formatter = File::StringType (*)(File::StringViewType);
         Formatter m_formatter{&default_format_string};
 
+        // The log levels that this device outputs, messages with any other log level are never passed to 'receive'
+        uint32_t m_log_level_mask{AllLogLevels};
+
       public:
         virtual ~OutputDevice() = default;
 
@@ -64,9 +83,17 @@ namespace RC::Output
 
         virtual auto unlock() const -> void{};
 
+        // Devices that buffer their output write it out here, this is also called from crash handlers so it must not wait forever on a lock
+        virtual auto flush() const -> void{};
+
       public:
         auto set_formatter(Formatter new_formatter) -> void;
 
+        // Also updates which log levels the static 'send' functions skip if this is a default device
+        auto set_log_level_mask(uint32_t log_level_mask) -> void;
+        auto get_log_level_mask() const -> uint32_t;
+        auto is_log_level_enabled(int32_t log_level) const -> bool;
+
       protected:
         auto static get_now_as_string() -> const File::StringType;
         auto static default_format_string(File::StringViewType) -> File::StringType;
@@ -0,0 +1,77 @@
+#ifndef UE4SS_REWRITTEN_OUTPUTFILTER_HPP
+#define UE4SS_REWRITTEN_OUTPUTFILTER_HPP
+
+#include <chrono>
+#include <cstdint>
+
+#include <DynamicOutput/Common.hpp>
+#include <File/Macros.hpp>
+
+namespace RC::Output
+{
+    struct OutputFilterOptions
+    {
+        // A message that's identical to the previous one from the same source and sent within this long of it isn't output
+        // Instead, a single 'repeated N times' message is output once the source sends a different message, by 'Output::flush',
+        // or when async output is enabled, once the window has passed, 0 disables this
+        std::chrono::milliseconds deduplication_window{};
+
+        // Every source can output this many messages in a burst, and gets this many more per second after that, 0 disables rate limiting
+        // A source is whatever 'ScopedOutputSource' is active, or the format string of the message if none is
+        // Messages that weren't formatted, and aren't sent in a 'ScopedOutputSource', are never rate limited
+        uint32_t rate_limit_burst{200};
+        uint32_t rate_limit_per_second{};
+    };
+
+    struct OutputFilterStats
+    {
+        uint64_t num_deduplicated{};
+        uint64_t num_rate_limited{};
+    };
+
+    // Only applies to the static 'send' functions, 'Targets' objects aren't filtered
+    RC_DYNOUT_API auto set_output_filter_options(const OutputFilterOptions& options) -> void;
+    RC_DYNOUT_API auto get_output_filter_options() -> OutputFilterOptions;
+    RC_DYNOUT_API auto get_output_filter_stats() -> OutputFilterStats;
+
+    // Messages sent on this thread while this is alive are rate limited as if they all came from 'source_name', which should be something like a mod name
+    // The name must outlive this object
+    class RC_DYNOUT_API ScopedOutputSource
+    {
+      private:
+        File::StringViewType m_previous_source_name{};
+
+      public:
+        explicit ScopedOutputSource(File::StringViewType source_name);
+        ~ScopedOutputSource();
+
+        ScopedOutputSource(const ScopedOutputSource&) = delete;
+        auto operator=(const ScopedOutputSource&) -> ScopedOutputSource& = delete;
+    };
+
+    namespace Internal
+    {
+        // Messages about earlier messages that were filtered, they're output before the message that they came with
+        struct FilterNotices
+        {
+            File::StringType repeated{};
+            int32_t repeated_optional_arg{};
+            File::StringType rate_limited{};
+        };
+
+        // Returns false if the message shouldn't be output, 'fmt' is empty if the message wasn't formatted
+        RC_DYNOUT_API auto filter_message(File::StringViewType content, int32_t optional_arg, File::StringViewType fmt, FilterNotices& notices) -> bool;
+
+        // Takes the 'repeated N times' message that's being held back until a different message is sent, if there is one
+        RC_DYNOUT_API auto take_pending_filter_notices(FilterNotices& notices) -> void;
+
+        // Like 'take_pending_filter_notices', but only for sources that haven't sent anything within the deduplication window
+        // The async output thread calls this when it's idle, so the repeat count of a flood that stopped is logged without waiting for another message
+        RC_DYNOUT_API auto take_expired_filter_notices(FilterNotices& notices) -> void;
+
+        // Outputs the notices to the default devices without filtering them
+        RC_DYNOUT_API auto output_filter_notices(const FilterNotices& notices) -> void;
+    } // namespace Internal
+} // namespace RC::Output
+
+#endif // UE4SS_REWRITTEN_OUTPUTFILTER_HPP
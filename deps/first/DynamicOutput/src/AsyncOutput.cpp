@@ -0,0 +1,481 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <format>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <DynamicOutput/AsyncOutput.hpp>
+#include <DynamicOutput/Output.hpp>
+
+namespace RC::Output
+{
+    // A bounded multi-producer ring of fixed-size records, each cell has a sequence number that tells producers and the consumer whose turn it is
+    // Producers claim a cell with a single compare-exchange and never take a lock, there's only ever one consumer at a time
+    class AsyncQueue
+    {
+      private:
+        // Most messages fit in a record, longer ones are copied to the heap and the record only owns the pointer
+        static constexpr size_t RecordSize = 512;
+        static constexpr size_t MaxBatchSize = 256;
+        static constexpr size_t InlineCapacity = (RecordSize - sizeof(std::atomic<size_t>) - sizeof(File::CharType*) - sizeof(uint32_t) * 2) / sizeof(File::CharType);
+
+        struct Record
+        {
+            std::atomic<size_t> sequence{};
+            File::CharType* long_text{};
+            uint32_t size{};
+            int32_t optional_arg{};
+            std::array<File::CharType, InlineCapacity> inline_text{};
+
+            auto get_text() const -> File::StringViewType
+            {
+                return {long_text ? long_text : inline_text.data(), size};
+            }
+        };
+
+      private:
+        std::unique_ptr<Record[]> m_records{};
+        size_t m_mask{};
+        FullQueuePolicy m_full_queue_policy{};
+
+        alignas(64) std::atomic<size_t> m_enqueue_position{};
+        alignas(64) std::atomic<size_t> m_dequeue_position{};
+        std::atomic<uint64_t> m_num_dropped{};
+        uint64_t m_num_dropped_reported{};
+
+        // Producers that have seen 'm_is_enabled' and haven't finished pushing yet, disabling waits for these so that no message is left behind
+        std::atomic<uint32_t> m_num_active_producers{};
+        std::atomic<bool> m_is_enabled{};
+
+        // Held by whoever is consuming, that's the output thread except when flushing from a crash handler
+        std::timed_mutex m_consumer_mutex{};
+
+        std::mutex m_wake_mutex{};
+        std::condition_variable m_wake_condition{};
+        std::condition_variable m_progress_condition{};
+        std::atomic<bool> m_is_output_thread_sleeping{};
+        bool m_has_unflushed_output{};
+        bool m_should_stop{};
+        std::thread m_output_thread{};
+
+        static inline thread_local bool s_is_output_thread{};
+
+      public:
+        static auto get() -> AsyncQueue&
+        {
+            static AsyncQueue queue{};
+            return queue;
+        }
+
+        // Only does anything if nobody closed the default devices, they're constructed before the queue so they're still alive here
+        ~AsyncQueue()
+        {
+            disable();
+        }
+
+      public:
+        auto is_enabled() const -> bool
+        {
+            return m_is_enabled.load(std::memory_order_acquire);
+        }
+
+        auto get_num_dropped() const -> uint64_t
+        {
+            return m_num_dropped.load(std::memory_order_relaxed);
+        }
+
+        auto enable(const AsyncOutputOptions& options) -> void
+        {
+            if (is_enabled())
+            {
+                return;
+            }
+
+            const size_t queue_size = std::bit_ceil(std::max<size_t>(options.queue_size, 2));
+            m_records = std::make_unique<Record[]>(queue_size);
+            for (size_t i = 0; i < queue_size; ++i)
+            {
+                m_records[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            m_mask = queue_size - 1;
+            m_full_queue_policy = options.full_queue_policy;
+            m_enqueue_position.store(0, std::memory_order_relaxed);
+            m_dequeue_position.store(0, std::memory_order_relaxed);
+            m_should_stop = false;
+
+            m_output_thread = std::thread{&AsyncQueue::output_thread_main, this};
+            m_is_enabled.store(true, std::memory_order_release);
+        }
+
+        auto disable() -> void
+        {
+            if (!m_is_enabled.exchange(false, std::memory_order_acq_rel))
+            {
+                return;
+            }
+
+            // New messages are output on the calling thread from here on, the ones that are being pushed right now still have to make it into the queue
+            while (m_num_active_producers.load(std::memory_order_acquire) != 0)
+            {
+                std::this_thread::yield();
+            }
+
+            {
+                std::lock_guard lock{m_wake_mutex};
+                m_should_stop = true;
+            }
+            m_wake_condition.notify_one();
+
+            if (s_is_output_thread)
+            {
+                // A device disabled async output from inside the output thread, it's left to finish on its own
+                m_output_thread.detach();
+                return;
+            }
+
+            if (m_output_thread.joinable())
+            {
+                m_output_thread.join();
+            }
+
+            // The output thread drains the queue before it exits, but when the process is exiting it has already been killed without getting the chance
+            // A thread that was killed while holding the consumer lock never gives it up, whatever it left behind is lost in that case
+            std::unique_lock lock{m_consumer_mutex, std::defer_lock};
+            if (lock.try_lock_for(std::chrono::seconds{1}))
+            {
+                drain();
+            }
+        }
+
+        auto try_push(File::StringViewType content, int32_t optional_arg) -> bool
+        {
+            // A device that logs while it's outputting is already on the right thread, queueing would deadlock once the queue is full
+            if (s_is_output_thread)
+            {
+                return false;
+            }
+
+            m_num_active_producers.fetch_add(1, std::memory_order_acq_rel);
+            if (!is_enabled())
+            {
+                m_num_active_producers.fetch_sub(1, std::memory_order_release);
+                return false;
+            }
+
+            push(content, optional_arg);
+
+            m_num_active_producers.fetch_sub(1, std::memory_order_release);
+            return true;
+        }
+
+        auto flush() -> void
+        {
+            if (!is_enabled() || s_is_output_thread)
+            {
+                return;
+            }
+
+            const size_t flush_position = m_enqueue_position.load(std::memory_order_acquire);
+            wake_output_thread();
+
+            std::unique_lock lock{m_wake_mutex};
+            m_progress_condition.wait(lock, [&] {
+                return m_dequeue_position.load(std::memory_order_acquire) >= flush_position || m_should_stop;
+            });
+        }
+
+        auto flush_on_crash() -> void
+        {
+            // If the crash happened while outputting then the devices can't be trusted anymore
+            if (s_is_output_thread)
+            {
+                return;
+            }
+
+            if (is_enabled())
+            {
+                // The output thread gives up the lock between batches, if it doesn't then it's stuck in a device and nothing can be done
+                std::unique_lock lock{m_consumer_mutex, std::defer_lock};
+                if (lock.try_lock_for(std::chrono::seconds{1}))
+                {
+                    drain();
+                }
+            }
+
+            flush_devices();
+        }
+
+      private:
+        auto push(File::StringViewType content, int32_t optional_arg) -> void
+        {
+            Record* record{};
+            size_t position = m_enqueue_position.load(std::memory_order_relaxed);
+            while (true)
+            {
+                record = &m_records[position & m_mask];
+                const size_t sequence = record->sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                if (difference == 0)
+                {
+                    if (m_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    // The cell still holds a message from the previous lap, so the queue is full
+                    if (m_full_queue_policy == FullQueuePolicy::Drop)
+                    {
+                        m_num_dropped.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+
+                    wake_output_thread();
+                    std::this_thread::yield();
+                    position = m_enqueue_position.load(std::memory_order_relaxed);
+                }
+                else
+                {
+                    position = m_enqueue_position.load(std::memory_order_relaxed);
+                }
+            }
+
+            record->size = static_cast<uint32_t>(content.size());
+            record->optional_arg = optional_arg;
+            if (content.size() <= InlineCapacity)
+            {
+                record->long_text = nullptr;
+                std::memcpy(record->inline_text.data(), content.data(), content.size() * sizeof(File::CharType));
+            }
+            else
+            {
+                record->long_text = new File::CharType[content.size()];
+                std::memcpy(record->long_text, content.data(), content.size() * sizeof(File::CharType));
+            }
+            record->sequence.store(position + 1, std::memory_order_release);
+
+            // Pairs with the fence in 'output_thread_main', either the output thread sees this message or this sees that it's sleeping
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_is_output_thread_sleeping.load(std::memory_order_relaxed))
+            {
+                wake_output_thread();
+            }
+        }
+
+        auto wake_output_thread() -> void
+        {
+            // Taking the lock makes sure that the output thread is either waiting or hasn't checked the queue yet, so the notification can't get lost
+            {
+                std::lock_guard lock{m_wake_mutex};
+            }
+            m_wake_condition.notify_one();
+        }
+
+        // Outputs up to 'max_messages' of the messages that have been completely pushed, must only be called while holding 'm_consumer_mutex'
+        // Returns the number of messages that were output
+        auto drain(size_t max_messages = std::numeric_limits<size_t>::max()) -> size_t
+        {
+            size_t num_output{};
+            size_t position = m_dequeue_position.load(std::memory_order_relaxed);
+            while (num_output < max_messages)
+            {
+                auto& record = m_records[position & m_mask];
+                if (record.sequence.load(std::memory_order_acquire) != position + 1)
+                {
+                    // Either empty or a producer is still copying its message, in which case the output thread is woken up again once it's done
+                    break;
+                }
+
+                try
+                {
+                    Internal::write_to_default_devices(record.get_text(), record.optional_arg);
+                }
+                catch (std::exception&)
+                {
+                    // The device has already flagged the internal error, there's no caller to rethrow to
+                }
+
+                delete[] record.long_text;
+                record.long_text = nullptr;
+                record.sequence.store(position + m_mask + 1, std::memory_order_release);
+                m_dequeue_position.store(++position, std::memory_order_release);
+                ++num_output;
+            }
+
+            report_dropped_messages();
+            return num_output;
+        }
+
+        auto report_dropped_messages() -> void
+        {
+            const auto num_dropped = m_num_dropped.load(std::memory_order_relaxed);
+            if (num_dropped == m_num_dropped_reported)
+            {
+                return;
+            }
+
+            const auto message = std::format(STR("[Output] {} messages were dropped because the output queue was full\n"), num_dropped - m_num_dropped_reported);
+            m_num_dropped_reported = num_dropped;
+            try
+            {
+                Internal::write_to_default_devices(message, LogLevel::Warning);
+            }
+            catch (std::exception&)
+            {
+            }
+        }
+
+        auto output_thread_main() -> void
+        {
+            s_is_output_thread = true;
+
+            while (true)
+            {
+                // The lock is given up between batches so that a crash handler never has to wait for a long backlog
+                size_t num_output{};
+                {
+                    std::lock_guard consumer_lock{m_consumer_mutex};
+                    num_output = drain(MaxBatchSize);
+                }
+                notify_progress();
+                m_has_unflushed_output |= num_output != 0;
+                if (num_output == MaxBatchSize)
+                {
+                    continue;
+                }
+
+                bool is_idle{};
+                {
+                    std::unique_lock lock{m_wake_mutex};
+                    if (m_should_stop)
+                    {
+                        break;
+                    }
+
+                    // Producers only notify when this flag is set, which keeps the common case free of system calls
+                    // The timeout is only a safety net, a producer that's blocked on a full queue wakes the thread up as well
+                    m_is_output_thread_sleeping.store(true, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (!has_pending_message())
+                    {
+                        is_idle = m_wake_condition.wait_for(lock, std::chrono::milliseconds{50}) == std::cv_status::timeout;
+                    }
+                    m_is_output_thread_sleeping.store(false, std::memory_order_relaxed);
+                }
+
+                if (!is_idle)
+                {
+                    continue;
+                }
+
+                // A flood of repeats that has stopped is reported here, otherwise its count would only be logged once its source sends something else
+                Internal::FilterNotices filter_notices{};
+                Internal::take_expired_filter_notices(filter_notices);
+                const bool has_filter_notices = !filter_notices.repeated.empty() || !filter_notices.rate_limited.empty();
+
+                // Devices that buffer their output are flushed once nothing has been sent for a while, so the file on disk doesn't lag behind for long
+                if (has_filter_notices || m_has_unflushed_output)
+                {
+                    std::lock_guard consumer_lock{m_consumer_mutex};
+                    if (has_filter_notices)
+                    {
+                        try
+                        {
+                            // Output straight to the devices since this is the output thread
+                            Internal::output_filter_notices(filter_notices);
+                        }
+                        catch (std::exception&)
+                        {
+                            // The device has already flagged the internal error, there's no caller to rethrow to
+                        }
+                    }
+                    flush_devices();
+                    m_has_unflushed_output = false;
+                }
+            }
+
+            // Stopping only happens once no producer can push anymore, so this is everything that's left
+            {
+                std::lock_guard consumer_lock{m_consumer_mutex};
+                drain();
+            }
+            notify_progress();
+        }
+
+        auto flush_devices() -> void
+        {
+            try
+            {
+                Internal::flush_default_devices();
+            }
+            catch (std::exception&)
+            {
+                // The device has already flagged the internal error, there's no caller to rethrow to
+            }
+        }
+
+        auto notify_progress() -> void
+        {
+            {
+                std::lock_guard lock{m_wake_mutex};
+            }
+            m_progress_condition.notify_all();
+        }
+
+        auto has_pending_message() const -> bool
+        {
+            const size_t position = m_dequeue_position.load(std::memory_order_relaxed);
+            return m_records[position & m_mask].sequence.load(std::memory_order_acquire) == position + 1;
+        }
+    };
+
+    auto enable_async_output(const AsyncOutputOptions& options) -> void
+    {
+        AsyncQueue::get().enable(options);
+    }
+
+    auto disable_async_output() -> void
+    {
+        AsyncQueue::get().disable();
+    }
+
+    auto is_async_output_enabled() -> bool
+    {
+        return AsyncQueue::get().is_enabled();
+    }
+
+    auto flush() -> void
+    {
+        // A flood of repeats that just ended would otherwise only be reported once a different message is sent
+        Internal::FilterNotices filter_notices{};
+        Internal::take_pending_filter_notices(filter_notices);
+        Internal::output_filter_notices(filter_notices);
+
+        AsyncQueue::get().flush();
+        Internal::flush_default_devices();
+    }
+
+    auto flush_on_crash() -> void
+    {
+        AsyncQueue::get().flush_on_crash();
+    }
+
+    auto get_num_dropped_messages() -> uint64_t
+    {
+        return AsyncQueue::get().get_num_dropped();
+    }
+
+    auto Internal::try_send_async(File::StringViewType content, int32_t optional_arg) -> bool
+    {
+        return AsyncQueue::get().try_push(content, optional_arg);
+    }
+} // namespace RC::Output
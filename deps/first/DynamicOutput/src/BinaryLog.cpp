@@ -0,0 +1,307 @@
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <DynamicOutput/BinaryLog.hpp>
+
+namespace RC::Output::BinaryLog
+{
+    // Messages are collected here and handed to the writer thread in one go once there's this much
+    static constexpr size_t FlushThreshold = 256 * 1024;
+
+    // Messages that don't fill a buffer are still written this often, so a quiet log doesn't stay empty until it's closed
+    static constexpr std::chrono::seconds WriteInterval{1};
+
+    // Threads sending messages wait for the writer thread once this many full buffers are waiting to be written
+    static constexpr size_t MaxPendingBuffers = 16;
+
+    struct RegisteredCallSite
+    {
+        File::StringType fmt{};
+        int32_t log_level{};
+        std::vector<ArgType> arg_types{};
+    };
+
+    static std::timed_mutex s_mutex{};
+    static std::atomic<bool> s_is_open{};
+    static std::vector<uint8_t> s_buffer{};
+    static std::vector<RegisteredCallSite> s_call_sites{};
+
+    // Full buffers waiting for the writer thread, and emptied ones it's given back
+    static std::deque<std::vector<uint8_t>> s_pending_buffers{};
+    static std::vector<std::vector<uint8_t>> s_spare_buffers{};
+    static std::condition_variable_any s_pending_condition{};
+    static std::condition_variable_any s_written_condition{};
+    static bool s_is_writing{};
+    static bool s_writer_should_stop{};
+    static std::thread s_writer_thread{};
+
+    // Only the writer thread writes to the file while the log is open, 's_mutex' is never taken while holding this
+    static std::timed_mutex s_file_mutex{};
+    static std::ofstream s_file{};
+
+    static thread_local std::vector<uint8_t> s_payload_buffer{};
+
+    // All of these must only be called while holding 's_mutex'
+    template <typename T>
+    static auto append(const T& value) -> void
+    {
+        const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+        s_buffer.insert(s_buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    static auto append_call_site(uint32_t id, const RegisteredCallSite& call_site) -> void
+    {
+        append(RecordType::CallSite);
+        append(id);
+        append(call_site.log_level);
+        append(static_cast<uint8_t>(call_site.arg_types.size()));
+        for (const auto arg_type : call_site.arg_types)
+        {
+            append(arg_type);
+        }
+        append(static_cast<uint32_t>(call_site.fmt.size()));
+        const auto fmt_bytes = reinterpret_cast<const uint8_t*>(call_site.fmt.data());
+        s_buffer.insert(s_buffer.end(), fmt_bytes, fmt_bytes + call_site.fmt.size() * sizeof(File::CharType));
+    }
+
+    // Must be called while holding 's_file_mutex' instead
+    static auto write_to_file(const std::vector<uint8_t>& buffer) -> void
+    {
+        s_file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        s_file.flush();
+    }
+
+    static auto hand_off_buffer(std::unique_lock<std::timed_mutex>& lock) -> void
+    {
+        if (s_buffer.empty())
+        {
+            return;
+        }
+
+        // Only happens if the disk can't keep up, in which case it's better to slow down than to use unbounded memory
+        // Another thread may have handed the buffer off while this one was waiting
+        s_written_condition.wait(lock, [] {
+            return s_pending_buffers.size() < MaxPendingBuffers;
+        });
+        if (s_buffer.empty())
+        {
+            return;
+        }
+
+        s_pending_buffers.emplace_back(std::move(s_buffer));
+        if (s_spare_buffers.empty())
+        {
+            s_buffer = {};
+            s_buffer.reserve(FlushThreshold * 2);
+        }
+        else
+        {
+            s_buffer = std::move(s_spare_buffers.back());
+            s_spare_buffers.pop_back();
+        }
+        s_pending_condition.notify_one();
+    }
+
+    static auto writer_thread_main() -> void
+    {
+        std::unique_lock lock{s_mutex};
+        while (true)
+        {
+            const bool was_woken = s_pending_condition.wait_for(lock, WriteInterval, [] {
+                return s_writer_should_stop || !s_pending_buffers.empty();
+            });
+            if (!was_woken)
+            {
+                // Nothing is pending after a timeout, so this never waits on the writer thread itself
+                hand_off_buffer(lock);
+            }
+            if (s_pending_buffers.empty())
+            {
+                if (s_writer_should_stop)
+                {
+                    break;
+                }
+                continue;
+            }
+
+            auto buffer = std::move(s_pending_buffers.front());
+            s_pending_buffers.pop_front();
+            s_is_writing = true;
+            lock.unlock();
+
+            {
+                std::lock_guard file_lock{s_file_mutex};
+                write_to_file(buffer);
+            }
+            buffer.clear();
+
+            lock.lock();
+            s_is_writing = false;
+            if (s_spare_buffers.size() < 2)
+            {
+                s_spare_buffers.emplace_back(std::move(buffer));
+            }
+            s_written_condition.notify_all();
+        }
+    }
+
+    auto close() -> void
+    {
+        {
+            std::unique_lock lock{s_mutex};
+            if (!s_is_open.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            s_is_open.store(false, std::memory_order_release);
+            hand_off_buffer(lock);
+            s_writer_should_stop = true;
+            s_pending_condition.notify_one();
+        }
+
+        // The writer thread writes everything that's pending before it exits
+        if (s_writer_thread.joinable())
+        {
+            s_writer_thread.join();
+        }
+
+        std::lock_guard file_lock{s_file_mutex};
+        s_file.close();
+    }
+
+    auto open(const std::filesystem::path& file_path) -> void
+    {
+        close();
+
+        std::lock_guard lock{s_mutex};
+        {
+            std::lock_guard file_lock{s_file_mutex};
+            s_file.open(file_path, std::ios::binary | std::ios::trunc);
+            if (!s_file.is_open())
+            {
+                throw std::runtime_error{std::format("[BinaryLog::open] Could not open '{}'", file_path.string())};
+            }
+        }
+
+        s_buffer.clear();
+        s_buffer.reserve(FlushThreshold * 2);
+        s_buffer.insert(s_buffer.end(), std::begin(FileMagic), std::end(FileMagic));
+        append(FileVersion);
+        append(static_cast<uint32_t>(sizeof(File::CharType)));
+        append(static_cast<uint32_t>(sizeof(wchar_t)));
+        for (size_t i = 0; i < s_call_sites.size(); ++i)
+        {
+            append_call_site(static_cast<uint32_t>(i + 1), s_call_sites[i]);
+        }
+
+        s_writer_should_stop = false;
+        s_writer_thread = std::thread{&writer_thread_main};
+        s_is_open.store(true, std::memory_order_release);
+    }
+
+    // Writes whatever is left if the log is still open when the process exits, a joinable std::thread would terminate it otherwise
+    static struct CloseOnExit
+    {
+        ~CloseOnExit()
+        {
+            close();
+        }
+    } s_close_on_exit{};
+
+    auto is_open() -> bool
+    {
+        return s_is_open.load(std::memory_order_acquire);
+    }
+
+    auto flush() -> void
+    {
+        std::unique_lock lock{s_mutex};
+        if (!s_is_open.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        hand_off_buffer(lock);
+        s_written_condition.wait(lock, [] {
+            return s_pending_buffers.empty() && !s_is_writing;
+        });
+    }
+
+    auto flush_on_crash() -> void
+    {
+        // The crashed thread may have been in the middle of a message, in which case the buffer can't be trusted anyway
+        // The writer thread may never run again so everything that's pending is written here instead
+        std::unique_lock lock{s_mutex, std::defer_lock};
+        if (!lock.try_lock_for(std::chrono::seconds{1}) || !s_is_open.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        std::unique_lock file_lock{s_file_mutex, std::defer_lock};
+        if (!file_lock.try_lock_for(std::chrono::seconds{1}))
+        {
+            return;
+        }
+        for (auto& buffer : s_pending_buffers)
+        {
+            write_to_file(buffer);
+        }
+        s_pending_buffers.clear();
+        write_to_file(s_buffer);
+        s_buffer.clear();
+    }
+
+    auto Internal::register_call_site(CallSite& call_site, File::StringViewType fmt, int32_t log_level, std::span<const ArgType> arg_types) -> uint32_t
+    {
+        std::lock_guard lock{s_mutex};
+
+        // Another thread may have registered it while this one was waiting for the lock
+        if (const auto id = call_site.id.load(std::memory_order_relaxed); id != 0)
+        {
+            return id;
+        }
+
+        auto& registered = s_call_sites.emplace_back(File::StringType{fmt}, log_level, std::vector<ArgType>{arg_types.begin(), arg_types.end()});
+        const auto id = static_cast<uint32_t>(s_call_sites.size());
+        if (s_is_open.load(std::memory_order_relaxed))
+        {
+            append_call_site(id, registered);
+        }
+
+        call_site.id.store(id, std::memory_order_release);
+        return id;
+    }
+
+    auto Internal::get_payload_buffer(size_t payload_size) -> uint8_t*
+    {
+        s_payload_buffer.resize(payload_size);
+        return s_payload_buffer.data();
+    }
+
+    auto Internal::write_message(uint32_t call_site_id) -> void
+    {
+        const auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+        std::unique_lock lock{s_mutex};
+        if (!s_is_open.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        append(RecordType::Message);
+        append(call_site_id);
+        append(static_cast<int64_t>(timestamp));
+        append(static_cast<uint32_t>(s_payload_buffer.size()));
+        s_buffer.insert(s_buffer.end(), s_payload_buffer.begin(), s_payload_buffer.end());
+
+        if (s_buffer.size() >= FlushThreshold)
+        {
+            hand_off_buffer(lock);
+        }
+    }
+} // namespace RC::Output::BinaryLog
@@ -0,0 +1,227 @@
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <DynamicOutput/BufferedFileDevice.hpp>
+
+namespace RC::Output
+{
+    // The number of bytes that 'string' takes up once it's converted to UTF-8, which is what the file is written in
+    static auto get_utf8_size(File::StringViewType string) -> size_t
+    {
+        size_t size{};
+        for (const auto c : string)
+        {
+            const auto code_unit = static_cast<uint32_t>(c);
+            if (code_unit < 0x80) size += 1;
+            else if (code_unit < 0x800) size += 2;
+            // A surrogate pair is one 4 byte character, it's counted on the high surrogate
+            else if (code_unit >= 0xD800 && code_unit <= 0xDBFF) size += 4;
+            else if (code_unit >= 0xDC00 && code_unit <= 0xDFFF) size += 0;
+            else if (code_unit < 0x10000) size += 3;
+            else size += 4;
+        }
+        return size;
+    }
+
+    BufferedFileDevice::~BufferedFileDevice()
+    {
+        if (m_flush_thread.joinable())
+        {
+            {
+                std::lock_guard lock{m_mutex};
+                m_should_stop_flushing = true;
+            }
+            m_flush_condition.notify_all();
+            m_flush_thread.join();
+        }
+
+        // Do nothing if the file was never actually opened
+        if (!m_file.is_valid())
+        {
+            return;
+        }
+
+        try
+        {
+            write_buffer();
+        }
+        catch (std::exception&)
+        {
+            // Destructors must not throw, the output is lost either way
+        }
+        m_file.close();
+    }
+
+    auto BufferedFileDevice::start_device() const -> void
+    {
+        for (uint32_t i = 1; i <= m_options.max_rotated_files; ++i)
+        {
+            std::error_code ec{};
+            std::filesystem::remove(get_rotated_file_path(i), ec);
+        }
+
+        m_file = File::open(m_file_name_and_path, File::OpenFor::Appending, File::OverwriteExistingFile::Yes, File::CreateIfNonExistent::Yes);
+        m_file_size = 0;
+        m_is_device_ready = true;
+
+        if (m_options.flush_interval > std::chrono::milliseconds::zero())
+        {
+            m_flush_thread = std::thread{&BufferedFileDevice::flush_thread_main, this};
+        }
+    }
+
+    auto BufferedFileDevice::get_rotated_file_path(uint32_t index) const -> std::filesystem::path
+    {
+        auto file_name = m_file_name_and_path.stem();
+        file_name += "." + std::to_string(index);
+        file_name += m_file_name_and_path.extension();
+        return m_file_name_and_path.parent_path() / file_name;
+    }
+
+    auto BufferedFileDevice::rotate() const -> void
+    {
+        m_file.close();
+
+        // A rotated file that can't be moved is overwritten instead, losing an old log shouldn't stop the new one from being written
+        std::error_code ec{};
+        if (m_options.max_rotated_files > 0)
+        {
+            std::filesystem::remove(get_rotated_file_path(m_options.max_rotated_files), ec);
+            for (uint32_t i = m_options.max_rotated_files; i > 1; --i)
+            {
+                std::filesystem::rename(get_rotated_file_path(i - 1), get_rotated_file_path(i), ec);
+            }
+            std::filesystem::rename(m_file_name_and_path, get_rotated_file_path(1), ec);
+        }
+
+        m_file = File::open(m_file_name_and_path, File::OpenFor::Appending, File::OverwriteExistingFile::Yes, File::CreateIfNonExistent::Yes);
+        m_file_size = 0;
+    }
+
+    auto BufferedFileDevice::write_buffer() const -> void
+    {
+        if (m_buffer.empty())
+        {
+            return;
+        }
+
+        // The buffer is given up even if the write fails, otherwise every message after it would fail the same way
+        const auto buffer_size_in_bytes = m_buffer_size_in_bytes;
+        m_buffer_size_in_bytes = 0;
+        try
+        {
+            m_file.write_string_to_file(m_buffer);
+        }
+        catch (...)
+        {
+            m_buffer.clear();
+            throw;
+        }
+        m_buffer.clear();
+        m_file_size += buffer_size_in_bytes;
+    }
+
+    auto BufferedFileDevice::flush_thread_main() const -> void
+    {
+        std::unique_lock lock{m_mutex};
+        while (!m_should_stop_flushing)
+        {
+            m_flush_condition.wait_for(lock, m_options.flush_interval, [&] {
+                return m_should_stop_flushing;
+            });
+            if (m_should_stop_flushing || m_buffer.empty() || ClockType::now() - m_oldest_buffered_time < m_options.flush_interval)
+            {
+                continue;
+            }
+
+            try
+            {
+                write_buffer();
+            }
+            catch (std::exception&)
+            {
+                // The file has already flagged the internal error, there's no caller to rethrow to
+            }
+        }
+    }
+
+    auto BufferedFileDevice::has_optional_arg() const -> bool
+    {
+        return true;
+    }
+
+    auto BufferedFileDevice::receive(File::StringViewType fmt) const -> void
+    {
+        receive_message(fmt, false);
+    }
+
+    auto BufferedFileDevice::receive_with_optional_arg(File::StringViewType fmt, int32_t optional_arg) const -> void
+    {
+        // Errors are often followed by a crash or the game being closed, so they're not left in the buffer
+        receive_message(fmt, optional_arg == LogLevel::Error);
+    }
+
+    auto BufferedFileDevice::receive_message(File::StringViewType fmt, bool should_write_now) const -> void
+    {
+        const auto message = m_formatter(fmt);
+        const auto message_size = get_utf8_size(message);
+
+        std::lock_guard lock{m_mutex};
+        if (!m_is_device_ready)
+        {
+            start_device();
+        }
+
+        const auto size_after_message = m_file_size + m_buffer_size_in_bytes + message_size;
+        if (m_options.max_file_size != 0 && size_after_message > m_options.max_file_size && m_file_size + m_buffer_size_in_bytes != 0)
+        {
+            write_buffer();
+            rotate();
+        }
+
+        const auto now = ClockType::now();
+        if (m_buffer.empty())
+        {
+            m_oldest_buffered_time = now;
+        }
+        m_buffer.append(message);
+        m_buffer_size_in_bytes += message_size;
+
+        if (should_write_now || m_buffer_size_in_bytes >= m_options.flush_size || now - m_oldest_buffered_time >= m_options.flush_interval)
+        {
+            write_buffer();
+        }
+    }
+
+    auto BufferedFileDevice::flush() const -> void
+    {
+        // This is also called from crash handlers, where the thread that holds the lock may never give it up
+        // A slow write on another thread can hold the lock for a while too, so it's retried a few times before giving up
+        std::unique_lock lock{m_mutex, std::defer_lock};
+        for (int attempt = 0; attempt < 3 && !lock.owns_lock(); ++attempt)
+        {
+            lock.try_lock_for(std::chrono::seconds{1});
+        }
+        if (!lock.owns_lock())
+        {
+            throw std::runtime_error{"[BufferedFileDevice::flush] Timed out waiting for another thread, the buffered output was not written"};
+        }
+
+        if (m_is_device_ready)
+        {
+            write_buffer();
+        }
+    }
+
+    auto BufferedFileDevice::set_file_name_and_path(const File::StringType& file_name_and_path) -> void
+    {
+        m_file_name_and_path = file_name_and_path;
+    }
+
+    auto BufferedFileDevice::set_options(const BufferedFileDeviceOptions& options) -> void
+    {
+        m_options = options;
+        m_buffer.reserve(m_options.flush_size);
+    }
+} // namespace RC::Output
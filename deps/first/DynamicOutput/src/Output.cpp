@@ -1,3 +1,6 @@
+#include <exception>
+#include <iterator>
+
 #include <DynamicOutput/Output.hpp>
 
 namespace RC::Output
@@ -24,19 +27,88 @@ namespace RC::Output
 
     auto DefaultTargets::close_all_default_devices() -> void
     {
+        // The output thread must be done with the devices before they're destroyed
+        disable_async_output();
+
         // clear() will empty the container and will also call all the destructors
         default_devices.clear();
+        update_enabled_log_levels();
     }
 
-    auto send(File::StringViewType content) -> void
+    auto DefaultTargets::set_log_level_mask(uint32_t new_log_level_mask) -> void
+    {
+        log_level_mask = new_log_level_mask;
+        update_enabled_log_levels();
+    }
+
+    auto DefaultTargets::get_log_level_mask() -> uint32_t
+    {
+        return log_level_mask;
+    }
+
+    auto DefaultTargets::is_log_level_enabled(int32_t log_level) -> bool
+    {
+        return is_log_level_in_mask(enabled_log_levels.load(std::memory_order_relaxed), log_level);
+    }
+
+    auto DefaultTargets::update_enabled_log_levels() -> void
+    {
+        uint32_t device_log_levels{};
+        for (const auto& device : default_devices)
+        {
+            device_log_levels |= device ? device->get_log_level_mask() : 0;
+        }
+        enabled_log_levels.store(device_log_levels & log_level_mask, std::memory_order_relaxed);
+    }
+
+    static auto output_to_default_devices(File::StringViewType content, int32_t optional_arg) -> void
+    {
+        if (Internal::try_send_async(content, optional_arg))
+        {
+            return;
+        }
+
+        Internal::write_to_default_devices(content, optional_arg);
+    }
+
+    auto Internal::send_to_default_devices(File::StringViewType content, int32_t optional_arg, File::StringViewType fmt) -> void
+    {
+        FilterNotices filter_notices{};
+        if (!filter_message(content, optional_arg, fmt, filter_notices))
+        {
+            return;
+        }
+
+        output_filter_notices(filter_notices);
+        output_to_default_devices(content, optional_arg);
+    }
+
+    auto Internal::output_filter_notices(const FilterNotices& notices) -> void
+    {
+        if (!notices.repeated.empty())
+        {
+            output_to_default_devices(notices.repeated, notices.repeated_optional_arg);
+        }
+        if (!notices.rate_limited.empty())
+        {
+            output_to_default_devices(notices.rate_limited, LogLevel::Warning);
+        }
+    }
+
+    auto Internal::write_to_default_devices(File::StringViewType content, int32_t optional_arg) -> void
     {
         for (const auto& device : DefaultTargets::get_default_devices_ref())
         {
             ASSERT_DEFAULT_OUTPUT_DEVICE_IS_VALID(device)
 
+            if (!device->is_log_level_enabled(optional_arg) || !is_log_level_in_mask(DefaultTargets::get_log_level_mask(), optional_arg))
+            {
+                continue;
+            }
+
             if (device->has_optional_arg())
             {
-                device->receive_with_optional_arg(content, 0);
+                device->receive_with_optional_arg(content, optional_arg);
             }
             else
             {
@@ -45,6 +117,95 @@ namespace RC::Output
         }
     }
 
+    auto Internal::flush_default_devices() -> void
+    {
+        // One device failing to flush shouldn't stop the others from being flushed, the first error is rethrown once they all have been
+        std::exception_ptr first_error{};
+        for (const auto& device : DefaultTargets::get_default_devices_ref())
+        {
+            ASSERT_DEFAULT_OUTPUT_DEVICE_IS_VALID(device)
+            try
+            {
+                device->flush();
+            }
+            catch (std::exception&)
+            {
+                if (!first_error)
+                {
+                    first_error = std::current_exception();
+                }
+            }
+        }
+
+        if (first_error)
+        {
+            std::rethrow_exception(first_error);
+        }
+    }
+
+    auto Internal::write_to_devices(const OutputDevicesContainerType& devices, File::StringViewType content, int32_t optional_arg) -> void
+    {
+        for (const auto& device : devices)
+        {
+            ASSERT_OUTPUT_DEVICE_IS_VALID(device)
+
+            if (!device->is_log_level_enabled(optional_arg))
+            {
+                continue;
+            }
+
+            if (device->has_optional_arg())
+            {
+                device->receive_with_optional_arg(content, optional_arg);
+            }
+            else
+            {
+                device->receive(content);
+            }
+        }
+    }
+
+    // Anything larger than this is given back after the message, so that one huge message doesn't keep its memory around for the rest of the session
+    static constexpr size_t max_kept_format_buffer_capacity = 64 * 1024;
+    static thread_local File::StringType thread_format_buffer{};
+    static thread_local bool is_thread_format_buffer_in_use{};
+
+    auto Internal::acquire_format_buffer(File::StringType& fallback_buffer) -> File::StringType*
+    {
+        if (is_thread_format_buffer_in_use)
+        {
+            return &fallback_buffer;
+        }
+
+        is_thread_format_buffer_in_use = true;
+        thread_format_buffer.clear();
+        return &thread_format_buffer;
+    }
+
+    auto Internal::release_format_buffer(File::StringType* buffer) -> void
+    {
+        if (buffer != &thread_format_buffer)
+        {
+            return;
+        }
+
+        if (thread_format_buffer.capacity() > max_kept_format_buffer_capacity)
+        {
+            File::StringType{}.swap(thread_format_buffer);
+        }
+        is_thread_format_buffer_in_use = false;
+    }
+
+    auto Internal::format_into(File::StringType& buffer, File::StringViewType fmt, FormatArgsType fmt_args) -> void
+    {
+        std::vformat_to(std::back_inserter(buffer), fmt, fmt_args);
+    }
+
+    auto send(File::StringViewType content) -> void
+    {
+        Internal::send_to_default_devices(content, 0);
+    }
+
     auto close_all_default_devices() -> void
     {
         DefaultTargets::close_all_default_devices();
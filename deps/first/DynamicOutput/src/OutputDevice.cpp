@@ -1,6 +1,7 @@
 #include <chrono>
 #include <format>
 
+#include <DynamicOutput/Output.hpp>
 #include <DynamicOutput/OutputDevice.hpp>
 
 namespace RC::Output
@@ -22,6 +23,22 @@ namespace RC::Output
         m_formatter = new_formatter;
     }
 
+    auto OutputDevice::set_log_level_mask(uint32_t log_level_mask) -> void
+    {
+        m_log_level_mask = log_level_mask;
+        DefaultTargets::update_enabled_log_levels();
+    }
+
+    auto OutputDevice::get_log_level_mask() const -> uint32_t
+    {
+        return m_log_level_mask;
+    }
+
+    auto OutputDevice::is_log_level_enabled(int32_t log_level) const -> bool
+    {
+        return is_log_level_in_mask(m_log_level_mask, log_level);
+    }
+
     auto OutputDevice::get_now_as_string() -> const File::StringType
     {
         auto now = std::chrono::system_clock::now();
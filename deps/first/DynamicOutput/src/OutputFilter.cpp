@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <format>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+#include <DynamicOutput/OutputDevice.hpp>
+#include <DynamicOutput/OutputFilter.hpp>
+
+namespace RC::Output
+{
+    static thread_local File::StringViewType s_current_source_name{};
+
+    class OutputFilter
+    {
+      private:
+        using ClockType = std::chrono::steady_clock;
+
+        // Anything past this is only kept for sources that are still being limited, so that unique format strings can't grow the map forever
+        static constexpr size_t MaxNumBuckets = 4096;
+
+        // Format strings can be long, only the start of one is needed to tell where the suppressed messages came from
+        static constexpr size_t MaxSourceNameLengthInNotice = 80;
+
+        // Sources that end up in the same slot are deduplicated as if they were one source
+        static constexpr size_t NumDeduplicationSlots = 64;
+
+        struct StringHash
+        {
+            using is_transparent = void;
+
+            auto operator()(File::StringViewType string) const -> size_t
+            {
+                return std::hash<File::StringViewType>{}(string);
+            }
+        };
+
+        // Only the hash of the last message is kept, so checking for a repeat doesn't copy the message
+        struct alignas(64) DeduplicationSlot
+        {
+            std::mutex mutex{};
+            size_t last_message_hash{};
+            size_t last_message_size{};
+            int32_t last_optional_arg{};
+            ClockType::time_point last_message_time{};
+            uint64_t num_repeats{};
+
+            // Copied once a message starts repeating, for the notice
+            File::StringType source_name{};
+        };
+
+        struct Bucket
+        {
+            double num_tokens{};
+            ClockType::time_point last_refill_time{};
+            uint64_t num_suppressed{};
+        };
+
+      private:
+        // Only guards the options and the rate limit buckets, deduplication locks a single slot instead
+        std::mutex m_mutex{};
+        std::atomic<bool> m_is_enabled{};
+        std::atomic<bool> m_is_rate_limiting_enabled{};
+        std::atomic<ClockType::rep> m_deduplication_window{};
+        OutputFilterOptions m_options{};
+
+        std::atomic<uint64_t> m_num_deduplicated{};
+        std::atomic<uint64_t> m_num_rate_limited{};
+
+        std::array<DeduplicationSlot, NumDeduplicationSlots> m_deduplication_slots{};
+
+        std::unordered_map<File::StringType, Bucket, StringHash, std::equal_to<>> m_buckets{};
+
+      public:
+        static auto get() -> OutputFilter&
+        {
+            static OutputFilter filter{};
+            return filter;
+        }
+
+      public:
+        auto set_options(const OutputFilterOptions& options) -> void
+        {
+            std::lock_guard lock{m_mutex};
+            m_options = options;
+            m_buckets.clear();
+
+            const auto deduplication_window = std::chrono::duration_cast<ClockType::duration>(std::max(options.deduplication_window, std::chrono::milliseconds::zero()));
+            m_deduplication_window.store(deduplication_window.count(), std::memory_order_relaxed);
+            m_is_rate_limiting_enabled.store(options.rate_limit_per_second > 0, std::memory_order_relaxed);
+            m_is_enabled.store(deduplication_window.count() > 0 || options.rate_limit_per_second > 0, std::memory_order_release);
+        }
+
+        auto get_options() -> OutputFilterOptions
+        {
+            std::lock_guard lock{m_mutex};
+            return m_options;
+        }
+
+        auto get_stats() const -> OutputFilterStats
+        {
+            return {m_num_deduplicated.load(std::memory_order_relaxed), m_num_rate_limited.load(std::memory_order_relaxed)};
+        }
+
+        auto filter(File::StringViewType content, int32_t optional_arg, File::StringViewType fmt, Internal::FilterNotices& notices) -> bool
+        {
+            if (!m_is_enabled.load(std::memory_order_acquire))
+            {
+                return true;
+            }
+
+            const auto now = ClockType::now();
+            const auto source_name = s_current_source_name.empty() ? fmt : s_current_source_name;
+
+            // Repeats are checked first so that they don't use up the tokens of their source
+            const ClockType::duration deduplication_window{m_deduplication_window.load(std::memory_order_relaxed)};
+            DeduplicationSlot* slot{};
+            size_t message_hash{};
+            if (deduplication_window.count() > 0)
+            {
+                slot = &m_deduplication_slots[StringHash{}(source_name) % NumDeduplicationSlots];
+                message_hash = StringHash{}(content);
+
+                std::lock_guard slot_lock{slot->mutex};
+                if (message_hash == slot->last_message_hash && content.size() == slot->last_message_size && optional_arg == slot->last_optional_arg &&
+                    now - slot->last_message_time < deduplication_window)
+                {
+                    if (slot->num_repeats++ == 0)
+                    {
+                        slot->source_name.assign(source_name);
+                    }
+                    m_num_deduplicated.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            }
+
+            if (m_is_rate_limiting_enabled.load(std::memory_order_relaxed) && !source_name.empty())
+            {
+                std::lock_guard lock{m_mutex};
+                auto& bucket = get_bucket(source_name, now);
+                if (bucket.num_tokens < 1.0)
+                {
+                    ++bucket.num_suppressed;
+                    m_num_rate_limited.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                bucket.num_tokens -= 1.0;
+
+                if (bucket.num_suppressed != 0)
+                {
+                    notices.rate_limited = std::format(STR("[Output] {} messages from '{}' were suppressed by the rate limit\n"),
+                                                       bucket.num_suppressed,
+                                                       get_source_name_for_notice(source_name));
+                    bucket.num_suppressed = 0;
+                }
+            }
+
+            if (slot)
+            {
+                std::lock_guard slot_lock{slot->mutex};
+                take_repeated_notice(*slot, notices);
+                slot->last_message_hash = message_hash;
+                slot->last_message_size = content.size();
+                slot->last_optional_arg = optional_arg;
+                slot->last_message_time = now;
+            }
+
+            return true;
+        }
+
+        // Only takes the notices of sources whose window has passed if 'only_expired' is set, the repeats of the others can still be extended
+        auto take_pending_notices(Internal::FilterNotices& notices, bool only_expired) -> void
+        {
+            if (!m_is_enabled.load(std::memory_order_acquire))
+            {
+                return;
+            }
+
+            const auto now = ClockType::now();
+            const ClockType::duration deduplication_window{m_deduplication_window.load(std::memory_order_relaxed)};
+            for (auto& slot : m_deduplication_slots)
+            {
+                std::lock_guard slot_lock{slot.mutex};
+                if (!only_expired || now - slot.last_message_time >= deduplication_window)
+                {
+                    take_repeated_notice(slot, notices);
+                }
+            }
+        }
+
+      private:
+        // Must only be called while holding the lock of 'slot'
+        static auto take_repeated_notice(DeduplicationSlot& slot, Internal::FilterNotices& notices) -> void
+        {
+            if (slot.num_repeats == 0)
+            {
+                return;
+            }
+
+            if (slot.source_name.empty())
+            {
+                notices.repeated += std::format(STR("[Output] The previous message was repeated {} more times\n"), slot.num_repeats);
+            }
+            else
+            {
+                notices.repeated += std::format(STR("[Output] The previous message from '{}' was repeated {} more times\n"),
+                                                get_source_name_for_notice(slot.source_name),
+                                                slot.num_repeats);
+            }
+            notices.repeated_optional_arg = slot.last_optional_arg;
+            slot.num_repeats = 0;
+        }
+
+        // Must only be called while holding 'm_mutex'
+        auto get_bucket(File::StringViewType source_name, ClockType::time_point now) -> Bucket&
+        {
+            const auto burst = static_cast<double>(std::max<uint32_t>(m_options.rate_limit_burst, 1));
+            const auto get_refilled_num_tokens = [&](const Bucket& bucket) {
+                const std::chrono::duration<double> elapsed = now - bucket.last_refill_time;
+                return std::min(burst, bucket.num_tokens + elapsed.count() * m_options.rate_limit_per_second);
+            };
+
+            if (auto it = m_buckets.find(source_name); it != m_buckets.end())
+            {
+                it->second.num_tokens = get_refilled_num_tokens(it->second);
+                it->second.last_refill_time = now;
+                return it->second;
+            }
+
+            if (m_buckets.size() >= MaxNumBuckets)
+            {
+                // A full bucket with nothing suppressed is no different from a new one
+                std::erase_if(m_buckets, [&](const auto& entry) {
+                    return get_refilled_num_tokens(entry.second) >= burst && entry.second.num_suppressed == 0;
+                });
+            }
+
+            return m_buckets.emplace(File::StringType{source_name}, Bucket{burst, now, 0}).first->second;
+        }
+
+        static auto get_source_name_for_notice(File::StringViewType source_name) -> File::StringType
+        {
+            while (!source_name.empty() && (source_name.back() == STR('\n') || source_name.back() == STR('\r')))
+            {
+                source_name.remove_suffix(1);
+            }
+            if (source_name.size() <= MaxSourceNameLengthInNotice)
+            {
+                return File::StringType{source_name};
+            }
+            return File::StringType{source_name.substr(0, MaxSourceNameLengthInNotice)} + STR("...");
+        }
+    };
+
+    auto set_output_filter_options(const OutputFilterOptions& options) -> void
+    {
+        OutputFilter::get().set_options(options);
+    }
+
+    auto get_output_filter_options() -> OutputFilterOptions
+    {
+        return OutputFilter::get().get_options();
+    }
+
+    auto get_output_filter_stats() -> OutputFilterStats
+    {
+        return OutputFilter::get().get_stats();
+    }
+
+    ScopedOutputSource::ScopedOutputSource(File::StringViewType source_name) : m_previous_source_name(s_current_source_name)
+    {
+        s_current_source_name = source_name;
+    }
+
+    ScopedOutputSource::~ScopedOutputSource()
+    {
+        s_current_source_name = m_previous_source_name;
+    }
+
+    auto Internal::filter_message(File::StringViewType content, int32_t optional_arg, File::StringViewType fmt, FilterNotices& notices) -> bool
+    {
+        return OutputFilter::get().filter(content, optional_arg, fmt, notices);
+    }
+
+    auto Internal::take_pending_filter_notices(FilterNotices& notices) -> void
+    {
+        OutputFilter::get().take_pending_notices(notices, false);
+    }
+
+    auto Internal::take_expired_filter_notices(FilterNotices& notices) -> void
+    {
+        OutputFilter::get().take_pending_notices(notices, true);
+    }
+} // namespace RC::Output
@@ -1,5 +1,12 @@
 #pragma once
 
+// __declspec only exists on Windows, the POSIX backend is built as a plain library
+#ifndef _WIN32
+#ifndef RC_FILE_API
+#define RC_FILE_API
+#endif
+#endif
+
 #ifndef RC_FILE_EXPORTS
 #ifndef RC_FILE_BUILD_STATIC
 #ifndef RC_FILE_API
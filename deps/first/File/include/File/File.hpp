@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <span>
+
 #include <File/Common.hpp>
 #include <File/FileDef.hpp>
 #include <File/HandleTemplate.hpp>
@@ -13,4 +16,8 @@ namespace RC::File
                           CreateIfNonExistent = CreateIfNonExistent::No) -> Handle;
 
     RC_FILE_API auto delete_file(const std::filesystem::path& file_path_and_name) -> void;
+
+    // Turns the raw bytes of a file into the string that 'read_all' returns, the BOM is stripped and every other byte becomes one character
+    // The memory that 'output' already has is reused
+    RC_FILE_API auto decode_file_contents(std::span<const uint8_t> file_contents, StringType& output) -> void;
 } // namespace RC::File
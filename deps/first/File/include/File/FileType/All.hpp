@@ -1,3 +1,5 @@
 #pragma once
 
-#include <File/FileType/WinFile.hpp>
+// Only the file type of the current OS is included, every file type defines 'Handle'
+#include <File/FileDef.hpp>
+#include RC_OS_FILE_TYPE_INCLUDE_FILE
@@ -84,6 +84,10 @@ namespace RC::File
         // Throws std::runtime_error if an error occurred
         virtual auto read_all() const -> StringType = 0;
 
+        // Same as above but reads into 'output', the memory that 'output' already has is reused
+        // Throws std::runtime_error if an error occurred
+        virtual auto read_all(StringType& output) const -> void = 0;
+
         virtual auto memory_map() -> std::span<uint8_t> = 0;
 
         /*
@@ -78,6 +78,7 @@ namespace RC::File
         RC_FILE_API auto write_string_to_file(StringViewType string_to_write) -> void override;
         RC_FILE_API auto is_same_as(WinFile& other_file) -> bool override;
         [[nodiscard]] RC_FILE_API auto read_all() const -> StringType override;
+        RC_FILE_API auto read_all(StringType& output) const -> void override;
         [[nodiscard]] RC_FILE_API auto memory_map() -> std::span<uint8_t> override;
         [[nodiscard]] RC_FILE_API auto static open_file(const std::filesystem::path& file_name_and_path, const OpenProperties& open_properties) -> WinFile;
         // File Interface -> END
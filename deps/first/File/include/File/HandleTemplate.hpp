@@ -4,6 +4,7 @@
 #include <memory>
 #include <span>
 #include <string>
+#include <type_traits>
 
 #include <File/Common.hpp>
 #include <File/Enums.hpp>
@@ -106,46 +107,38 @@ namespace RC::File
             m_internal_handle.invalidate_serialization();
         }
 
+        // Explicit specializations aren't allowed in class scope by GCC and Clang, so the supported types are picked with 'if constexpr' instead
         template <typename SerializedDataType>
         auto serialize_item(SerializedDataType data) -> void
         {
-            throw std::runtime_error{"not reached"};
-        }
-
-        template <>
-        auto serialize_item(unsigned long data) -> void
-        {
-            m_internal_handle.serialize_item({.data_type = GenericDataType::UnsignedLong, .data_ulong = data}, false);
-        }
-
-        template <>
-        auto serialize_item(signed long data) -> void
-        {
-            m_internal_handle.serialize_item({.data_type = GenericDataType::SignedLong, .data_long = data}, false);
-        }
-
-        template <>
-        auto serialize_item(unsigned long long data) -> void
-        {
-            m_internal_handle.serialize_item({.data_type = GenericDataType::UnsignedLongLong, .data_ulonglong = data}, false);
-        }
-
-        template <>
-        auto serialize_item(signed long long data) -> void
-        {
-            m_internal_handle.serialize_item({.data_type = GenericDataType::SignedLongLong, .data_longlong = data}, false);
-        }
-
-        template <>
-        auto serialize_item(unsigned int data) -> void
-        {
-            serialize_item<unsigned long>(data);
-        }
-
-        template <>
-        auto serialize_item(signed int data) -> void
-        {
-            serialize_item<signed long>(data);
+            if constexpr (std::is_same_v<SerializedDataType, unsigned long>)
+            {
+                m_internal_handle.serialize_item({.data_type = GenericDataType::UnsignedLong, .data_ulong = data}, false);
+            }
+            else if constexpr (std::is_same_v<SerializedDataType, signed long>)
+            {
+                m_internal_handle.serialize_item({.data_type = GenericDataType::SignedLong, .data_long = data}, false);
+            }
+            else if constexpr (std::is_same_v<SerializedDataType, unsigned long long>)
+            {
+                m_internal_handle.serialize_item({.data_type = GenericDataType::UnsignedLongLong, .data_ulonglong = data}, false);
+            }
+            else if constexpr (std::is_same_v<SerializedDataType, signed long long>)
+            {
+                m_internal_handle.serialize_item({.data_type = GenericDataType::SignedLongLong, .data_longlong = data}, false);
+            }
+            else if constexpr (std::is_same_v<SerializedDataType, unsigned int>)
+            {
+                serialize_item<unsigned long>(data);
+            }
+            else if constexpr (std::is_same_v<SerializedDataType, signed int>)
+            {
+                serialize_item<signed long>(data);
+            }
+            else
+            {
+                throw std::runtime_error{"not reached"};
+            }
         }
 
         template <typename SerializedDataType>
@@ -169,6 +162,21 @@ namespace RC::File
             return m_internal_handle.read_all();
         }
 
+        auto read_all(StringType& output) const -> void
+        {
+            m_internal_handle.read_all(output);
+        }
+
+        // Reads the entire file into a buffer that belongs to the calling thread and returns a view of it
+        // Once the buffer is big enough, reading another file doesn't allocate at all
+        // The view is only valid until the next call to 'read_all_view' on the same thread, copy it if it needs to live longer than that
+        [[nodiscard]] auto read_all_view() const -> StringViewType
+        {
+            thread_local StringType buffer{};
+            m_internal_handle.read_all(buffer);
+            return buffer;
+        }
+
         [[nodiscard]] auto memory_map() -> std::span<uint8_t>
         {
             return m_internal_handle.memory_map();
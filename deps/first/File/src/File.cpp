@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <File/File.hpp>
 
 namespace RC::File
@@ -26,4 +28,19 @@ namespace RC::File
     {
         Handle::FileType::delete_file(file_path_and_name);
     }
+
+    auto decode_file_contents(std::span<const uint8_t> file_contents, StringType& output) -> void
+    {
+        // Strip the BOM if it exists
+        if (file_contents.size() >= 3 && file_contents[0] == 0xEF && file_contents[1] == 0xBB && file_contents[2] == 0xBF)
+        {
+            file_contents = file_contents.subspan(3);
+        }
+
+        // Every byte becomes one character, the same as the stream that this used to be read with
+        output.resize(file_contents.size());
+        std::transform(file_contents.begin(), file_contents.end(), output.begin(), [](uint8_t byte) {
+            return static_cast<CharType>(byte);
+        });
+    }
 } // namespace RC::File
\ No newline at end of file
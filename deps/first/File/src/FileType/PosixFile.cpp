@@ -0,0 +1,596 @@
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <File/File.hpp>
+#include <File/FileType/PosixFile.hpp>
+#include <File/HandleTemplate.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace RC::File
+{
+    auto PosixFile::is_valid() noexcept -> bool
+    {
+        return m_file != -1;
+    }
+
+    auto PosixFile::invalidate_file() noexcept -> void
+    {
+        // The mapping belongs to whichever file this one was moved into
+        m_file = -1;
+        m_memory_map = nullptr;
+        m_memory_map_size = 0;
+    }
+
+    auto PosixFile::delete_file(const std::filesystem::path& file_path_and_name) -> void
+    {
+        if (::unlink(file_path_and_name.c_str()) != 0)
+        {
+            THROW_INTERNAL_FILE_ERROR(std::format("[PosixFile::delete_file] Was unable to delete file, error: {}", errno))
+        }
+    }
+
+    auto PosixFile::delete_file() -> void
+    {
+        if (m_is_file_open)
+        {
+            close_file();
+        }
+
+        delete_file(m_file_path_and_name);
+    }
+
+    auto PosixFile::set_file(int new_file) -> void
+    {
+        m_file = new_file;
+    }
+
+    auto PosixFile::get_file() const -> int
+    {
+        return m_file;
+    }
+
+    auto PosixFile::set_is_file_open(bool new_is_open) -> void
+    {
+        m_is_file_open = new_is_open;
+    }
+
+    auto PosixFile::get_raw_handle() noexcept -> void*
+    {
+        // The file descriptor is the value of the pointer, use 'get_file' to get it back as an int
+        return reinterpret_cast<void*>(static_cast<intptr_t>(m_file));
+    }
+
+    auto PosixFile::get_file_path() const noexcept -> const std::filesystem::path&
+    {
+        return m_file_path_and_name;
+    }
+
+    auto PosixFile::set_serialization_output_file(const std::filesystem::path& output_file) noexcept -> void
+    {
+        m_serialization_file_path_and_name = output_file;
+    }
+
+    auto PosixFile::serialization_file_exists() -> bool
+    {
+        return std::filesystem::exists(m_serialization_file_path_and_name);
+    }
+
+    template <typename DataType>
+    auto write_to_file(PosixFile& file, DataType* data, size_t num_bytes_to_write) -> void
+    {
+        if (!file.is_file_open())
+        {
+            THROW_INTERNAL_FILE_ERROR("[PosixFile::write_to_file] Tried writing to file but the file is not open")
+        }
+
+        // Unlike WriteFile, write may only write part of the data
+        auto* bytes = reinterpret_cast<const uint8_t*>(data);
+        while (num_bytes_to_write > 0)
+        {
+            const auto bytes_written = ::write(file.get_file(), bytes, num_bytes_to_write);
+            if (bytes_written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                THROW_INTERNAL_FILE_ERROR(std::format("[PosixFile::write_to_file] Tried writing to file but was unable to complete operation. Error: {}", errno))
+            }
+            bytes += bytes_written;
+            num_bytes_to_write -= static_cast<size_t>(bytes_written);
+        }
+    }
+
+    auto PosixFile::get_identifying_properties(const char* caller) const -> IdentifyingProperties
+    {
+        struct stat file_info{};
+        if (::fstat(m_file, &file_info) != 0)
+        {
+            THROW_INTERNAL_FILE_ERROR(std::format("[PosixFile::{}] Tried retrieving file information. Error: {}", caller, errno))
+        }
+
+#ifdef __APPLE__
+        const auto& last_write_time = file_info.st_mtimespec;
+#else
+        const auto& last_write_time = file_info.st_mtim;
+#endif
+        return {
+                .device = static_cast<unsigned long long>(file_info.st_dev),
+                .inode = static_cast<unsigned long long>(file_info.st_ino),
+                .last_write_time_seconds = static_cast<unsigned long long>(last_write_time.tv_sec),
+                .last_write_time_nanoseconds = static_cast<unsigned long long>(last_write_time.tv_nsec),
+                .file_size = static_cast<unsigned long long>(file_info.st_size),
+        };
+    }
+
+    // Serialization Format (POSIX):
+    // device
+    // inode
+    // last_write_time_seconds
+    // last_write_time_nanoseconds
+    // file_size
+    // user_data
+    auto PosixFile::serialize_identifying_properties() -> void
+    {
+        if (m_serialization_file_path_and_name.empty())
+        {
+            THROW_INTERNAL_FILE_ERROR("[PosixFile::serialize_identifying_properties]: Path & file name for serialization file is empty, please call "
+                                      "'set_serialization_output_file'")
+        }
+
+        const auto properties = get_identifying_properties("serialize_identifying_properties");
+        for (const auto property : {properties.device,
+                                    properties.inode,
+                                    properties.last_write_time_seconds,
+                                    properties.last_write_time_nanoseconds,
+                                    properties.file_size})
+        {
+            serialize_item(GenericItemData{.data_type = GenericDataType::UnsignedLongLong, .data_ulonglong = property}, true);
+        }
+    }
+
+    auto PosixFile::deserialize_identifying_properties() -> void
+    {
+        // The cache isn't aligned, so the items are copied out of it instead of dereferenced in place
+        auto get_property = [&] {
+            unsigned long long property{};
+            std::memcpy(&property, get_serialized_item(sizeof(property), true), sizeof(property));
+            return property;
+        };
+
+        m_identifying_properties.device = get_property();
+        m_identifying_properties.inode = get_property();
+        m_identifying_properties.last_write_time_seconds = get_property();
+        m_identifying_properties.last_write_time_nanoseconds = get_property();
+        m_identifying_properties.file_size = get_property();
+
+        // The cached identifying properties should be inaccessible by user-code,
+        // so let's make sure that the next serialized item to be deserialized by the user-code
+        // is the first item after the last identifying property item
+        m_offset_to_next_serialized_item = sizeof(IdentifyingProperties);
+
+        m_has_cached_identifying_properties = true;
+    }
+
+    auto PosixFile::is_deserialized_and_live_equal() -> bool
+    {
+        if (!m_has_cached_identifying_properties)
+        {
+            if (!std::filesystem::exists(m_serialization_file_path_and_name))
+            {
+                return false;
+            }
+            else
+            {
+                deserialize_identifying_properties();
+            }
+        }
+
+        const auto live_properties = get_identifying_properties("is_deserialized_and_live_equal");
+        return live_properties.device == m_identifying_properties.device && live_properties.inode == m_identifying_properties.inode &&
+               live_properties.last_write_time_seconds == m_identifying_properties.last_write_time_seconds &&
+               live_properties.last_write_time_nanoseconds == m_identifying_properties.last_write_time_nanoseconds &&
+               live_properties.file_size == m_identifying_properties.file_size;
+    }
+
+    auto PosixFile::invalidate_serialization() -> void
+    {
+        if (m_serialization_file_path_and_name.empty())
+        {
+            THROW_INTERNAL_FILE_ERROR("[PosixFile::invalidate_serialization] Could not invalidate serialization file because "
+                                      "'m_serialization_file_path_and_name' was empty, please call 'set_serialization_output_file'")
+        }
+
+        if (std::filesystem::exists(m_serialization_file_path_and_name))
+        {
+            delete_file(m_serialization_file_path_and_name);
+        }
+    }
+
+    template <typename DataType>
+    auto serialize_typed_item(DataType data, Handle& output_file) -> void
+    {
+        write_to_file(output_file.get_underlying_type(), &data, sizeof(DataType));
+    }
+
+    auto PosixFile::serialize_item(const GenericItemData& data, bool is_internal_item) -> void
+    {
+        if (m_serialization_file_path_and_name.empty())
+        {
+            THROW_INTERNAL_FILE_ERROR(
+                    "[PosixFile::serialize_item]: Path & file name for serialization file is empty, please call 'set_serialization_output_file'")
+        }
+
+        if (!serialization_file_exists() && !is_internal_item)
+        {
+            // If the serialization cache file doesn't exist & this is not an identifying property item,
+            // then we need to serialize the identifying properties before continuing
+            serialize_identifying_properties();
+        }
+
+        Handle serialization_file = open(m_serialization_file_path_and_name, OpenFor::Appending, OverwriteExistingFile::No, CreateIfNonExistent::Yes);
+
+        switch (data.data_type)
+        {
+        case GenericDataType::UnsignedLong:
+            serialize_typed_item<unsigned long>(data.data_ulong, serialization_file);
+            break;
+        case GenericDataType::SignedLong:
+            serialize_typed_item<signed long>(data.data_long, serialization_file);
+            break;
+        case GenericDataType::UnsignedLongLong:
+            serialize_typed_item<unsigned long long>(data.data_ulonglong, serialization_file);
+            break;
+        case GenericDataType::SignedLongLong:
+            serialize_typed_item<signed long long>(data.data_longlong, serialization_file);
+            break;
+        }
+
+        serialization_file.close();
+    }
+
+    auto PosixFile::get_serialized_item(size_t data_size, bool is_internal_item) -> void*
+    {
+        if (!m_has_cache_in_memory)
+        {
+            if (m_serialization_file_path_and_name.empty())
+            {
+                THROW_INTERNAL_FILE_ERROR(
+                        "[PosixFile::get_serialized_item]: Path & file name for serialization file is empty, please call 'set_serialization_output_file'")
+            }
+
+            Handle cache_file = open(m_serialization_file_path_and_name);
+
+            size_t num_bytes_read{};
+            while (num_bytes_read < cache_size)
+            {
+                const auto result = ::read(cache_file.get_underlying_type().get_file(), m_cache + num_bytes_read, cache_size - num_bytes_read);
+                if (result < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    THROW_INTERNAL_FILE_ERROR(
+                            std::format("[PosixFile::get_serialized_item] Tried deserializing file but was unable to complete operation. Error: {}", errno))
+                }
+                if (result == 0)
+                {
+                    break;
+                }
+                num_bytes_read += static_cast<size_t>(result);
+            }
+
+            cache_file.close();
+
+            m_has_cache_in_memory = true;
+        }
+
+        if (!m_has_cached_identifying_properties && !is_internal_item)
+        {
+            deserialize_identifying_properties();
+        }
+
+        void* data_ptr = &m_cache[m_offset_to_next_serialized_item];
+        m_offset_to_next_serialized_item += data_size;
+        return data_ptr;
+    }
+
+    auto PosixFile::close_current_file() -> void
+    {
+        close_file();
+    }
+
+    auto PosixFile::create_all_directories(const std::filesystem::path& file_name_and_path) -> void
+    {
+        if (file_name_and_path.parent_path().empty())
+        {
+            return;
+        }
+
+        try
+        {
+            std::filesystem::create_directories(file_name_and_path.parent_path());
+        }
+        catch (const std::filesystem::filesystem_error& e)
+        {
+            THROW_INTERNAL_FILE_ERROR(std::format("[PosixFile::create_all_directories] Tried creating directories '{}' but encountered an error. Error: {}",
+                                                  file_name_and_path.string(),
+                                                  e.what()))
+        }
+    }
+
+    auto PosixFile::unmap_file() -> void
+    {
+        if (!m_memory_map)
+        {
+            return;
+        }
+
+        if (::munmap(m_memory_map, m_memory_map_size) != 0)
+        {
+            THROW_INTERNAL_FILE_ERROR(std::format("[PosixFile::unmap_file] Was unable to unmap file, error: {}", errno))
+        }
+        m_memory_map = nullptr;
+        m_memory_map_size = 0;
+    }
+
+    auto PosixFile::close_file() -> void
+    {
+        unmap_file();
+
+        if (!is_valid() || !is_file_open())
+        {
+            return;
+        }
+
+        // The descriptor is given up even if close fails, retrying could close a descriptor that was reused by another thread
+        const auto result = ::close(m_file);
+        m_file = -1;
+        set_is_file_open(false);
+        if (result != 0 && errno != EINTR)
+        {
+            THROW_INTERNAL_FILE_ERROR(std::format("[PosixFile::close_file] Was unable to close file, error: {}", errno))
+        }
+    }
+
+    auto PosixFile::is_file_open() const -> bool
+    {
+        return m_is_file_open;
+    }
+
+    // Appends 'code_point' as UTF-8, anything that isn't a valid code point is written as U+FFFD
+    static auto append_utf8(std::string& output, uint32_t code_point) -> void
+    {
+        if (code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF))
+        {
+            code_point = 0xFFFD;
+        }
+
+        if (code_point < 0x80)
+        {
+            output.push_back(static_cast<char>(code_point));
+        }
+        else if (code_point < 0x800)
+        {
+            output.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+            output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+        else if (code_point < 0x10000)
+        {
+            output.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+            output.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+        else
+        {
+            output.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+            output.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+            output.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+    }
+
+    auto PosixFile::write_string_to_file(StringViewType string_to_write) -> void
+    {
+        // Files are always written as UTF-8, the same as on Windows
+        std::string string_converted_to_utf8{};
+        if constexpr (sizeof(CharType) == 1)
+        {
+            string_converted_to_utf8.assign(string_to_write.begin(), string_to_write.end());
+        }
+        else
+        {
+            string_converted_to_utf8.reserve(string_to_write.size());
+            for (size_t i = 0; i < string_to_write.size(); ++i)
+            {
+                auto code_point = static_cast<uint32_t>(string_to_write[i]);
+
+                // wchar_t is UTF-32 on most POSIX systems, but it's UTF-16 where it's only two bytes
+                if constexpr (sizeof(CharType) == 2)
+                {
+                    if (code_point >= 0xD800 && code_point <= 0xDBFF && i + 1 < string_to_write.size())
+                    {
+                        const auto low_surrogate = static_cast<uint32_t>(string_to_write[i + 1]);
+                        if (low_surrogate >= 0xDC00 && low_surrogate <= 0xDFFF)
+                        {
+                            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low_surrogate - 0xDC00);
+                            ++i;
+                        }
+                    }
+                }
+
+                append_utf8(string_converted_to_utf8, code_point);
+            }
+        }
+
+        write_to_file(*this, string_converted_to_utf8.data(), string_converted_to_utf8.size());
+    }
+
+    auto PosixFile::is_same_as(PosixFile& other_file) -> bool
+    {
+        const auto properties = get_identifying_properties("is_same_as");
+        const auto other_properties = other_file.get_identifying_properties("is_same_as");
+        return properties.device == other_properties.device && properties.inode == other_properties.inode &&
+               properties.last_write_time_seconds == other_properties.last_write_time_seconds &&
+               properties.last_write_time_nanoseconds == other_properties.last_write_time_nanoseconds && properties.file_size == other_properties.file_size;
+    }
+
+    auto PosixFile::read_all() const -> StringType
+    {
+        StringType file_contents{};
+        read_all(file_contents);
+        return file_contents;
+    }
+
+    auto PosixFile::read_all(StringType& output) const -> void
+    {
+        const auto file_size = get_identifying_properties("read_all").file_size;
+
+        // Not a memory map, reading a mapped file that's truncated by someone else at the same time raises SIGBUS
+        // The bytes go into a buffer that's kept around for the next read on this thread instead
+        thread_local std::vector<uint8_t> file_contents{};
+        file_contents.resize(file_size);
+
+        // pread leaves the file offset alone, so this doesn't move where the next write to the file goes
+        size_t num_bytes_read{};
+        while (num_bytes_read < file_contents.size())
+        {
+            const auto result =
+                    ::pread(m_file, file_contents.data() + num_bytes_read, file_contents.size() - num_bytes_read, static_cast<off_t>(num_bytes_read));
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                THROW_INTERNAL_FILE_ERROR(std::format("[PosixFile::read_all] Tried to read entire file but returned error {}", errno))
+            }
+            if (result == 0)
+            {
+                // The file was truncated while it was being read
+                break;
+            }
+            num_bytes_read += static_cast<size_t>(result);
+        }
+
+        decode_file_contents(std::span(file_contents.data(), num_bytes_read), output);
+    }
+
+    auto PosixFile::memory_map() -> std::span<uint8_t>
+    {
+        int protection{};
+        switch (m_open_properties.open_for)
+        {
+        case OpenFor::Writing:
+        case OpenFor::Appending:
+            protection = PROT_READ | PROT_WRITE;
+            break;
+        case OpenFor::Reading:
+            protection = PROT_READ;
+            break;
+        default:
+            THROW_INTERNAL_FILE_ERROR("[PosixFile::memory_map] Tried to memory map file but 'm_open_properties' contains invalid data.")
+        }
+
+        // Mapping the file again replaces the previous view, the file may have grown since then
+        unmap_file();
+
+        const auto file_size = static_cast<size_t>(get_identifying_properties("memory_map").file_size);
+        if (file_size == 0)
+        {
+            // mmap refuses to map zero bytes, an empty file is just an empty span
+            return {};
+        }
+
+        void* memory_map = ::mmap(nullptr, file_size, protection, MAP_SHARED, m_file, 0);
+        if (memory_map == MAP_FAILED)
+        {
+            THROW_INTERNAL_FILE_ERROR(std::format("[PosixFile::memory_map] Tried to memory map file but 'mmap' returned error: {}", errno))
+        }
+
+        m_memory_map = static_cast<uint8_t*>(memory_map);
+        m_memory_map_size = file_size;
+        return std::span(m_memory_map, m_memory_map_size);
+    }
+
+    auto PosixFile::open_file(const std::filesystem::path& file_name_and_path, const OpenProperties& open_properties) -> PosixFile
+    {
+        if (file_name_and_path.empty())
+        {
+            THROW_INTERNAL_FILE_ERROR("[PosixFile::open_file] Tried to open file but file_name_and_path was empty.")
+        }
+
+        // Files that are written to can also be read, mmap needs that even for a view that's only ever written to
+        int flags = O_CLOEXEC;
+        switch (open_properties.open_for)
+        {
+        case OpenFor::Writing:
+            flags |= O_RDWR;
+            break;
+        case OpenFor::Appending:
+            flags |= O_RDWR | O_APPEND;
+            break;
+        case OpenFor::Reading:
+            flags |= O_RDONLY;
+            break;
+        default:
+            THROW_INTERNAL_FILE_ERROR("[PosixFile::open_file] Tried to open file but received invalid data for the 'OpenFor' parameter.")
+        }
+
+        if (open_properties.overwrite_existing_file == OverwriteExistingFile::Yes)
+        {
+            create_all_directories(file_name_and_path);
+            flags |= O_CREAT | O_TRUNC;
+        }
+        else if (open_properties.create_if_non_existent == CreateIfNonExistent::Yes)
+        {
+            create_all_directories(file_name_and_path);
+            flags |= O_CREAT;
+        }
+
+        PosixFile file{};
+
+        int new_file{};
+        do
+        {
+            new_file = ::open(file_name_and_path.c_str(), flags, 0666);
+        } while (new_file == -1 && errno == EINTR);
+        file.set_file(new_file);
+
+        if (file.get_file() == -1)
+        {
+            std::string_view open_type = open_properties.open_for == OpenFor::Writing || open_properties.open_for == OpenFor::Appending ? "writing" : "reading";
+
+            const int error = errno;
+            if (error == ENOENT)
+            {
+                std::error_code ec{};
+                if (file_name_and_path.has_parent_path() && !std::filesystem::exists(file_name_and_path.parent_path(), ec))
+                {
+                    throw FileNotFoundException{std::format("Path not found: {}", file_name_and_path.filename().string())};
+                }
+                throw FileNotFoundException{std::format("File not found: {}", file_name_and_path.filename().string())};
+            }
+            else
+            {
+                THROW_INTERNAL_FILE_ERROR(std::format("[PosixFile::open_file] Tried opening file for {} but encountered an error. Path & File: {} | errno = {}\n",
+                                                      open_type,
+                                                      file_name_and_path.string(),
+                                                      error))
+            }
+        }
+
+        file.m_file_path_and_name = file_name_and_path;
+        file.set_is_file_open(true);
+        file.m_open_properties = open_properties;
+
+        return file;
+    }
+} // namespace RC::File
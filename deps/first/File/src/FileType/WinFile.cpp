@@ -1,4 +1,3 @@
-#include <fstream>
 
 #include <File/File.hpp>
 #include <File/FileType/WinFile.hpp>
@@ -452,36 +451,85 @@ namespace RC::File
 
     auto WinFile::read_all() const -> StringType
     {
-        StreamType stream{get_file_path(), std::ios::in | std::ios::binary};
-        if (!stream)
-        {
-            THROW_INTERNAL_FILE_ERROR(std::format("[WinFile::read_all] Tried to read entire file but returned error {}", errno))
+        StringType file_contents{};
+        read_all(file_contents);
+        return file_contents;
+    }
+
+    auto WinFile::read_all(StringType& output) const -> void
+    {
+        // Handles that were opened for writing can't be read from, those files are opened again just for this
+        HANDLE file = m_file;
+        if (m_open_properties.open_for != OpenFor::Reading)
+        {
+            file = CreateFileW(get_file_path().wstring().c_str(),
+                               GENERIC_READ,
+                               FILE_SHARE_READ | FILE_SHARE_WRITE,
+                               nullptr,
+                               OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                               nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                THROW_INTERNAL_FILE_ERROR(std::format("[WinFile::read_all] Tried to read entire file but 'CreateFileW' returned error {}", GetLastError()))
+            }
         }
-        else
+
+        HANDLE map_handle{};
+        const void* memory_map{};
+        auto cleanup = [&] {
+            if (memory_map)
+            {
+                UnmapViewOfFile(memory_map);
+            }
+            if (map_handle)
+            {
+                CloseHandle(map_handle);
+            }
+            if (file != m_file)
+            {
+                CloseHandle(file);
+            }
+        };
+
+        try
         {
-            // Strip the BOM if it exists
-            File::StreamType::off_type start{};
-            File::CharType bom[3]{};
-            stream.read(bom, 3);
-            if (bom[0] == 0xEF && bom[1] == 0xBB && bom[2] == 0xBF)
+            LARGE_INTEGER file_size{};
+            if (!GetFileSizeEx(file, &file_size))
             {
-                // BOM: UTF-8
-                start = 3;
+                THROW_INTERNAL_FILE_ERROR(std::format("[WinFile::read_all] Tried to read entire file but 'GetFileSizeEx' returned error {}", GetLastError()))
             }
 
-            StringType file_contents;
-            stream.seekg(0, std::ios::end);
-            auto size = stream.tellg();
-            if (size == -1)
+            // A file that's mapped can't be truncated by anyone, so the contents are decoded straight out of the view without copying the bytes first
+            // Empty files can't be mapped at all
+            if (file_size.QuadPart == 0)
             {
-                return {};
+                output.clear();
+            }
+            else
+            {
+                map_handle = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (!map_handle)
+                {
+                    THROW_INTERNAL_FILE_ERROR(
+                            std::format("[WinFile::read_all] Tried to read entire file but 'CreateFileMapping' returned error {}", GetLastError()))
+                }
+
+                memory_map = MapViewOfFile(map_handle, FILE_MAP_READ, 0, 0, 0);
+                if (!memory_map)
+                {
+                    THROW_INTERNAL_FILE_ERROR(std::format("[WinFile::read_all] Tried to read entire file but 'MapViewOfFile' returned error {}", GetLastError()))
+                }
+
+                decode_file_contents(std::span(static_cast<const uint8_t*>(memory_map), static_cast<size_t>(file_size.QuadPart)), output);
             }
-            file_contents.resize(size);
-            stream.seekg(start, std::ios::beg);
-            stream.read(&file_contents[0], file_contents.size());
-            stream.close();
-            return file_contents;
         }
+        catch (...)
+        {
+            cleanup();
+            throw;
+        }
+        cleanup();
     }
 
     auto WinFile::memory_map() -> std::span<uint8_t>
@@ -503,6 +551,18 @@ namespace RC::File
             THROW_INTERNAL_FILE_ERROR("[WinFile::memory_map] Tried to memory map file but 'm_open_properties' contains invalid data.")
         }
 
+        // The view is rounded up to whole pages, the file size is how much of it is actually the file
+        LARGE_INTEGER file_size{};
+        if (!GetFileSizeEx(get_raw_handle(), &file_size))
+        {
+            THROW_INTERNAL_FILE_ERROR(std::format("[WinFile::memory_map] Tried to memory map file but 'GetFileSizeEx' returned error: {}", GetLastError()))
+        }
+        if (file_size.QuadPart == 0)
+        {
+            // CreateFileMapping refuses to map an empty file, an empty file is just an empty span
+            return {};
+        }
+
         m_map_handle = CreateFileMapping(get_raw_handle(), nullptr, handle_desired_access, 0, 0, nullptr);
         if (!m_map_handle)
         {
@@ -515,9 +575,7 @@ namespace RC::File
             THROW_INTERNAL_FILE_ERROR(std::format("[WinFile::memory_map] Tried to memory map file but 'MapViewOfFile' returned error: {}", GetLastError()))
         }
 
-        MEMORY_BASIC_INFORMATION buffer{};
-        auto size = VirtualQuery(m_memory_map, &buffer, sizeof(decltype(buffer)));
-        return std::span(m_memory_map, size);
+        return std::span(m_memory_map, static_cast<size_t>(file_size.QuadPart));
     }
 
     auto WinFile::open_file(const std::filesystem::path& file_name_and_path, const OpenProperties& open_properties) -> WinFile
@@ -30,13 +30,13 @@ namespace RC::Ini
         Parser() = default;
 
       private:
-        RC_INI_PARSER_API auto parse_internal(File::StringType& input) -> void;
+        RC_INI_PARSER_API auto parse_internal(File::StringViewType input) -> void;
         RC_INI_PARSER_API auto create_available_tokens_for_tokenizer() -> ParserBase::TokenContainer;
         RC_INI_PARSER_API auto get_value(const File::StringType& section, const File::StringType& key, CanThrow = CanThrow::Yes) const
                 -> std::optional<std::reference_wrapper<const Value>>;
 
       public:
-        RC_INI_PARSER_API auto parse(File::StringType& input) -> void;
+        RC_INI_PARSER_API auto parse(File::StringViewType input) -> void;
         RC_INI_PARSER_API auto parse(const File::Handle&) -> void;
         RC_INI_PARSER_API auto get_list(const File::StringType& section) -> List;
         RC_INI_PARSER_API auto get_ordered_list(const File::StringType& section) -> List;
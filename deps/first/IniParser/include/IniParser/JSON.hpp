@@ -166,7 +166,7 @@ namespace RC::Parser
             bool m_double_quote_successfully_closed{false};
 
           public:
-            TokenParser(const Parser::Tokenizer& tokenizer, File::StringType& input) : Parser::TokenParser(tokenizer, input)
+            TokenParser(const Parser::Tokenizer& tokenizer, File::StringViewType input) : Parser::TokenParser(tokenizer, input)
             {
             }
 
@@ -198,10 +198,10 @@ namespace RC::Parser
         JSON() = default;
 
       private:
-        auto parse_internal(File::StringType& input) -> void;
+        auto parse_internal(File::StringViewType input) -> void;
 
       public:
-        auto parse(File::StringType& input) -> void;
+        auto parse(File::StringViewType input) -> void;
         auto parse(File::Handle&) -> void;
         auto release_contents() -> std::vector<std::unique_ptr<JSONInternal::ItemBase>>;
 
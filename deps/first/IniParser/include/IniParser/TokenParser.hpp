@@ -35,7 +35,7 @@ namespace RC::Ini
         State m_current_state{State::StartOfFile};
 
       public:
-        TokenParser(const ParserBase::Tokenizer& tokenizer, File::StringType& input, std::unordered_map<File::StringType, Section>& output)
+        TokenParser(const ParserBase::Tokenizer& tokenizer, File::StringViewType input, std::unordered_map<File::StringType, Section>& output)
             : ParserBase::TokenParser(tokenizer, input), m_output(output)
         {
         }
@@ -4,7 +4,7 @@
 
 namespace RC::Ini
 {
-    auto Parser::parse_internal(File::StringType& input) -> void
+    auto Parser::parse_internal(File::StringViewType input) -> void
     {
         // Tokenize -> START
         ParserBase::Tokenizer tokenizer;
@@ -76,15 +76,14 @@ namespace RC::Ini
         }
     }
 
-    auto Parser::parse(File::StringType& input) -> void
+    auto Parser::parse(File::StringViewType input) -> void
     {
         parse_internal(input);
     }
 
     auto Parser::parse(const File::Handle& file) -> void
     {
-        auto input = file.read_all();
-        parse_internal(input);
+        parse_internal(file.read_all_view());
     }
 
     auto Parser::get_list(const File::StringType& section) -> List
@@ -342,7 +342,7 @@ namespace RC::Parser
         }
     }
 
-    auto JSON::parse_internal(File::StringType& input) -> void
+    auto JSON::parse_internal(File::StringViewType input) -> void
     {
         Tokenizer tokenizer;
         TokenContainer tc;
@@ -362,15 +362,14 @@ namespace RC::Parser
         m_token_parser->parse();
     }
 
-    auto JSON::parse(File::StringType& input) -> void
+    auto JSON::parse(File::StringViewType input) -> void
     {
         parse_internal(input);
     }
 
     auto JSON::parse(File::Handle& file) -> void
     {
-        auto input = file.read_all();
-        parse_internal(input);
+        parse_internal(file.read_all_view());
     }
 
     auto JSON::release_contents() -> std::vector<std::unique_ptr<JSONInternal::ItemBase>>
@@ -10,6 +10,6 @@
 
 namespace RC::JSON::Parser
 {
-    RC_JSON_API auto parse(StringType& input) -> std::unique_ptr<JSON::Object>;
+    RC_JSON_API auto parse(StringViewType input) -> std::unique_ptr<JSON::Object>;
     RC_JSON_API auto parse(const File::Handle&) -> std::unique_ptr<JSON::Object>;
 } // namespace RC::JSON::Parser
@@ -115,7 +115,7 @@ namespace RC::JSON::Parser
         bool m_defer_element_creation{};
 
       public:
-        TokenParser(const ParserBase::Tokenizer& tokenizer, File::StringType& input) : ParserBase::TokenParser(tokenizer, input)
+        TokenParser(const ParserBase::Tokenizer& tokenizer, File::StringViewType input) : ParserBase::TokenParser(tokenizer, input)
         {
         }
         virtual ~TokenParser() = default;
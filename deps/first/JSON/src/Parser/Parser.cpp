@@ -30,7 +30,7 @@ namespace RC::JSON::Parser
             return tc;
         }
 
-        static auto parse_internal(File::StringType& input) -> std::unique_ptr<JSON::Object>
+        static auto parse_internal(File::StringViewType input) -> std::unique_ptr<JSON::Object>
         {
             // Tokenize -> START
             ParserBase::Tokenizer tokenizer;
@@ -52,14 +52,13 @@ namespace RC::JSON::Parser
         }
     } // namespace Internal
 
-    auto parse(File::StringType& input) -> std::unique_ptr<JSON::Object>
+    auto parse(StringViewType input) -> std::unique_ptr<JSON::Object>
     {
         return Internal::parse_internal(input);
     }
 
     auto parse(const File::Handle& file) -> std::unique_ptr<JSON::Object>
     {
-        auto input = file.read_all();
-        return Internal::parse_internal(input);
+        return Internal::parse_internal(file.read_all_view());
     }
 } // namespace RC::JSON::Parser
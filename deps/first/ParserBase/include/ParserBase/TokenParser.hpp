@@ -34,15 +34,15 @@ namespace RC::ParserBase
 
       private:
         const class Tokenizer& m_tokenizer;
-        mutable File::StringType m_data;
+        // The input is only viewed, it must outlive the parse
+        File::StringViewType m_data;
 
       protected:
         mutable size_t m_current_token_index_being_parsed{0};
         mutable size_t m_backward_token_index{0};
 
       public:
-        // Investigate whether I want to std::move the input here
-        RC_PB_API TokenParser(const class Tokenizer&, File::StringType& input);
+        RC_PB_API TokenParser(const class Tokenizer&, File::StringViewType input);
         RC_PB_API virtual ~TokenParser() = default;
 
       protected:
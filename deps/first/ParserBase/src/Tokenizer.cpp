@@ -41,7 +41,7 @@ namespace RC::ParserBase
         m_token_container = std::move(token_container);
     }
 
-    auto Tokenizer::tokenize(const File::StringType& input) -> void
+    auto Tokenizer::tokenize(File::StringViewType input) -> void
     {
         // printf_s("Tokenizer::tokenize()\n\n");
 
@@ -77,7 +77,7 @@ namespace RC::ParserBase
 
         File::StringType a;
 
-        const File::CharType* input_array = input.c_str();
+        const File::CharType* input_array = input.data();
         size_t global_cursor{};
 
         auto peek = [&](File::StringType& out_str, const File::CharType* character, size_t num_chars) -> void {
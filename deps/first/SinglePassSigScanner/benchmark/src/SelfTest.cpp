@@ -0,0 +1,446 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "SelfTest.hpp"
+
+#include <SigScanner/MultiPatternMatcher.hpp>
+#include <SigScanner/PackedSignature.hpp>
+#include <SigScanner/PeImage.hpp>
+#include <SigScanner/ScanKernel.hpp>
+#include <SigScanner/SinglePassSigScanner.hpp>
+
+using namespace RC;
+
+static size_t s_num_failures{};
+
+#define SELF_TEST_CHECK(condition, ...)                                                                                                                        \
+    if (!(condition))                                                                                                                                          \
+    {                                                                                                                                                          \
+        std::fprintf(stderr, "  FAIL: " __VA_ARGS__);                                                                                                          \
+        std::fprintf(stderr, "\n");                                                                                                                            \
+        ++s_num_failures;                                                                                                                                      \
+    }
+
+// Every kind of signature that the kernels treat differently
+static constexpr std::string_view s_signatures[] = {
+        // Anchored on fully masked bytes
+        "48 8B 05",
+        // Leading wildcards, the first byte of a candidate isn't the first byte that's compared
+        "?? ?? 48 8B",
+        // Half-byte wildcards next to fully masked bytes
+        "?? 4? 8B ?? C3",
+        // Not a single fully masked byte, so there's nothing to anchor on
+        "?8 4? ?B",
+        // A single byte
+        "C3",
+        // Longer than an AVX2 vector
+        "E8 ?? ?? ?? ?? 48 89 5C 24 08 57 48 83 EC 20 48 8B F9 E8 ?? ?? ?? ?? 48 8B 5C 24 30 48 83 C4 20 5F C3 CC CC CC CC 40 53",
+};
+
+// Not random at all, but varied enough that the signatures only match where they're planted and in a few places by chance
+static auto make_filler(size_t size, uint32_t seed) -> std::vector<uint8_t>
+{
+    std::vector<uint8_t> data(size);
+    uint32_t state = seed * 2654435761u + 1;
+    for (auto& byte : data)
+    {
+        state = state * 1664525u + 1013904223u;
+        byte = static_cast<uint8_t>(state >> 24);
+    }
+    return data;
+}
+
+// Plants as much of the signature as fits at 'offset', so a plant near the end leaves a prefix of the signature that must not match
+// Wildcards keep whatever byte was already there
+static auto plant(std::vector<uint8_t>& data, size_t offset, const PackedSignature& signature) -> void
+{
+    for (size_t i = 0; i < signature.size() && offset + i < data.size(); ++i)
+    {
+        data[offset + i] = static_cast<uint8_t>((data[offset + i] & ~signature.mask[i]) | signature.bytes[i]);
+    }
+}
+
+// The obviously correct way of finding every match, which is what every scan method is compared against
+static auto find_all_reference(const std::vector<uint8_t>& data, const PackedSignature& signature) -> std::vector<size_t>
+{
+    std::vector<size_t> offsets{};
+    for (size_t offset = 0; offset + signature.size() <= data.size(); ++offset)
+    {
+        if (signature.matches(data.data() + offset))
+        {
+            offsets.emplace_back(offset);
+        }
+    }
+    return offsets;
+}
+
+static auto get_supported_instruction_sets() -> std::vector<ScanKernel::InstructionSet>
+{
+    std::vector<ScanKernel::InstructionSet> instruction_sets{ScanKernel::InstructionSet::Scalar};
+    const auto best = ScanKernel::get_best_supported_instruction_set();
+    if (best == ScanKernel::InstructionSet::SSE2 || best == ScanKernel::InstructionSet::AVX2)
+    {
+        instruction_sets.emplace_back(ScanKernel::InstructionSet::SSE2);
+    }
+    if (best == ScanKernel::InstructionSet::AVX2)
+    {
+        instruction_sets.emplace_back(ScanKernel::InstructionSet::AVX2);
+    }
+    return instruction_sets;
+}
+
+// Every kernel must find the same first match as the reference for a signature planted at every offset of buffers around the vector sizes
+// That covers matches straddling a vector boundary, matches that end at the last byte, and prefixes that run into the end of the buffer
+static auto test_kernels() -> void
+{
+    std::printf("Kernels against the reference\n");
+
+    std::vector<size_t> sizes{};
+    for (size_t size = 0; size <= 96; ++size)
+    {
+        sizes.emplace_back(size);
+    }
+    for (size_t size : {127, 128, 129, 255, 256, 257})
+    {
+        sizes.emplace_back(size);
+    }
+
+    const auto instruction_sets = get_supported_instruction_sets();
+    for (const auto signature_text : s_signatures)
+    {
+        const auto signature = make_packed_signature(signature_text);
+        for (const auto size : sizes)
+        {
+            // An offset of 'size' plants nothing at all
+            for (size_t offset = 0; offset <= size; ++offset)
+            {
+                auto data = make_filler(size, static_cast<uint32_t>(size));
+                plant(data, offset, signature);
+
+                const auto expected_offsets = find_all_reference(data, signature);
+                const uint8_t* expected = expected_offsets.empty() ? nullptr : data.data() + expected_offsets.front();
+                for (const auto instruction_set : instruction_sets)
+                {
+                    const uint8_t* found = ScanKernel::find(data, signature, instruction_set);
+                    SELF_TEST_CHECK(found == expected,
+                                    "%s kernel, signature '%.*s', size %zu, planted at %zu: expected offset %td, found %td",
+                                    ScanKernel::instruction_set_to_string(instruction_set),
+                                    static_cast<int>(signature_text.size()),
+                                    signature_text.data(),
+                                    size,
+                                    offset,
+                                    expected ? expected - data.data() : -1,
+                                    found ? found - data.data() : -1)
+                }
+            }
+        }
+    }
+}
+
+static auto scan_method_to_string(SinglePassScanner::ScanMethod scan_method) -> const char*
+{
+    switch (scan_method)
+    {
+    case SinglePassScanner::ScanMethod::Scalar:
+        return "Scalar";
+    case SinglePassScanner::ScanMethod::StdFind:
+        return "StdFind";
+    case SinglePassScanner::ScanMethod::Simd:
+        return "Simd";
+    case SinglePassScanner::ScanMethod::MultiPattern:
+        return "MultiPattern";
+    }
+
+    return "Unknown";
+}
+
+static auto add_storing_container(std::vector<SignatureContainer>& containers, std::string_view signature) -> void
+{
+    containers.emplace_back(
+            std::vector<SignatureData>{{std::string{signature}}},
+            [](SignatureContainer&) {
+                return false;
+            },
+            [](SignatureContainer&) {},
+            true);
+}
+
+static auto get_offsets(const std::vector<uint8_t>& data, const SignatureContainer& container) -> std::vector<size_t>
+{
+    std::vector<size_t> offsets{};
+    for (const auto& result : container.get_result_store())
+    {
+        offsets.emplace_back(result.match_address - data.data());
+    }
+    return offsets;
+}
+
+// Scans 'data' for a single signature and returns the offsets of every match in the order that they were reported
+static auto scan_for_offsets(const std::vector<uint8_t>& data, std::string_view signature) -> std::vector<size_t>
+{
+    std::vector<SignatureContainer> containers{};
+    add_storing_container(containers, signature);
+    SinglePassScanner::scan(data, containers);
+    return get_offsets(data, containers.front());
+}
+
+// Every scan method must report exactly the matches of the reference, in address order, with and without the image being split into chunks
+// Signatures are planted right before the chunk boundaries, on vector boundaries, at the very end and partially past the end
+static auto test_scan_methods() -> void
+{
+    std::printf("Scan methods against the reference\n");
+
+    const auto previous_scan_method = SinglePassScanner::m_scan_method;
+    const auto previous_num_threads = SinglePassScanner::m_num_threads;
+    const auto previous_threshold = SinglePassScanner::m_multithreading_module_size_threshold;
+    const auto previous_chunk_size = SinglePassScanner::m_chunk_size;
+
+    // The smallest chunk size that the scanner allows
+    static constexpr size_t chunk_size = 0x1000;
+    static constexpr size_t image_size = 4 * chunk_size + 37;
+    SinglePassScanner::m_chunk_size = chunk_size;
+
+    for (const auto signature_text : s_signatures)
+    {
+        const auto signature = make_packed_signature(signature_text);
+        auto data = make_filler(image_size, static_cast<uint32_t>(signature.size()));
+        for (const size_t offset : {size_t{0},
+                                    size_t{15},
+                                    size_t{31},
+                                    size_t{63},
+                                    chunk_size - 2,
+                                    2 * chunk_size - 1,
+                                    3 * chunk_size - signature.size() / 2,
+                                    image_size - signature.size() - 40,
+                                    image_size - signature.size(),
+                                    image_size - 1})
+        {
+            plant(data, offset, signature);
+        }
+        const auto expected_offsets = find_all_reference(data, signature);
+
+        for (const auto scan_method : {SinglePassScanner::ScanMethod::Scalar,
+                                       SinglePassScanner::ScanMethod::StdFind,
+                                       SinglePassScanner::ScanMethod::Simd,
+                                       SinglePassScanner::ScanMethod::MultiPattern})
+        {
+            // StdFind searches for a fully masked byte, it refuses signatures that don't have one
+            if (scan_method == SinglePassScanner::ScanMethod::StdFind && !signature.has_anchor())
+            {
+                continue;
+            }
+
+            for (const uint32_t num_threads : {1u, 4u})
+            {
+                SinglePassScanner::m_scan_method = scan_method;
+                SinglePassScanner::m_num_threads = num_threads;
+                SinglePassScanner::m_multithreading_module_size_threshold = num_threads > 1 ? 0 : static_cast<uint32_t>(-1);
+
+                const auto found_offsets = scan_for_offsets(data, signature_text);
+                SELF_TEST_CHECK(found_offsets == expected_offsets,
+                                "%s with %u threads, signature '%.*s': expected %zu matches, found %zu",
+                                scan_method_to_string(scan_method),
+                                num_threads,
+                                static_cast<int>(signature_text.size()),
+                                signature_text.data(),
+                                expected_offsets.size(),
+                                found_offsets.size())
+            }
+        }
+    }
+
+    SinglePassScanner::m_scan_method = previous_scan_method;
+    SinglePassScanner::m_num_threads = previous_num_threads;
+    SinglePassScanner::m_multithreading_module_size_threshold = previous_threshold;
+    SinglePassScanner::m_chunk_size = previous_chunk_size;
+}
+
+// The matcher splits its lead bytes into groups once there are more than the SIMD kernels take, and gives up on groups past a limit
+// Every pattern gets its own lead byte so each grouping is hit, and every match must still be reported exactly once
+static auto test_lead_byte_groups() -> void
+{
+    std::printf("MultiPatternMatcher lead byte groups\n");
+
+    static constexpr size_t image_size = 0x3000 + 13;
+    const size_t max_grouped_lead_bytes = ScanKernel::max_simd_byte_set_size * MultiPatternMatcher::max_lead_byte_groups;
+    for (const size_t num_patterns : {ScanKernel::max_simd_byte_set_size, ScanKernel::max_simd_byte_set_size + 1, max_grouped_lead_bytes, max_grouped_lead_bytes + 1})
+    {
+        MultiPatternMatcher matcher{};
+        std::vector<PackedSignature> patterns{};
+        auto data = make_filler(image_size, static_cast<uint32_t>(num_patterns));
+        for (size_t i = 0; i < num_patterns; ++i)
+        {
+            char pattern_text[32]{};
+            std::snprintf(pattern_text, sizeof(pattern_text), "%02zX 5A ?? A5 %02zX", i, 255 - i);
+            patterns.emplace_back(make_packed_signature(pattern_text));
+            matcher.add_pattern(patterns.back());
+            plant(data, (i * 157) % (image_size - 4), patterns.back());
+        }
+        plant(data, image_size - 5, patterns.back());
+        matcher.build();
+
+        std::vector<std::vector<size_t>> found_offsets(num_patterns);
+        matcher.scan(data, [&](size_t pattern_index, const uint8_t* match_address) {
+            found_offsets[pattern_index].emplace_back(match_address - data.data());
+            return false;
+        });
+
+        for (size_t i = 0; i < num_patterns; ++i)
+        {
+            std::sort(found_offsets[i].begin(), found_offsets[i].end());
+            const auto expected_offsets = find_all_reference(data, patterns[i]);
+            SELF_TEST_CHECK(found_offsets[i] == expected_offsets,
+                            "%zu patterns in %zu lead byte groups, pattern %zu: expected %zu matches, found %zu",
+                            num_patterns,
+                            matcher.get_num_lead_byte_groups(),
+                            i,
+                            expected_offsets.size(),
+                            found_offsets[i].size())
+        }
+    }
+}
+
+// Signatures in UE4SS_Signatures are often copied from IDA, which writes a wildcard byte as a single '?'
+// Those must compile to the same signature as the '??' form and find the same matches, while nibble wildcards are left alone
+static auto test_normalize_signature() -> void
+{
+    std::printf("Signatures with a single '?' per wildcard byte\n");
+
+    static constexpr std::pair<std::string_view, std::string_view> cases[] = {
+            {"48 8B 05 ? ? ? ? 48 85 C0", "48 8B 05 ?? ?? ?? ?? 48 85 C0"},
+            {"? E8 ? ? ? ? ?", "?? E8 ?? ?? ?? ?? ??"},
+            {"?? 4? ?B ??", "?? 4? ?B ??"},
+            {"48\t8B\t?\tC3", "48\t8B\t??\tC3"},
+            // FName_ToString from the Final Fantasy 7 Remake config, where every '?' is one nibble
+            {"E 8/? ?/? ?/? ?/? ?/4 8/6 3/9 E/4 0/0 1/0 0/0 0", "E 8/? ?/? ?/? ?/? ?/4 8/6 3/9 E/4 0/0 1/0 0/0 0"},
+    };
+
+    for (const auto& [signature_text, expected_text] : cases)
+    {
+        const auto normalized_text = normalize_signature(signature_text);
+        SELF_TEST_CHECK(normalized_text == expected_text,
+                        "'%.*s' was normalized to '%s' instead of '%.*s'",
+                        static_cast<int>(signature_text.size()),
+                        signature_text.data(),
+                        normalized_text.c_str(),
+                        static_cast<int>(expected_text.size()),
+                        expected_text.data())
+
+        const auto expected = make_packed_signature(expected_text);
+        auto data = make_filler(0x1000, static_cast<uint32_t>(expected.size()));
+        plant(data, 0x123, expected);
+        plant(data, 0x1000 - expected.size(), expected);
+        SELF_TEST_CHECK(scan_for_offsets(data, normalized_text) == find_all_reference(data, expected),
+                        "'%.*s' doesn't find the same matches as '%.*s'",
+                        static_cast<int>(signature_text.size()),
+                        signature_text.data(),
+                        static_cast<int>(expected_text.size()),
+                        expected_text.data())
+    }
+}
+
+template <typename T>
+static auto write_at(std::vector<uint8_t>& data, size_t offset, T value) -> void
+{
+    std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+// A loaded PE image with the headers in the first page, a code section in the second page and a data section in the third
+static auto make_loaded_image() -> std::vector<uint8_t>
+{
+    static constexpr size_t nt_headers_offset = 0x80;
+    static constexpr size_t file_header_offset = nt_headers_offset + 4;
+    static constexpr size_t optional_header_offset = file_header_offset + 20;
+    static constexpr size_t size_of_optional_header = 0xF0;
+    static constexpr size_t section_headers_offset = optional_header_offset + size_of_optional_header;
+
+    std::vector<uint8_t> image(0x3000);
+    write_at<uint16_t>(image, 0, 0x5A4D);
+    write_at<uint32_t>(image, 0x3C, nt_headers_offset);
+    write_at<uint32_t>(image, nt_headers_offset, 0x00004550);
+    write_at<uint16_t>(image, file_header_offset + 2, 2);
+    write_at<uint32_t>(image, file_header_offset + 4, 0x5E1F7E57);
+    write_at<uint16_t>(image, file_header_offset + 16, size_of_optional_header);
+    write_at<uint32_t>(image, optional_header_offset + 56, static_cast<uint32_t>(image.size()));
+    write_at<uint32_t>(image, optional_header_offset + 60, 0x1000);
+
+    auto write_section = [&](size_t index, const char* name, uint32_t virtual_address, uint32_t characteristics) {
+        const size_t section_offset = section_headers_offset + index * 40;
+        std::memcpy(image.data() + section_offset, name, std::strlen(name));
+        write_at<uint32_t>(image, section_offset + 8, 0x1000);
+        write_at<uint32_t>(image, section_offset + 12, virtual_address);
+        write_at<uint32_t>(image, section_offset + 16, 0x1000);
+        write_at<uint32_t>(image, section_offset + 20, virtual_address);
+        write_at<uint32_t>(image, section_offset + 36, characteristics);
+    };
+    write_section(0, ".text", 0x1000, PeHeaders::SectionContainsCode | PeHeaders::SectionIsExecutable | PeHeaders::SectionIsReadable);
+    write_section(1, ".data", 0x2000, PeHeaders::SectionContainsInitializedData | PeHeaders::SectionIsReadable | PeHeaders::SectionIsWritable);
+
+    return image;
+}
+
+// A scan that finds nothing must not be cached, otherwise a signature that's in the wrong place would never be scanned for again
+// The first scan is a miss for both containers and stores only the container that found something
+// The second scan reloads the cache from disk, only changes the data section so the identity of the image stays the same, and plants a match of each signature in there
+// The container that was stored must be replayed and not see the new match, the container that found nothing must be scanned and see it
+static auto test_scan_cache() -> void
+{
+    std::printf("Scan cache\n");
+
+    static constexpr std::string_view found_signature = "48 8B 05 ?? ?? ?? ?? C3";
+    static constexpr std::string_view missing_signature = "DE AD ?? BE EF";
+    const auto cache_file = std::filesystem::temp_directory_path() / "SinglePassSigScannerSelfTest.bin";
+    std::filesystem::remove(cache_file);
+    SinglePassScanner::set_scan_cache_file(cache_file);
+
+    auto image = make_loaded_image();
+    plant(image, 0x1100, make_packed_signature(found_signature));
+
+    std::vector<SignatureContainer> containers{};
+    add_storing_container(containers, found_signature);
+    add_storing_container(containers, missing_signature);
+    SinglePassScanner::scan_image(image, ScanTarget::MainExe, containers);
+    SELF_TEST_CHECK(get_offsets(image, containers[0]) == std::vector<size_t>{0x1100}, "First scan: the planted signature wasn't found")
+    SELF_TEST_CHECK(get_offsets(image, containers[1]).empty(), "First scan: a signature that isn't there was found")
+    SELF_TEST_CHECK(std::filesystem::exists(cache_file), "First scan: the cache file wasn't written")
+
+    SinglePassScanner::set_scan_cache_file(cache_file);
+    plant(image, 0x2100, make_packed_signature(found_signature));
+    plant(image, 0x2200, make_packed_signature(missing_signature));
+
+    containers.clear();
+    add_storing_container(containers, found_signature);
+    add_storing_container(containers, missing_signature);
+    SinglePassScanner::scan_image(image, ScanTarget::MainExe, containers);
+    SELF_TEST_CHECK(get_offsets(image, containers[0]) == std::vector<size_t>{0x1100}, "Second scan: the stored matches weren't replayed from the cache")
+    SELF_TEST_CHECK(get_offsets(image, containers[1]) == std::vector<size_t>{0x2200}, "Second scan: a container without matches was replayed instead of scanned")
+
+    SinglePassScanner::set_scan_cache_file({});
+    std::filesystem::remove(cache_file);
+}
+
+auto run_self_tests() -> bool
+{
+    s_num_failures = 0;
+
+    test_kernels();
+    test_scan_methods();
+    test_lead_byte_groups();
+    test_normalize_signature();
+    test_scan_cache();
+
+    if (s_num_failures > 0)
+    {
+        std::printf("Self test: %zu checks failed\n", s_num_failures);
+        return false;
+    }
+
+    std::printf("Self test: OK\n");
+    return true;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+// Edge case checks for the scanner that the synthetic images of the benchmark are unlikely to hit
+// Run with 'SinglePassSigScannerBenchmark --self-test', which is also what ctest runs
+auto run_self_tests() -> bool;
@@ -0,0 +1,398 @@
+// Benchmarks every SinglePassScanner::ScanMethod against synthetic images with planted signatures
+// Every run is also checked against the planted offsets so the benchmark doubles as a regression test for the scan methods
+//
+// Usage: SinglePassSigScannerBenchmark [--sizes=64,256,512] [--threads=1,8] [--methods=Scalar,StdFind,Simd,MultiPattern] [--signatures=32] [--iterations=3]
+// Sizes are in MB, the process exits with 1 if any run found something other than the planted signatures
+// 'SinglePassSigScannerBenchmark --self-test' only runs the edge case checks from SelfTest.cpp instead of benchmarking
+// The Scalar method is left out by default because it takes minutes on the larger images
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "SelfTest.hpp"
+
+#include <SigScanner/ScanKernel.hpp>
+#include <SigScanner/SinglePassSigScanner.hpp>
+
+using namespace RC;
+
+struct Options
+{
+    std::vector<size_t> image_sizes_in_mb{64, 256, 512};
+    std::vector<uint32_t> thread_counts{};
+    std::vector<SinglePassScanner::ScanMethod> scan_methods{
+            SinglePassScanner::ScanMethod::StdFind,
+            SinglePassScanner::ScanMethod::Simd,
+            SinglePassScanner::ScanMethod::MultiPattern,
+    };
+    size_t num_signatures{32};
+    size_t num_iterations{3};
+    bool self_test{};
+};
+
+struct SyntheticImage
+{
+    std::vector<uint8_t> data{};
+    std::vector<std::string> signatures{};
+
+    // The offsets that each signature was planted at, sorted
+    std::vector<std::vector<size_t>> planted_offsets{};
+};
+
+class Random
+{
+  private:
+    uint64_t m_state;
+
+  public:
+    explicit Random(uint64_t seed) : m_state(seed)
+    {
+    }
+
+    auto next() -> uint64_t
+    {
+        // xorshift64*
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        return m_state * 0x2545F4914F6CDD1Dull;
+    }
+
+    auto next_below(uint64_t max) -> uint64_t
+    {
+        return next() % max;
+    }
+};
+
+static auto scan_method_to_string(SinglePassScanner::ScanMethod scan_method) -> const char*
+{
+    switch (scan_method)
+    {
+    case SinglePassScanner::ScanMethod::Scalar:
+        return "Scalar";
+    case SinglePassScanner::ScanMethod::StdFind:
+        return "StdFind";
+    case SinglePassScanner::ScanMethod::Simd:
+        return "Simd";
+    case SinglePassScanner::ScanMethod::MultiPattern:
+        return "MultiPattern";
+    }
+
+    return "Unknown";
+}
+
+static auto split(std::string_view list) -> std::vector<std::string_view>
+{
+    std::vector<std::string_view> parts{};
+    while (!list.empty())
+    {
+        const auto comma = list.find(',');
+        parts.emplace_back(list.substr(0, comma));
+        if (comma == std::string_view::npos)
+        {
+            break;
+        }
+        list.remove_prefix(comma + 1);
+    }
+    return parts;
+}
+
+static auto parse_options(int argc, char* argv[]) -> Options
+{
+    Options options{};
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg{argv[i]};
+        const auto equals = arg.find('=');
+        const auto name = arg.substr(0, equals);
+        const auto value = equals == std::string_view::npos ? std::string_view{} : arg.substr(equals + 1);
+
+        if (name == "--sizes")
+        {
+            options.image_sizes_in_mb.clear();
+            for (const auto part : split(value))
+            {
+                options.image_sizes_in_mb.emplace_back(std::stoull(std::string{part}));
+            }
+        }
+        else if (name == "--threads")
+        {
+            options.thread_counts.clear();
+            for (const auto part : split(value))
+            {
+                options.thread_counts.emplace_back(static_cast<uint32_t>(std::stoul(std::string{part})));
+            }
+        }
+        else if (name == "--methods")
+        {
+            options.scan_methods.clear();
+            for (const auto part : split(value))
+            {
+                if (part == "Scalar") options.scan_methods.emplace_back(SinglePassScanner::ScanMethod::Scalar);
+                else if (part == "StdFind") options.scan_methods.emplace_back(SinglePassScanner::ScanMethod::StdFind);
+                else if (part == "Simd") options.scan_methods.emplace_back(SinglePassScanner::ScanMethod::Simd);
+                else if (part == "MultiPattern") options.scan_methods.emplace_back(SinglePassScanner::ScanMethod::MultiPattern);
+                else
+                {
+                    std::fprintf(stderr, "Unknown scan method: %.*s\n", static_cast<int>(part.size()), part.data());
+                    std::exit(2);
+                }
+            }
+        }
+        else if (name == "--signatures")
+        {
+            options.num_signatures = std::stoull(std::string{value});
+        }
+        else if (name == "--iterations")
+        {
+            options.num_iterations = std::max<size_t>(1, std::stoull(std::string{value}));
+        }
+        else if (name == "--self-test")
+        {
+            options.self_test = true;
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            std::exit(2);
+        }
+    }
+
+    if (options.thread_counts.empty())
+    {
+        options.thread_counts.emplace_back(1);
+        const auto hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+        if (hardware_threads > 1)
+        {
+            options.thread_counts.emplace_back(hardware_threads);
+        }
+    }
+
+    return options;
+}
+
+static auto make_synthetic_image(size_t size, size_t num_signatures, uint64_t seed) -> SyntheticImage
+{
+    SyntheticImage image{};
+    image.data.resize(size);
+    Random random{seed};
+
+    // Roughly the byte distribution of x64 code, so that anchors aren't unrealistically rare
+    static constexpr uint8_t common_bytes[] = {0x00, 0x00, 0x00, 0x48, 0x48, 0x8B, 0x89, 0xCC, 0xCC, 0xE8, 0xFF, 0x0F, 0x45, 0x4C, 0x24, 0x83, 0xC3, 0x85, 0x74};
+    for (size_t i = 0; i < size; i += 8)
+    {
+        uint64_t bits = random.next();
+        for (size_t byte_index = 0; byte_index < 8 && i + byte_index < size; ++byte_index, bits >>= 8)
+        {
+            const uint8_t value = static_cast<uint8_t>(bits);
+            image.data[i + byte_index] = value < 128 ? common_bytes[value % sizeof(common_bytes)] : value;
+        }
+    }
+
+    // Every signature is planted in its own slot so that planted signatures never overlap each other
+    // Some slots are placed right before the boundaries that the thread ranges are split at, to catch matches that straddle two threads
+    static constexpr size_t max_signature_size = 32;
+    static constexpr size_t slot_size = 64;
+    std::vector<size_t> boundary_slots{};
+    for (size_t divisor : {2, 3, 4, 6, 8, 12, 16, 24, 32})
+    {
+        boundary_slots.emplace_back((size / divisor) - (size / divisor) % slot_size - 3);
+    }
+    std::ranges::sort(boundary_slots);
+    boundary_slots.erase(std::unique(boundary_slots.begin(), boundary_slots.end()), boundary_slots.end());
+
+    std::vector<size_t> free_slots{};
+    for (size_t slot = 1; slot + 1 < size / slot_size; ++slot)
+    {
+        const size_t offset = slot * slot_size;
+        const bool overlaps_boundary_slot = std::ranges::any_of(boundary_slots, [&](size_t boundary_slot) {
+            return offset + slot_size > boundary_slot && offset < boundary_slot + slot_size;
+        });
+        if (!overlaps_boundary_slot)
+        {
+            free_slots.emplace_back(offset);
+        }
+    }
+
+    auto take_slot = [&](size_t index) {
+        if (index < boundary_slots.size())
+        {
+            return boundary_slots[index];
+        }
+        const size_t slot_index = random.next_below(free_slots.size());
+        const size_t offset = free_slots[slot_index];
+        free_slots[slot_index] = free_slots.back();
+        free_slots.pop_back();
+        return offset;
+    };
+
+    size_t num_plants{};
+    for (size_t signature_index = 0; signature_index < num_signatures; ++signature_index)
+    {
+        const size_t signature_size = 12 + random.next_below(max_signature_size - 12 + 1);
+        std::vector<uint8_t> bytes(signature_size);
+        std::vector<uint8_t> masks(signature_size);
+        for (size_t i = 0; i < signature_size; ++i)
+        {
+            bytes[i] = static_cast<uint8_t>(random.next());
+
+            // The first byte is never a wildcard, the StdFind method doesn't support that
+            const auto roll = i == 0 ? 100 : random.next_below(100);
+            masks[i] = roll < 15 ? 0x00 : roll < 20 ? 0xF0 : roll < 25 ? 0x0F : 0xFF;
+        }
+
+        std::string signature{};
+        static constexpr char hex_digits[] = "0123456789ABCDEF";
+        for (size_t i = 0; i < signature_size; ++i)
+        {
+            if (!signature.empty())
+            {
+                signature += ' ';
+            }
+            signature += masks[i] & 0xF0 ? hex_digits[bytes[i] >> 4] : '?';
+            signature += masks[i] & 0x0F ? hex_digits[bytes[i] & 0xF] : '?';
+        }
+        image.signatures.emplace_back(std::move(signature));
+
+        // Most signatures are unique, every fourth one is planted a few times
+        auto& offsets = image.planted_offsets.emplace_back();
+        const size_t num_copies = signature_index % 4 == 0 ? 1 + random.next_below(4) : 1;
+        for (size_t copy = 0; copy < num_copies; ++copy)
+        {
+            const size_t offset = take_slot(num_plants++);
+            for (size_t i = 0; i < signature_size; ++i)
+            {
+                // Wildcards are planted with whatever byte was there, to make sure the mask is honored
+                image.data[offset + i] = (image.data[offset + i] & ~masks[i]) | (bytes[i] & masks[i]);
+            }
+            offsets.emplace_back(offset);
+        }
+        std::ranges::sort(offsets);
+    }
+
+    return image;
+}
+
+struct RunResult
+{
+    double seconds{};
+    bool passed{};
+};
+
+static auto run_scan(const SyntheticImage& image, SinglePassScanner::ScanMethod scan_method, uint32_t num_threads) -> RunResult
+{
+    SinglePassScanner::m_scan_method = scan_method;
+    SinglePassScanner::m_num_threads = num_threads;
+    SinglePassScanner::m_multithreading_module_size_threshold = num_threads > 1 ? 0 : std::numeric_limits<uint32_t>::max();
+
+    // One container per signature, and no container ever asks to stop, so every match must be reported
+    std::vector<SignatureContainer> containers{};
+    containers.reserve(image.signatures.size());
+    for (const auto& signature : image.signatures)
+    {
+        containers.emplace_back(
+                std::vector<SignatureData>{{signature}},
+                [](SignatureContainer&) {
+                    return false;
+                },
+                [](SignatureContainer&) {},
+                true);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    SinglePassScanner::scan(image.data, containers);
+    const auto end = std::chrono::steady_clock::now();
+
+    bool passed{true};
+    for (size_t i = 0; i < containers.size(); ++i)
+    {
+        std::vector<size_t> found_offsets{};
+        for (const auto& result : containers[i].get_result_store())
+        {
+            found_offsets.emplace_back(result.match_address - image.data.data());
+        }
+
+        // The scanner guarantees that matches are reported in address order, regardless of the number of threads
+        if (!std::ranges::is_sorted(found_offsets))
+        {
+            std::fprintf(stderr, "  %s with %u threads: signature %zu was not reported in address order\n", scan_method_to_string(scan_method), num_threads, i);
+            passed = false;
+            std::ranges::sort(found_offsets);
+        }
+
+        if (found_offsets != image.planted_offsets[i])
+        {
+            std::fprintf(stderr,
+                         "  %s with %u threads: signature %zu was expected %zu times but was found %zu times\n",
+                         scan_method_to_string(scan_method),
+                         num_threads,
+                         i,
+                         image.planted_offsets[i].size(),
+                         found_offsets.size());
+            passed = false;
+        }
+    }
+
+    return {std::chrono::duration<double>(end - start).count(), passed};
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    const auto options = parse_options(argc, argv);
+
+    std::printf("SIMD instruction set: %s\n", ScanKernel::instruction_set_to_string(ScanKernel::get_instruction_set()));
+
+    if (options.self_test)
+    {
+        return run_self_tests() ? 0 : 1;
+    }
+
+    bool all_passed{true};
+    for (const auto image_size_in_mb : options.image_sizes_in_mb)
+    {
+        const auto image = make_synthetic_image(image_size_in_mb * 1024 * 1024, options.num_signatures, 0x5EED0000 + image_size_in_mb);
+
+        size_t num_planted{};
+        for (const auto& offsets : image.planted_offsets)
+        {
+            num_planted += offsets.size();
+        }
+
+        std::printf("\nImage: %zu MB, %zu signatures, %zu planted matches\n", image_size_in_mb, image.signatures.size(), num_planted);
+        std::printf("%-14s %8s %12s %10s %8s\n", "Method", "Threads", "Best (ms)", "GB/s", "Check");
+
+        for (const auto scan_method : options.scan_methods)
+        {
+            for (const auto num_threads : options.thread_counts)
+            {
+                double best_seconds{std::numeric_limits<double>::max()};
+                bool passed{true};
+                for (size_t iteration = 0; iteration < options.num_iterations; ++iteration)
+                {
+                    const auto result = run_scan(image, scan_method, num_threads);
+                    best_seconds = std::min(best_seconds, result.seconds);
+                    passed = passed && result.passed;
+                }
+                all_passed = all_passed && passed;
+
+                std::printf("%-14s %8u %12.2f %10.2f %8s\n",
+                            scan_method_to_string(scan_method),
+                            num_threads,
+                            best_seconds * 1000.0,
+                            static_cast<double>(image.data.size()) / best_seconds / 1e9,
+                            passed ? "OK" : "FAIL");
+                std::fflush(stdout);
+            }
+        }
+    }
+
+    return all_passed ? 0 : 1;
+}
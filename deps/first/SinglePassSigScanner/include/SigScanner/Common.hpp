@@ -1,5 +1,12 @@
 #pragma once
 
+// __declspec only exists on Windows, the portable parts of the scanner are also built elsewhere (see benchmark/CMakeLists.txt)
+#ifndef _WIN32
+#ifndef RC_SPSS_API
+#define RC_SPSS_API
+#endif
+#endif
+
 #ifndef RC_SINGLE_PASS_SIG_SCANNER_EXPORTS
 #ifndef RC_SINGLE_PASS_SIG_SCANNER_BUILD_STATIC
 #ifndef RC_SPSS_API
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include <SigScanner/Common.hpp>
+#include <SigScanner/PackedSignature.hpp>
+#include <SigScanner/ScanKernel.hpp>
+
+namespace RC
+{
+    // Matches any number of signatures in a single pass over memory
+    // Every signature is put into a bucket keyed by an anchor, preferably two consecutive fully masked bytes
+    // The scan looks for the first byte of any anchor with the SIMD kernels, checks the byte pair against a 64K-bit filter,
+    // and only then compares the signatures in the matching bucket
+    // Signatures without any fully masked bytes are compared at every offset, avoid them if possible
+    // The SIMD kernels only take 16 lead bytes at a time, so with more anchors the lead bytes are split into groups and each group gets its own pass
+    // Past 'max_lead_byte_groups' groups a single pass with a lookup per byte is faster than the extra passes, so that's used instead
+    class RC_SPSS_API MultiPatternMatcher
+    {
+      public:
+        // Called for every match, return true to stop the scan
+        // Matches are reported in the order that their anchors are found in, which isn't necessarily the order of their addresses
+        using OnMatchFound = std::function<bool(size_t pattern_index, const uint8_t* match_address)>;
+
+      public:
+        static constexpr size_t max_lead_byte_groups = 3;
+
+      private:
+        struct BucketEntry
+        {
+            uint32_t pattern_index{};
+            uint32_t anchor_offset{};
+        };
+
+      private:
+        std::vector<PackedSignature> m_patterns{};
+        std::vector<ScanKernel::ByteSet> m_lead_byte_groups{};
+        std::vector<uint64_t> m_pair_filter{};
+        std::vector<uint32_t> m_pair_bucket_starts{};
+        std::vector<BucketEntry> m_pair_entries{};
+        std::array<std::vector<BucketEntry>, 256> m_byte_buckets{};
+        std::vector<uint32_t> m_unanchored_patterns{};
+        size_t m_max_pattern_size{};
+        bool m_is_built{};
+
+      public:
+        // Returns the index that will be passed to the match callback for this pattern
+        auto add_pattern(PackedSignature pattern) -> size_t;
+
+        // Must be called after all patterns have been added and before 'scan' is called
+        // The anchors are picked with 'byte_frequencies' if it's provided, see 'choose_rarest_anchors'
+        auto build(const ByteFrequencies* byte_frequencies = nullptr) -> void;
+
+        // Reports every match that fits entirely inside 'data'
+        // Safe to call from multiple threads at the same time once 'build' has been called
+        // Returns true if the callback stopped the scan
+        auto scan(std::span<const uint8_t> data, const OnMatchFound& on_match_found) const -> bool;
+
+        [[nodiscard]] auto get_patterns() const -> const std::vector<PackedSignature>&
+        {
+            return m_patterns;
+        }
+
+        [[nodiscard]] auto get_max_pattern_size() const -> size_t
+        {
+            return m_max_pattern_size;
+        }
+
+        // The number of passes that 'scan' makes over the data, not counting the pass for patterns without anchors
+        [[nodiscard]] auto get_num_lead_byte_groups() const -> size_t
+        {
+            return m_lead_byte_groups.size();
+        }
+    };
+} // namespace RC
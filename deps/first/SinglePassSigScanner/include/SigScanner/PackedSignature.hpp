@@ -0,0 +1,164 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <SigScanner/Common.hpp>
+
+namespace RC
+{
+    // A signature that has been compiled from its textual form ("48 8B ?? 05" or "4 8/8 B/? ?/0 5") into a byte/mask pair
+    // A mask of 0xFF means the whole byte must match, 0x00 is a full wildcard and 0xF0/0x0F are half-byte wildcards
+    // The bytes are stored pre-masked so that '(memory & mask) == bytes' is all that's required to compare a byte
+    struct RC_SPSS_API PackedSignature
+    {
+        static constexpr size_t NoAnchor = static_cast<size_t>(-1);
+
+        std::vector<uint8_t> bytes{};
+        std::vector<uint8_t> mask{};
+
+        // Offsets of two fully masked bytes that the kernels look for before comparing the entire signature
+        // Both are 'NoAnchor' if the signature doesn't contain a single fully masked byte
+        // If the signature only contains one fully masked byte then both offsets are the same
+        // The offsets can be in either order, see 'choose_rarest_anchors'
+        size_t anchor_offset{NoAnchor};
+        size_t second_anchor_offset{NoAnchor};
+
+        [[nodiscard]] auto size() const -> size_t
+        {
+            return bytes.size();
+        }
+
+        [[nodiscard]] auto empty() const -> bool
+        {
+            return bytes.empty();
+        }
+
+        [[nodiscard]] auto has_anchor() const -> bool
+        {
+            return anchor_offset != NoAnchor;
+        }
+
+        // Compares the signature against memory, 'data' must point to at least 'size()' readable bytes
+        [[nodiscard]] auto matches(const uint8_t* data) const -> bool
+        {
+            for (size_t i = 0; i < bytes.size(); ++i)
+            {
+                if ((data[i] & mask[i]) != bytes[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    // Shared by 'make_packed_signature' and 'SignatureLiteral' so that signatures compiled at runtime and at compile time are identical
+    namespace Internal
+    {
+        constexpr auto hex_char_to_nibble(char ch) -> int
+        {
+            if (ch >= '0' && ch <= '9') return ch - '0';
+            if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+            if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+            return -1;
+        }
+
+        // Calls 'on_byte(byte, mask)' for every byte of a textual signature, see 'make_packed_signature' for the format
+        // Returns false if the signature contains an odd number of nibbles
+        template <typename OnByte>
+        constexpr auto for_each_signature_byte(std::string_view signature, OnByte&& on_byte) -> bool
+        {
+            uint8_t current_byte{};
+            uint8_t current_mask{};
+            bool is_high_nibble{true};
+
+            for (const char symbol : signature)
+            {
+                int nibble{};
+                if (symbol == '?')
+                {
+                    nibble = -1;
+                }
+                else
+                {
+                    nibble = hex_char_to_nibble(symbol);
+                    if (nibble == -1)
+                    {
+                        // Spaces and slashes are only there for readability
+                        continue;
+                    }
+                }
+
+                const uint8_t nibble_value = nibble == -1 ? 0x0 : static_cast<uint8_t>(nibble);
+                const uint8_t nibble_mask = nibble == -1 ? 0x0 : 0xF;
+
+                if (is_high_nibble)
+                {
+                    current_byte = static_cast<uint8_t>(nibble_value << 4);
+                    current_mask = static_cast<uint8_t>(nibble_mask << 4);
+                }
+                else
+                {
+                    on_byte(static_cast<uint8_t>(current_byte | nibble_value), static_cast<uint8_t>(current_mask | nibble_mask));
+                }
+
+                is_high_nibble = !is_high_nibble;
+            }
+
+            return is_high_nibble;
+        }
+
+        // The first and last fully masked bytes are used as anchors
+        // Two bytes that are far apart are less likely to both match by chance than two neighboring bytes
+        constexpr auto find_default_anchors(std::span<const uint8_t> mask) -> std::pair<size_t, size_t>
+        {
+            std::pair<size_t, size_t> anchors{PackedSignature::NoAnchor, PackedSignature::NoAnchor};
+            for (size_t i = 0; i < mask.size(); ++i)
+            {
+                if (mask[i] != 0xFF)
+                {
+                    continue;
+                }
+
+                if (anchors.first == PackedSignature::NoAnchor)
+                {
+                    anchors.first = i;
+                }
+                anchors.second = i;
+            }
+            return anchors;
+        }
+    } // namespace Internal
+
+    // How often every byte value occurs in the memory that's about to be scanned
+    // Used to anchor signatures on the bytes that are least likely to show up by chance, 'E8' and '48' are everywhere in x64 code
+    using ByteFrequencies = std::array<uint64_t, 256>;
+
+    // Adds the bytes of 'data' to 'byte_frequencies'
+    RC_SPSS_API auto count_byte_frequencies(std::span<const uint8_t> data, ByteFrequencies& byte_frequencies) -> void;
+
+    // Makes the two least common fully masked bytes of the signature its anchors, the rarest one becomes 'anchor_offset'
+    // Signatures without any fully masked bytes are left unchanged
+    RC_SPSS_API auto choose_rarest_anchors(PackedSignature& signature, const ByteFrequencies& byte_frequencies) -> void;
+
+    // Expands every '?' that isn't next to another nibble into '??', which is how signatures copied from IDA write a wildcard byte
+    // 'make_packed_signature' reads every '?' as a single nibble, so run signatures from users through this first
+    // Signatures in the 'E 8/? ?/...' format, where every nibble is written on its own, are returned as is
+    RC_SPSS_API auto normalize_signature(std::string_view signature) -> std::string;
+
+    // Compiles a textual signature into a byte/mask pair
+    // Every hex digit or '?' is one nibble, everything else (spaces, slashes) is ignored
+    // This is identical to how the scalar scanner has always interpreted signatures
+    // Throws std::runtime_error if the signature is empty or contains an odd number of nibbles
+    RC_SPSS_API auto make_packed_signature(std::string_view signature) -> PackedSignature;
+
+    // Makes a signature that matches exactly these bytes, without any wildcards
+    // Throws std::runtime_error if 'bytes' is empty
+    RC_SPSS_API auto make_exact_signature(std::span<const uint8_t> bytes) -> PackedSignature;
+} // namespace RC
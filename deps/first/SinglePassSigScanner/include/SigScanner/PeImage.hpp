@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <SigScanner/Common.hpp>
+
+namespace RC
+{
+    // The parts of a PE image header that the scanner cares about
+    // Parsed by hand so that it works the same for loaded modules and for files that were read from disk on any platform
+    struct RC_SPSS_API PeSection
+    {
+        std::string name{};
+        uint32_t virtual_address{};
+        uint32_t virtual_size{};
+        uint32_t raw_data_offset{};
+        uint32_t raw_data_size{};
+        uint32_t characteristics{};
+    };
+
+    struct RC_SPSS_API PeHeaders
+    {
+        static constexpr uint32_t SectionContainsCode = 0x00000020;
+        static constexpr uint32_t SectionContainsInitializedData = 0x00000040;
+        static constexpr uint32_t SectionIsExecutable = 0x20000000;
+        static constexpr uint32_t SectionIsReadable = 0x40000000;
+        static constexpr uint32_t SectionIsWritable = 0x80000000;
+
+        uint32_t time_date_stamp{};
+        uint32_t size_of_image{};
+        uint32_t size_of_headers{};
+        std::vector<PeSection> sections{};
+
+        // Returns nullptr if there's no section with this name
+        [[nodiscard]] auto find_section(std::string_view name) const -> const PeSection*;
+
+        // Translates between offsets into the file on disk and RVAs, which is where the same bytes are once the image has been loaded
+        // Both return an empty optional if the offset isn't inside the headers or the raw data of a section
+        [[nodiscard]] auto file_offset_to_rva(uint32_t file_offset) const -> std::optional<uint32_t>;
+        [[nodiscard]] auto rva_to_file_offset(uint32_t rva) const -> std::optional<uint32_t>;
+    };
+
+    // 'data' must start with the DOS header, the headers are laid out the same way in memory and on disk
+    // Throws std::runtime_error if 'data' doesn't contain valid PE headers
+    RC_SPSS_API auto parse_pe_headers(std::span<const uint8_t> data) -> PeHeaders;
+
+    // A fast non-cryptographic 64-bit hash, used to tell whether the code of a module has changed
+    RC_SPSS_API auto hash_bytes(std::span<const uint8_t> data) -> uint64_t;
+} // namespace RC
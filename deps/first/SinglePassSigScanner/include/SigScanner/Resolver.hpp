@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include <SigScanner/Common.hpp>
+#include <SigScanner/PackedSignature.hpp>
+
+namespace RC
+{
+    // Turns the address of a match into the address that was actually being looked for, without calling into a scripting language
+    // A resolver is a list of steps separated by ';' or newlines, each step works on the address that the previous step produced:
+    //   add <n>, sub <n>      Moves the address, <n> is either decimal or hex with a '0x' prefix
+    //   deref                 Reads a pointer from the address
+    //   rip <offset> <size>   Resolves a RIP-relative operand, the result is address + <size> + the int32 at address + <offset>
+    //   call                  Follows the E8 call at the address
+    //   jmp                   Follows the E9 or EB jmp at the address
+    //   expect <signature>    Fails unless the bytes at the address match the signature, wildcards are allowed
+    // For example "rip 3 7" for a 'lea rcx, [rip + x]' at the start of the match, or "call; expect 48 89 5C 24" for a call to a known function
+    class RC_SPSS_API Resolver
+    {
+      public:
+        // Returns true if 'size' bytes at 'address' can be read, this keeps a resolver from crashing on a match that isn't what it expected
+        using IsReadable = std::function<bool(const uint8_t* address, size_t size)>;
+
+      private:
+        enum class Operation
+        {
+            Add,
+            Deref,
+            RipRelative,
+            Call,
+            Jmp,
+            Expect,
+        };
+
+        struct Step
+        {
+            Operation operation{};
+            int64_t value{};
+            int64_t instruction_size{};
+            PackedSignature expected_bytes{};
+        };
+
+      private:
+        std::vector<Step> m_steps{};
+
+      public:
+        // Throws std::runtime_error if 'text' isn't a valid resolver, the message contains the step that's wrong
+        // An empty resolver returns the match address as-is
+        static auto parse(std::string_view text) -> Resolver;
+
+        // Returns nullptr if a step fails, for example because it reads memory that isn't readable or because an 'expect' step doesn't match
+        // Every read is checked with 'is_readable' first unless it's empty
+        [[nodiscard]] auto resolve(uint8_t* match_address, const IsReadable& is_readable = {}) const -> uint8_t*;
+
+        [[nodiscard]] auto empty() const -> bool
+        {
+            return m_steps.empty();
+        }
+    };
+} // namespace RC
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <SigScanner/Common.hpp>
+
+namespace RC
+{
+    // Identifies one specific build of a module
+    // The hash of the code makes sure that a patched executable with an unchanged timestamp isn't mistaken for the old one
+    struct RC_SPSS_API ModuleIdentity
+    {
+        uint32_t time_date_stamp{};
+        uint32_t size_of_image{};
+        uint64_t code_hash{};
+
+        auto operator==(const ModuleIdentity&) const -> bool = default;
+    };
+
+    // Returns true if 'size' bytes starting at 'address' can be read
+    using IsReadable = std::function<bool(const uint8_t* address, size_t size)>;
+
+    // Computes the identity of a module that has been loaded at 'image_base'
+    // Nothing is read before 'is_readable' has confirmed that it can be, the headers and every code section must be readable
+    // Throws std::runtime_error if 'image_base' is null, the module doesn't have valid PE headers, or any of it can't be read
+    RC_SPSS_API auto make_module_identity(const uint8_t* image_base, const IsReadable& is_readable) -> ModuleIdentity;
+
+    struct RC_SPSS_API CachedMatch
+    {
+        uint32_t signature_index{};
+
+        // Relative to the start of the module
+        uint32_t offset{};
+    };
+
+    // Scan results that are kept on disk between launches, see 'SinglePassScanner::set_scan_cache_file'
+    // Results are stored per module and per set of signatures, and are thrown away as soon as the identity of their module changes
+    class RC_SPSS_API ScanCache
+    {
+      private:
+        struct ModuleEntry
+        {
+            ModuleIdentity identity{};
+
+            // Keyed by a hash of the signatures of a container
+            std::unordered_map<uint64_t, std::vector<CachedMatch>> matches{};
+        };
+
+        // Keyed by ScanTarget
+        std::unordered_map<uint32_t, ModuleEntry> m_modules{};
+
+      public:
+        // Replaces everything in the cache with the contents of the file
+        // Returns false and leaves the cache empty if the file doesn't exist, is from a different version, or is damaged
+        auto load(const std::filesystem::path& cache_file) -> bool;
+
+        // Throws std::runtime_error if the file can't be written
+        auto save(const std::filesystem::path& cache_file) const -> void;
+
+        // Returns nullptr if there are no results for these signatures in this build of the module
+        [[nodiscard]] auto find(uint32_t scan_target, const ModuleIdentity& identity, uint64_t signatures_key) const -> const std::vector<CachedMatch>*;
+
+        // Also throws away all results for the module that were stored for a different identity
+        auto store(uint32_t scan_target, const ModuleIdentity& identity, uint64_t signatures_key, std::vector<CachedMatch> matches) -> void;
+    };
+} // namespace RC
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <SigScanner/Common.hpp>
+#include <SigScanner/PackedSignature.hpp>
+
+namespace RC::ScanKernel
+{
+    // The instruction sets that the kernels are implemented for
+    // The best one supported by the CPU is selected at runtime the first time a kernel is used
+    enum class InstructionSet
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+    };
+
+    // A set of byte values, used to search for any one of several bytes in a single pass
+    class ByteSet
+    {
+      private:
+        std::array<uint64_t, 4> m_bits{};
+        std::vector<uint8_t> m_values{};
+
+      public:
+        auto add(uint8_t value) -> void
+        {
+            if (!contains(value))
+            {
+                m_bits[value >> 6] |= 1ull << (value & 63);
+                m_values.push_back(value);
+            }
+        }
+
+        [[nodiscard]] auto contains(uint8_t value) const -> bool
+        {
+            return m_bits[value >> 6] & (1ull << (value & 63));
+        }
+
+        [[nodiscard]] auto get_values() const -> const std::vector<uint8_t>&
+        {
+            return m_values;
+        }
+
+        [[nodiscard]] auto empty() const -> bool
+        {
+            return m_values.empty();
+        }
+    };
+
+    RC_SPSS_API auto instruction_set_to_string(InstructionSet instruction_set) -> const char*;
+
+    // Returns the best instruction set that is supported by both the CPU and the OS
+    RC_SPSS_API auto get_best_supported_instruction_set() -> InstructionSet;
+
+    // Returns the instruction set that 'find' is currently using
+    RC_SPSS_API auto get_instruction_set() -> InstructionSet;
+
+    // Overrides the instruction set that 'find' uses, mostly useful for testing and benchmarking
+    // If the requested instruction set isn't supported then the best supported one is used instead
+    RC_SPSS_API auto set_instruction_set(InstructionSet instruction_set) -> void;
+
+    // Returns the address of the first match in 'data', or nullptr if there are no matches
+    // Only matches that fit entirely inside 'data' are considered
+    RC_SPSS_API auto find(std::span<const uint8_t> data, const PackedSignature& signature) -> const uint8_t*;
+
+    // Same as above but with an explicit instruction set instead of the currently selected one
+    RC_SPSS_API auto find(std::span<const uint8_t> data, const PackedSignature& signature, InstructionSet instruction_set) -> const uint8_t*;
+
+    // Returns the address of the first byte in 'data' that's part of 'bytes', or nullptr if there is no such byte
+    // Sets of up to 'max_simd_byte_set_size' bytes are compared 16/32 bytes at a time, larger sets fall back to a lookup per byte
+    constexpr size_t max_simd_byte_set_size = 16;
+    RC_SPSS_API auto find_first_of(std::span<const uint8_t> data, const ByteSet& bytes) -> const uint8_t*;
+} // namespace RC::ScanKernel
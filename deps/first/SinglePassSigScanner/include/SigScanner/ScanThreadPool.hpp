@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <SigScanner/Common.hpp>
+
+namespace RC
+{
+    // A persistent pool of threads that the scanner hands its chunks of work to
+    // Each thread has its own queue of tasks and steals from the back of the other queues once its own queue is empty,
+    // which keeps every thread busy until the very end even if some tasks take much longer than others
+    class RC_SPSS_API ScanThreadPool
+    {
+      public:
+        using Task = std::function<void(size_t task_index)>;
+
+      private:
+        struct TaskQueue
+        {
+            std::mutex mutex{};
+            std::deque<size_t> task_indices{};
+        };
+
+      private:
+        // The thread that calls 'run' works on the first queue, the pool threads work on the rest
+        std::vector<std::unique_ptr<TaskQueue>> m_queues{};
+        std::vector<std::thread> m_threads{};
+
+        std::mutex m_run_mutex{};
+        std::mutex m_state_mutex{};
+        std::condition_variable m_work_available{};
+        std::condition_variable m_work_finished{};
+        const Task* m_task{};
+        uint64_t m_generation{};
+        size_t m_num_active_threads{};
+        std::atomic<size_t> m_num_remaining_tasks{};
+        std::exception_ptr m_exception{};
+        bool m_is_stopping{};
+
+      public:
+        // 'num_threads' includes the thread that calls 'run', so a pool with one thread doesn't start any threads
+        explicit ScanThreadPool(uint32_t num_threads);
+        ~ScanThreadPool();
+
+        ScanThreadPool(const ScanThreadPool&) = delete;
+        auto operator=(const ScanThreadPool&) -> ScanThreadPool& = delete;
+
+      public:
+        // Calls 'task' once for every index in [0, num_tasks) and returns once all of them have finished
+        // Neighbouring indices are handed to the same thread where possible, so tasks should be ordered by address
+        // If a task throws then the remaining tasks still run and the first exception is rethrown from here
+        auto run(size_t num_tasks, const Task& task) -> void;
+
+        [[nodiscard]] auto get_num_threads() const -> uint32_t
+        {
+            return static_cast<uint32_t>(m_queues.size());
+        }
+
+      private:
+        auto thread_main(size_t queue_index) -> void;
+        auto work_until_out_of_tasks(size_t queue_index, const Task& task) -> void;
+        auto pop_task(size_t queue_index, size_t& task_index) -> bool;
+    };
+} // namespace RC
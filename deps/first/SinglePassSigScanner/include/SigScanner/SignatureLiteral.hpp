@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+#include <SigScanner/PackedSignature.hpp>
+
+namespace RC
+{
+    // A signature that's compiled into its byte/mask form at compile time, meant for signatures that are known when UE4SS is built
+    // constexpr SignatureLiteral signature{"48 8B 0D ?? ?? ?? ?? 48 85 C9"};
+    // The format, bytes, masks and anchors are identical to what 'make_packed_signature' produces at runtime
+    // A signature that isn't valid is a compile error instead of an exception in the middle of a scan
+    template <size_t NumChars>
+    class SignatureLiteral
+    {
+      private:
+        // Every byte takes at least two characters, so this is always large enough
+        static constexpr size_t MaxSize = NumChars / 2;
+
+        std::array<char, NumChars> m_text{};
+        std::array<uint8_t, MaxSize> m_bytes{};
+        std::array<uint8_t, MaxSize> m_mask{};
+        size_t m_size{};
+        size_t m_anchor_offset{PackedSignature::NoAnchor};
+        size_t m_second_anchor_offset{PackedSignature::NoAnchor};
+
+      public:
+        consteval SignatureLiteral(const char (&signature)[NumChars])
+        {
+            for (size_t i = 0; i < NumChars; ++i)
+            {
+                m_text[i] = signature[i];
+            }
+
+            const bool has_whole_bytes = Internal::for_each_signature_byte(get_text(), [this](uint8_t byte, uint8_t mask) {
+                m_bytes[m_size] = byte;
+                m_mask[m_size] = mask;
+                ++m_size;
+            });
+
+            // Not constant expressions, so these are reported by the compiler
+            if (!has_whole_bytes)
+            {
+                throw std::runtime_error{"[SignatureLiteral] The signature contains an odd number of nibbles."};
+            }
+            if (m_size == 0)
+            {
+                throw std::runtime_error{"[SignatureLiteral] The signature is empty."};
+            }
+
+            const auto anchors = Internal::find_default_anchors(get_mask());
+            m_anchor_offset = anchors.first;
+            m_second_anchor_offset = anchors.second;
+        }
+
+      public:
+        [[nodiscard]] constexpr auto get_text() const -> std::string_view
+        {
+            return {m_text.data(), NumChars - 1};
+        }
+
+        [[nodiscard]] constexpr auto size() const -> size_t
+        {
+            return m_size;
+        }
+
+        [[nodiscard]] constexpr auto get_bytes() const -> std::span<const uint8_t>
+        {
+            return {m_bytes.data(), m_size};
+        }
+
+        [[nodiscard]] constexpr auto get_mask() const -> std::span<const uint8_t>
+        {
+            return {m_mask.data(), m_size};
+        }
+
+        // Copies the precompiled bytes, nothing is parsed
+        [[nodiscard]] auto to_packed_signature() const -> PackedSignature
+        {
+            PackedSignature packed_signature{};
+            packed_signature.bytes.assign(m_bytes.begin(), m_bytes.begin() + m_size);
+            packed_signature.mask.assign(m_mask.begin(), m_mask.begin() + m_size);
+            packed_signature.anchor_offset = m_anchor_offset;
+            packed_signature.second_anchor_offset = m_second_anchor_offset;
+            return packed_signature;
+        }
+    };
+} // namespace RC
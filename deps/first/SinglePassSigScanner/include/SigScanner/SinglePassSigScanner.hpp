@@ -1,11 +1,24 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <SigScanner/Common.hpp>
+#include <SigScanner/PackedSignature.hpp>
+#include <SigScanner/PeImage.hpp>
+#include <SigScanner/ScanCache.hpp>
+#include <SigScanner/SignatureLiteral.hpp>
 
 #define HI_NIBBLE(b) (((b) >> 4) & 0x0F)
 #define LO_NIBBLE(b) ((b)&0x0F)
@@ -202,6 +215,25 @@ namespace RC
         uint8_t* match_address{};
     };
 
+    // A range of committed & readable memory
+    struct RC_SPSS_API ScanRegion
+    {
+        uint8_t* start_address{};
+        uint8_t* end_address{};
+    };
+
+    // The parts of a module that a container is scanned for in
+    // Restricting a container to the sections that its signatures can be in avoids scanning the rest of the module for it
+    enum class ScanSection
+    {
+        // Every committed & readable page of the module
+        All,
+        // Executable sections such as .text, where every signature of an instruction is
+        Code,
+        // Read-only data sections such as .rdata, where string literals and vtables are
+        ReadOnlyData,
+    };
+
     struct RC_SPSS_API SignatureData
     {
         std::string signature{};
@@ -214,8 +246,19 @@ namespace RC
 
         // A mask that's used for the StdFind scanning method.
         std::string mask{};
+
+        // The compiled form of 'signature' that the Simd and MultiPattern methods scan with
+        // Filled in by 'make_signature_data', or from 'signature' the first time that it's scanned for if it's empty
+        PackedSignature packed_signature{};
     };
 
+    // Makes a signature that never has to be parsed at runtime
+    template <size_t NumChars>
+    auto make_signature_data(const SignatureLiteral<NumChars>& signature, int32_t custom_data = 0) -> SignatureData
+    {
+        return SignatureData{.signature = std::string{signature.get_text()}, .custom_data = custom_data, .packed_signature = signature.to_packed_signature()};
+    }
+
     class SignatureContainer
     {
       private:
@@ -233,6 +276,9 @@ namespace RC
         // Whether to store the results and pass them to on_scan_completed
         const bool store_results{};
 
+        // The sections of the module to scan for this container, sections of a module are only known when scanning a loaded module
+        const ScanSection scan_section{ScanSection::All};
+
         // The scanner will store results in here if 'store_results' is true
         std::vector<SignatureContainerLight> result_store{};
 
@@ -252,6 +298,11 @@ namespace RC
         // The scanner will set this to the size of the signature that was matched
         size_t match_signature_size{};
 
+        // Used by the scan cache, see 'SinglePassScanner::set_scan_cache_file'
+        uint64_t signatures_key{};
+        bool was_replayed_from_cache{};
+        std::vector<SignatureContainerLight> dispatched_matches{};
+
       public:
         template <typename OnMatchFound, typename OnScanFinished>
         SignatureContainer(std::vector<SignatureData> sig_param, OnMatchFound on_match_found_param, OnScanFinished on_scan_finished_param)
@@ -265,6 +316,17 @@ namespace RC
         {
         }
 
+        template <typename OnMatchFound, typename OnScanFinished>
+        SignatureContainer(std::vector<SignatureData> sig_param,
+                           OnMatchFound on_match_found_param,
+                           OnScanFinished on_scan_finished_param,
+                           bool store_results_param,
+                           ScanSection scan_section_param)
+            : signatures(std::move(sig_param)), on_match_found(on_match_found_param), on_scan_finished(on_scan_finished_param), store_results(store_results_param),
+              scan_section(scan_section_param)
+        {
+        }
+
       public:
         [[nodiscard]] auto get_match_address() const -> uint8_t*
         {
@@ -294,8 +356,36 @@ namespace RC
         {
             return match_signature_size;
         }
+        [[nodiscard]] auto get_scan_section() const -> ScanSection
+        {
+            return scan_section;
+        }
+        [[nodiscard]] auto is_ignored() const -> bool
+        {
+            return ignore;
+        }
+    };
+
+    struct RC_SPSS_API ModuleScanStats
+    {
+        ScanTarget scan_target{};
+
+        // Everything below is summed over every scan of the module
+        size_t num_scans{};
+        size_t num_bytes_scanned{};
+
+        // Bytes that didn't have to be scanned because every container had already found what it was looking for
+        size_t num_bytes_avoided{};
+
+        // The time spent scanning the module summed over every thread that worked on it, can be larger than 'wall_time'
+        std::chrono::nanoseconds scan_time{};
+
+        // From the first chunk of the module starting to the last chunk of the module finishing
+        std::chrono::nanoseconds wall_time{};
     };
 
+    class ScanThreadPool;
+
     class SinglePassScanner
     {
       private:
@@ -306,6 +396,10 @@ namespace RC
         {
             Scalar,
             StdFind,
+            // Uses the SSE2/AVX2 kernels from 'ScanKernel', the instruction set is picked at runtime
+            Simd,
+            // Matches all signatures of all containers in a single pass over memory, see 'MultiPatternMatcher'
+            MultiPattern,
         };
 
       public:
@@ -316,16 +410,212 @@ namespace RC
         // Smaller modules might increase the cost of scanning due to the cost of creating threads
         RC_SPSS_API static uint32_t m_multithreading_module_size_threshold;
 
+        // The size of each piece of work that the thread pool hands out when multi-threading is enabled
+        // Smaller chunks balance better between threads, larger chunks have less overhead per chunk
+        RC_SPSS_API static uint32_t m_chunk_size;
+
       private:
         RC_SPSS_API auto static string_to_vector(std::string_view signature) -> std::vector<int>;
         RC_SPSS_API auto static string_to_vector(const std::vector<SignatureData>& signatures) -> std::vector<std::vector<int>>;
         RC_SPSS_API auto static format_aob_strings(std::vector<SignatureContainer>& signature_containers) -> void;
 
+        // Compiles every signature that doesn't already have a packed form, signatures made with 'make_signature_data' are left alone
+        auto static pack_signatures(std::vector<SignatureContainer>& signature_containers) -> void;
+
+        // Forwards a match to the container, returns true if the container doesn't want any more matches
+        // Must not be called from more than one thread at a time for the same containers
+        auto static dispatch_match(SignatureContainer& container, size_t signature_index, uint8_t* match_address, size_t match_size) -> bool;
+
+        // A match that was found while scanning a chunk, matches are buffered per chunk and dispatched once every chunk has been scanned
+        struct ChunkMatch
+        {
+            uint8_t* match_address{};
+            size_t container_index{};
+            size_t signature_index{};
+            size_t match_size{};
+        };
+        using ChunkMatches = std::vector<ChunkMatch>;
+
+        // Shared by every thread that scans a job, tells the threads which containers don't want any more matches
+        // The scan methods stop scanning for a container as soon as its token is set, and stop scanning entirely once every token is set
+        struct ScanCancellation
+        {
+            // One token per container, indexed the same way as the containers
+            std::unique_ptr<std::atomic<bool>[]> is_container_done{};
+            std::atomic<size_t> num_containers_left{};
+
+            [[nodiscard]] auto is_done(size_t container_index) const -> bool
+            {
+                return is_container_done[container_index].load(std::memory_order_relaxed);
+            }
+            [[nodiscard]] auto is_done() const -> bool
+            {
+                return num_containers_left.load(std::memory_order_relaxed) == 0;
+            }
+        };
+
+        // Only the containers that aren't ignored and are restricted to 'scan_section' are scanned for, the rest start out as done
+        auto static make_scan_cancellation(const std::vector<SignatureContainer>& signature_containers, std::optional<ScanSection> scan_section)
+                -> std::unique_ptr<ScanCancellation>;
+
+        // Dispatches the matches in order, skipping those for containers that are done, and sets the token of every container that becomes done
+        auto static dispatch_matches(const ChunkMatches& matches, std::vector<SignatureContainer>& signature_containers, ScanCancellation& cancellation)
+                -> void;
+
+        struct PreparedSignatures;
+
+        // A range of memory and the containers to scan it for, see 'scan_jobs'
+        struct ScanJob
+        {
+            uint8_t* start_address{};
+            uint8_t* end_address{};
+            std::vector<ScanRegion> regions{};
+            std::vector<SignatureContainer>* signature_containers{};
+
+            // Only the containers that are restricted to this section are scanned for, every container is scanned for if this is empty
+            // The regions of the job must already be restricted to the section, see 'split_job_by_section'
+            std::optional<ScanSection> scan_section{};
+
+            // Filled in by 'scan_jobs'
+            std::chrono::nanoseconds scan_time{};
+            std::chrono::nanoseconds wall_time{};
+
+            // Readable bytes in the chunks that were skipped because every container of the job was done before they were scanned
+            size_t num_bytes_avoided{};
+        };
+
+        static std::mutex m_module_scan_stats_mutex;
+        static std::vector<ModuleScanStats> m_module_scan_stats;
+
+        // Containers that match more often than this are always scanned for, the cache is meant for signatures that find a handful of matches
+        static constexpr size_t max_cached_matches_per_container = 64;
+
+        static std::mutex m_scan_cache_mutex;
+        static std::filesystem::path m_scan_cache_file;
+        static ScanCache m_scan_cache;
+        static bool m_scan_cache_is_dirty;
+
+        // The identity of a module is only computed once per module start, the code of a module can be hooked after the first scan
+        // It's computed again if the timestamp or size in the headers has changed, which means a different module was loaded at the same address
+        static std::unordered_map<const uint8_t*, ModuleIdentity> m_module_identities;
+
+        // Keyed by the start of the module, the headers are parsed the first time that a module is split into sections
+        static std::mutex m_module_headers_mutex;
+        static std::unordered_map<const uint8_t*, PeHeaders> m_module_headers;
+
+        // Containers that are waiting for their module to be loaded, see 'add_pending_containers'
+        struct PendingContainers
+        {
+            std::wstring module_name{};
+            std::vector<SignatureContainer> signature_containers{};
+        };
+        static std::mutex m_pending_containers_mutex;
+        static std::vector<PendingContainers> m_pending_containers;
+
+        // Scans an entire module for containers that aren't part of 'start_scan', so there's no scan cache and no per-module stats
+        auto static scan_module_for_pending_containers(void* module_handle, std::vector<SignatureContainer>& signature_containers) -> void;
+
+        // Only the containers that are restricted to 'scan_section' are prepared, or every container if 'scan_section' is empty
+        // Signatures are anchored on the bytes that are the least common in 'byte_frequencies', or on their first usable bytes if it's nullptr
+        auto static prepare_signatures(std::vector<SignatureContainer>& signature_containers,
+                                       std::optional<ScanSection> scan_section,
+                                       const ByteFrequencies* byte_frequencies,
+                                       ScanMethod scan_method) -> PreparedSignatures;
+
+        // Scans the parts of 'regions' that are inside [start_address, end_address) with the method that 'prepared' was prepared for
+        // Matches must start before 'end_address' but are allowed to extend past it by up to the size of the longest signature
+        // Matches are appended to 'matches' instead of being dispatched, sorted by address, then container and then signature
+        // The scan methods only read from the containers, so any number of chunks can be scanned at the same time
+        // Scanning for a container stops once its token in 'cancellation' is set, and the whole chunk stops once every token is set
+        auto static scan_chunk(const PreparedSignatures& prepared,
+                               uint8_t* start_address,
+                               uint8_t* end_address,
+                               std::span<const ScanRegion> regions,
+                               std::vector<SignatureContainer>& signature_containers,
+                               const ScanCancellation& cancellation,
+                               ChunkMatches& matches) -> void;
+        auto static scan_chunk_scalar(const PreparedSignatures& prepared,
+                                      uint8_t* start_address,
+                                      uint8_t* end_address,
+                                      std::span<const ScanRegion> regions,
+                                      const ScanCancellation& cancellation,
+                                      ChunkMatches& matches) -> void;
+        auto static scan_chunk_stdfind(const PreparedSignatures& prepared,
+                                       uint8_t* start_address,
+                                       uint8_t* end_address,
+                                       std::span<const ScanRegion> regions,
+                                       const ScanCancellation& cancellation,
+                                       ChunkMatches& matches) -> void;
+        auto static scan_chunk_simd(const PreparedSignatures& prepared,
+                                    uint8_t* start_address,
+                                    uint8_t* end_address,
+                                    std::span<const ScanRegion> regions,
+                                    std::vector<SignatureContainer>& signature_containers,
+                                    const ScanCancellation& cancellation,
+                                    ChunkMatches& matches) -> void;
+        auto static scan_chunk_multipattern(const PreparedSignatures& prepared,
+                                            uint8_t* start_address,
+                                            uint8_t* end_address,
+                                            std::span<const ScanRegion> regions,
+                                            const ScanCancellation& cancellation,
+                                            ChunkMatches& matches) -> void;
+
+        // Same as 'scan_chunk' but prepares the signatures first and dispatches the matches afterwards
+        // The matches are dispatched while 'm_scanner_mutex' is locked because 'scanner_work_thread' can be called from several threads at once
+        auto static scan_regions(uint8_t* start_address,
+                                 uint8_t* end_address,
+                                 std::span<const ScanRegion> regions,
+                                 std::vector<SignatureContainer>& signature_containers,
+                                 ScanMethod scan_method) -> void;
+
+        // Splits every job into chunks of 'm_chunk_size' bytes and scans them, each job is prepared separately
+        // The chunks of all jobs are handed to the thread pool together if the jobs are larger than 'm_multithreading_module_size_threshold' combined
+        auto static scan_jobs(std::span<ScanJob> jobs) -> void;
+
+        // Parses the headers of a loaded module the first time that they're needed, the headers don't have any sections if it isn't a PE image
+        auto static get_module_headers(uint8_t* module_start, uint8_t* module_end) -> const PeHeaders&;
+
+        // Finds every occurrence of every string inside the parts of 'regions' that belong to 'scan_section', see 'string_scan'
+        auto static scan_strings(uint8_t* module_start,
+                                 const PeHeaders& headers,
+                                 std::span<const ScanRegion> regions,
+                                 std::span<const std::wstring_view> strings_to_scan_for,
+                                 ScanSection scan_section) -> std::vector<std::vector<void*>>;
+
+        // Splits a job that covers an entire loaded module into one job per section that its containers are restricted to
+        // Every job that is returned only covers the regions of the module that are inside of its section
+        auto static split_job_by_section(const ScanJob& job) -> std::vector<ScanJob>;
+
+        // Same as 'scan_jobs' with a single job
+        auto static scan_range(uint8_t* start_address, uint8_t* end_address, std::span<const ScanRegion> regions, std::vector<SignatureContainer>& signature_containers)
+                -> void;
+
+        auto static record_module_scan_stats(ScanTarget scan_target, const ScanJob& job) -> void;
+
+        // Replays the cached matches of every container in 'job' that the cache has verified results for
+        // Those containers are ignored by 'scan_jobs' afterwards, and the job isn't scanned at all if that's every container
+        auto static replay_cached_matches(ScanTarget scan_target, const ScanJob& job) -> void;
+
+        // Stores the matches of every container in 'job' that was scanned instead of replayed, must be called before 'on_scan_finished'
+        // Containers without any matches aren't stored, they're scanned for again next time in case the signature was just in the wrong place
+        auto static store_scan_results(ScanTarget scan_target, const ScanJob& job) -> void;
+        auto static save_scan_cache() -> void;
+
+        // Returns nullptr if the module of 'job' can't be identified, 'm_scan_cache_mutex' must be locked
+        auto static get_module_identity(const ScanJob& job) -> const ModuleIdentity*;
+
+        // Replays the cache, scans a job that covers an entire module, updates the cache and calls 'on_scan_finished' for every container
+        auto static scan_module(ScanTarget scan_target, const ScanJob& job) -> void;
+
+        // The pool is shared between all scans and has 'm_num_threads' threads including the thread that starts the scan
+        auto static get_thread_pool() -> std::shared_ptr<ScanThreadPool>;
+
       public:
         RC_SPSS_API auto static scanner_work_thread(uint8_t* start_address,
                                                     uint8_t* end_address,
                                                     SYSTEM_INFO& info,
                                                     std::vector<SignatureContainer>& signature_containers) -> void;
+        // Same as 'scanner_work_thread' but always with the Scalar or StdFind method, regardless of 'm_scan_method'
         RC_SPSS_API auto static scanner_work_thread_scalar(uint8_t* start_address,
                                                            uint8_t* end_address,
                                                            SYSTEM_INFO& info,
@@ -335,9 +625,75 @@ namespace RC
                                                             SYSTEM_INFO& info,
                                                             std::vector<SignatureContainer>& signature_containers) -> void;
 
+        // The callbacks of the containers are never called at the same time, but can be called from any of the scanner threads while the scan is still going
+        // A container sees its matches in ascending address order, matches at the same address are in the order of the signatures of the container
+        // This order doesn't depend on the scan method, the number of threads or the chunk size
+        // Once a container's 'on_match_found' returns true the container isn't scanned for anymore, and the scan stops once that's true for every container
         using SignatureContainerMap = std::unordered_map<ScanTarget, std::vector<SignatureContainer>>;
         RC_SPSS_API auto static start_scan(SignatureContainerMap& signature_containers) -> void;
 
+        // Scans a buffer instead of the modules of the current process, 'on_scan_finished' is called for every container afterwards
+        // Doesn't depend on Windows, which makes it usable for benchmarking and for scanning files on disk
+        RC_SPSS_API auto static scan(std::span<const uint8_t> data, std::vector<SignatureContainer>& signature_containers) -> void;
+
+        // Scans a module that's laid out in memory the same way that the loader lays it out, every byte of 'image' must be readable
+        // Works like 'start_scan' does for a single module, including the scan cache and the section restrictions of the containers
+        RC_SPSS_API auto static scan_image(std::span<const uint8_t> image, ScanTarget scan_target, std::vector<SignatureContainer>& signature_containers) -> void;
+
+        // Scans a PE file as it's laid out on disk, for example one that was mapped with 'FileBase::memory_map', instead of a loaded module
+        // Each section is scanned at its raw data, the section restrictions of the containers work the same as for a loaded module
+        // The match addresses point into 'file_data', use 'PeHeaders::file_offset_to_rva' on the returned headers to get the RVA of a match
+        // 'on_scan_finished' is called for every container afterwards, throws std::runtime_error if 'file_data' isn't a PE file
+        RC_SPSS_API auto static scan_pe_file(std::span<const uint8_t> file_data, std::vector<SignatureContainer>& signature_containers) -> PeHeaders;
+
+        // Enables the scan cache for 'start_scan' and loads any results that were saved to 'cache_file' by a previous launch
+        // The matches of a container are replayed instead of scanned for if the module and the signatures are the same as when they were cached
+        // Every replayed match is compared against its signature first, so a stale cache can only cost a rescan
+        // An empty path disables the cache
+        RC_SPSS_API auto static set_scan_cache_file(std::filesystem::path cache_file) -> void;
+
+        // Scans for 'signature_containers' in the module named 'module_name', for example "MyPlugin.dll", as soon as it's loaded
+        // The module is scanned right away if it's already loaded, otherwise 'scan_loaded_module' scans it once it's loaded
+        // The callbacks are the same as for 'start_scan', 'on_scan_finished' is called for every container once its module has been scanned
+        // Each set of containers is only ever scanned for once, loading the same module again doesn't rescan it
+        RC_SPSS_API auto static add_pending_containers(std::wstring module_name, std::vector<SignatureContainer> signature_containers) -> void;
+
+        // Scans a module that was just loaded for every set of pending containers that's waiting for it, see 'add_pending_containers'
+        // Does nothing if there aren't any pending containers for the module, 'start_watching_module_loads' calls this for every module that's loaded
+        RC_SPSS_API auto static scan_loaded_module(void* module_handle) -> void;
+
+        // Calls 'scan_loaded_module' for every module that the loader maps from now on, no matter which module called LoadLibrary or if it was a dependency
+        // The loader lock is held while the loader reports a module, so the scans are queued to a background thread that hands the chunks to the scanner pool
+        // Returns false if the loader can't report modules, pending containers are then only scanned for by explicit calls to 'scan_loaded_module'
+        RC_SPSS_API auto static start_watching_module_loads() -> bool;
+
+        // Stops reporting modules and waits for the scan that's in progress, modules that are still queued aren't scanned
+        // Must be called before the callbacks of the pending containers stop being valid
+        RC_SPSS_API auto static stop_watching_module_loads() -> void;
+
+        // The names of the modules that pending containers are still waiting for, one name per call to 'add_pending_containers'
+        RC_SPSS_API auto static get_pending_module_names() -> std::vector<std::wstring>;
+
+        // Returns the stats of every module that 'start_scan' has scanned so far, slowest module first
+        RC_SPSS_API auto static get_module_scan_stats() -> std::vector<ModuleScanStats>;
+
+        // Returns true if every byte of [address, address + size) is in committed memory that can be read, see 'Resolver::IsReadable'
+        RC_SPSS_API auto static is_readable(const uint8_t* address, size_t size) -> bool;
+
+        // Returns the address of the first occurrence of the string, or nullptr if it wasn't found
         RC_SPSS_API auto static string_scan(std::wstring_view string_to_scan_for, ScanTarget = ScanTarget::MainExe) -> void*;
+
+        // Finds every occurrence of every string in a single pass over the module, which is much faster than one 'string_scan' per string
+        // The matches are grouped per string, in the same order as 'strings_to_scan_for', and each group is sorted by address
+        // Pass 'ScanSection::ReadOnlyData' to only look in sections like .rdata, which is where string literals are
+        RC_SPSS_API auto static string_scan(std::span<const std::wstring_view> strings_to_scan_for,
+                                            ScanTarget = ScanTarget::MainExe,
+                                            ScanSection scan_section = ScanSection::All) -> std::vector<std::vector<void*>>;
+
+        // Same as above but scans a buffer instead of a loaded module
+        // The buffer must be laid out like a loaded image for 'scan_section' to work, otherwise the entire buffer is scanned
+        RC_SPSS_API auto static string_scan(std::span<const uint8_t> data,
+                                            std::span<const std::wstring_view> strings_to_scan_for,
+                                            ScanSection scan_section = ScanSection::All) -> std::vector<std::vector<void*>>;
     };
 } // namespace RC
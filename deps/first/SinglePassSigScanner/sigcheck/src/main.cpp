@@ -0,0 +1,279 @@
+// Checks a list of signatures against a game executable on disk, without launching the game
+// The file is scanned as it's laid out on disk and every match is translated back to the RVA that it has once the game is running
+//
+// Usage: sigcheck <pe-file> <signature-file> [--threads=8] [--method=Scalar|StdFind|Simd|MultiPattern] [--section=code|rdata|all] [--require-unique]
+// Every line in the signature file is 'Name = 48 8B 0D ?? ?? ?? ??', empty lines and lines that start with '#' or ';' are ignored
+// The process exits with 1 if a signature wasn't found, or was found more than once with --require-unique, and with 2 if the input was invalid
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <SigScanner/SinglePassSigScanner.hpp>
+
+#include <File/File.hpp>
+
+using namespace RC;
+
+struct Options
+{
+    std::filesystem::path pe_file{};
+    std::filesystem::path signature_file{};
+    uint32_t num_threads{};
+    SinglePassScanner::ScanMethod scan_method{SinglePassScanner::ScanMethod::MultiPattern};
+    ScanSection scan_section{ScanSection::Code};
+    bool require_unique{};
+};
+
+struct NamedSignature
+{
+    std::string name{};
+    std::string signature{};
+};
+
+[[noreturn]] static auto exit_with_usage(const char* error) -> void
+{
+    std::fprintf(stderr, "%s\n", error);
+    std::fprintf(stderr,
+                 "Usage: sigcheck <pe-file> <signature-file> [--threads=N] [--method=Scalar|StdFind|Simd|MultiPattern] [--section=code|rdata|all] "
+                 "[--require-unique]\n");
+    std::exit(2);
+}
+
+static auto parse_options(int argc, char* argv[]) -> Options
+{
+    Options options{};
+    std::vector<std::string_view> positional_args{};
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg{argv[i]};
+        if (!arg.starts_with("--"))
+        {
+            positional_args.emplace_back(arg);
+            continue;
+        }
+
+        const auto equals = arg.find('=');
+        const auto name = arg.substr(0, equals);
+        const auto value = equals == std::string_view::npos ? std::string_view{} : arg.substr(equals + 1);
+
+        if (name == "--threads")
+        {
+            options.num_threads = static_cast<uint32_t>(std::stoul(std::string{value}));
+        }
+        else if (name == "--method")
+        {
+            if (value == "Scalar") options.scan_method = SinglePassScanner::ScanMethod::Scalar;
+            else if (value == "StdFind") options.scan_method = SinglePassScanner::ScanMethod::StdFind;
+            else if (value == "Simd") options.scan_method = SinglePassScanner::ScanMethod::Simd;
+            else if (value == "MultiPattern") options.scan_method = SinglePassScanner::ScanMethod::MultiPattern;
+            else exit_with_usage("Unknown scan method.");
+        }
+        else if (name == "--section")
+        {
+            if (value == "code") options.scan_section = ScanSection::Code;
+            else if (value == "rdata") options.scan_section = ScanSection::ReadOnlyData;
+            else if (value == "all") options.scan_section = ScanSection::All;
+            else exit_with_usage("Unknown section.");
+        }
+        else if (name == "--require-unique")
+        {
+            options.require_unique = true;
+        }
+        else
+        {
+            exit_with_usage("Unknown option.");
+        }
+    }
+
+    if (positional_args.size() != 2)
+    {
+        exit_with_usage("Expected a PE file and a signature file.");
+    }
+    options.pe_file = positional_args[0];
+    options.signature_file = positional_args[1];
+
+    if (options.num_threads == 0)
+    {
+        options.num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    return options;
+}
+
+static auto trim(std::string_view text) -> std::string_view
+{
+    const auto first = text.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos)
+    {
+        return {};
+    }
+    const auto last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+static auto read_signature_file(const std::filesystem::path& signature_file) -> std::vector<NamedSignature>
+{
+    std::ifstream stream{signature_file};
+    if (!stream)
+    {
+        throw std::runtime_error{"Couldn't open the signature file: " + signature_file.string()};
+    }
+
+    std::vector<NamedSignature> signatures{};
+    std::string line{};
+    for (size_t line_number = 1; std::getline(stream, line); ++line_number)
+    {
+        const auto trimmed_line = trim(line);
+        if (trimmed_line.empty() || trimmed_line.starts_with('#') || trimmed_line.starts_with(';'))
+        {
+            continue;
+        }
+
+        const auto equals = trimmed_line.find('=');
+        if (equals == std::string_view::npos)
+        {
+            throw std::runtime_error{"Expected 'Name = Signature' on line " + std::to_string(line_number) + " of the signature file."};
+        }
+
+        auto& named_signature = signatures.emplace_back();
+        named_signature.name = trim(trimmed_line.substr(0, equals));
+        named_signature.signature = trim(trimmed_line.substr(equals + 1));
+
+        // Parsed here so that a typo is reported with its name instead of in the middle of the scan
+        try
+        {
+            std::ignore = make_packed_signature(named_signature.signature);
+        }
+        catch (const std::exception& e)
+        {
+            throw std::runtime_error{"Signature '" + named_signature.name + "' isn't valid: " + e.what()};
+        }
+    }
+
+    return signatures;
+}
+
+// Keeps the file alive for as long as the scan needs it
+class PeFile
+{
+  private:
+    File::Handle m_file{};
+    std::span<const uint8_t> m_data{};
+
+  public:
+    explicit PeFile(const std::filesystem::path& pe_file)
+    {
+        // The file is mapped instead of read so that only the pages of the sections that are scanned are ever loaded
+        m_file = File::open(pe_file);
+        m_data = m_file.memory_map();
+    }
+
+    [[nodiscard]] auto get_data() const -> std::span<const uint8_t>
+    {
+        return m_data;
+    }
+};
+
+static auto run(const Options& options) -> int
+{
+    const auto named_signatures = read_signature_file(options.signature_file);
+    if (named_signatures.empty())
+    {
+        throw std::runtime_error{"The signature file doesn't contain any signatures."};
+    }
+
+    const PeFile pe_file{options.pe_file};
+    const auto file_data = pe_file.get_data();
+
+    SinglePassScanner::m_scan_method = options.scan_method;
+    SinglePassScanner::m_num_threads = options.num_threads;
+    SinglePassScanner::m_multithreading_module_size_threshold = options.num_threads > 1 ? 0 : std::numeric_limits<uint32_t>::max();
+
+    // One container per signature and none of them ever stop, so every match is stored
+    std::vector<SignatureContainer> containers{};
+    containers.reserve(named_signatures.size());
+    for (const auto& named_signature : named_signatures)
+    {
+        containers.emplace_back(
+                std::vector<SignatureData>{{named_signature.signature}},
+                [](SignatureContainer&) {
+                    return false;
+                },
+                [](SignatureContainer&) {},
+                true,
+                options.scan_section);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto headers = SinglePassScanner::scan_pe_file(file_data, containers);
+    const auto end = std::chrono::steady_clock::now();
+
+    size_t num_missing{};
+    size_t num_ambiguous{};
+    for (size_t i = 0; i < containers.size(); ++i)
+    {
+        const auto& results = containers[i].get_result_store();
+        const char* status = results.empty() ? "MISSING" : results.size() > 1 ? "AMBIGUOUS" : "FOUND";
+        num_missing += results.empty();
+        num_ambiguous += results.size() > 1;
+
+        // A signature that's far too generic could match thousands of times, a few of them are enough to tell what it's matching
+        static constexpr size_t max_printed_matches = 8;
+        std::printf("%-10s %-40s", status, named_signatures[i].name.c_str());
+        for (const auto& result : std::span{results}.first(std::min(results.size(), max_printed_matches)))
+        {
+            const auto file_offset = static_cast<uint32_t>(result.match_address - file_data.data());
+            if (const auto rva = headers.file_offset_to_rva(file_offset))
+            {
+                std::printf(" 0x%08X", *rva);
+            }
+            else
+            {
+                std::printf(" file+0x%08X", file_offset);
+            }
+        }
+        if (results.size() > max_printed_matches)
+        {
+            std::printf(" (+%zu more)", results.size() - max_printed_matches);
+        }
+        std::printf("\n");
+    }
+
+    std::printf("\n%zu signatures, %zu found, %zu ambiguous, %zu missing\n",
+                containers.size(),
+                containers.size() - num_missing - num_ambiguous,
+                num_ambiguous,
+                num_missing);
+    std::printf("Scanned %.2f MB in %.2f ms\n",
+                static_cast<double>(file_data.size()) / (1024.0 * 1024.0),
+                std::chrono::duration<double, std::milli>(end - start).count());
+
+    return num_missing > 0 || (options.require_unique && num_ambiguous > 0) ? 1 : 0;
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    const auto options = parse_options(argc, argv);
+
+    try
+    {
+        return run(options);
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 2;
+    }
+}
@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include <SigScanner/MultiPatternMatcher.hpp>
+
+namespace RC
+{
+    static auto make_pair_key(uint8_t lead_byte, uint8_t next_byte) -> uint32_t
+    {
+        return static_cast<uint32_t>(lead_byte) | (static_cast<uint32_t>(next_byte) << 8);
+    }
+
+    auto MultiPatternMatcher::add_pattern(PackedSignature pattern) -> size_t
+    {
+        if (m_is_built)
+        {
+            throw std::runtime_error{"[MultiPatternMatcher::add_pattern] Patterns cannot be added after 'build' has been called"};
+        }
+
+        if (pattern.empty())
+        {
+            throw std::runtime_error{"[MultiPatternMatcher::add_pattern] Patterns cannot be empty"};
+        }
+
+        m_max_pattern_size = std::max(m_max_pattern_size, pattern.size());
+        m_patterns.emplace_back(std::move(pattern));
+        return m_patterns.size() - 1;
+    }
+
+    auto MultiPatternMatcher::build(const ByteFrequencies* byte_frequencies) -> void
+    {
+        static constexpr size_t num_pair_keys = 0x10000;
+
+        m_pair_filter.assign(num_pair_keys / 64, 0);
+        m_pair_bucket_starts.assign(num_pair_keys + 1, 0);
+
+        // Pairs are stored in a flat array sorted by key, 'm_pair_bucket_starts' has the start of each bucket
+        // This keeps all entries for a pair in one cache line more often than not, which a map of vectors wouldn't
+        std::vector<std::pair<uint32_t, BucketEntry>> pair_entries{};
+        ScanKernel::ByteSet lead_bytes{};
+
+        for (size_t pattern_index = 0; pattern_index < m_patterns.size(); ++pattern_index)
+        {
+            auto& pattern = m_patterns[pattern_index];
+            if (byte_frequencies)
+            {
+                choose_rarest_anchors(pattern, *byte_frequencies);
+            }
+
+            // Without frequencies the first pair is used, otherwise the pair that's least likely to show up by chance
+            size_t pair_offset = PackedSignature::NoAnchor;
+            uint64_t pair_score = std::numeric_limits<uint64_t>::max();
+            for (size_t i = 0; i + 1 < pattern.size(); ++i)
+            {
+                if (pattern.mask[i] != 0xFF || pattern.mask[i + 1] != 0xFF)
+                {
+                    continue;
+                }
+
+                if (!byte_frequencies)
+                {
+                    pair_offset = i;
+                    break;
+                }
+
+                const uint64_t score = ((*byte_frequencies)[pattern.bytes[i]] + 1) * ((*byte_frequencies)[pattern.bytes[i + 1]] + 1);
+                if (score < pair_score)
+                {
+                    pair_offset = i;
+                    pair_score = score;
+                }
+            }
+
+            if (pair_offset != PackedSignature::NoAnchor)
+            {
+                const uint8_t lead_byte = pattern.bytes[pair_offset];
+                const uint32_t key = make_pair_key(lead_byte, pattern.bytes[pair_offset + 1]);
+                lead_bytes.add(lead_byte);
+                m_pair_filter[key / 64] |= 1ull << (key % 64);
+                pair_entries.emplace_back(key, BucketEntry{static_cast<uint32_t>(pattern_index), static_cast<uint32_t>(pair_offset)});
+            }
+            else if (pattern.has_anchor())
+            {
+                const uint8_t lead_byte = pattern.bytes[pattern.anchor_offset];
+                lead_bytes.add(lead_byte);
+                m_byte_buckets[lead_byte].emplace_back(BucketEntry{static_cast<uint32_t>(pattern_index), static_cast<uint32_t>(pattern.anchor_offset)});
+            }
+            else
+            {
+                m_unanchored_patterns.emplace_back(static_cast<uint32_t>(pattern_index));
+            }
+        }
+
+        std::stable_sort(pair_entries.begin(), pair_entries.end(), [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+
+        m_pair_entries.clear();
+        m_pair_entries.reserve(pair_entries.size());
+        for (const auto& [key, entry] : pair_entries)
+        {
+            ++m_pair_bucket_starts[key + 1];
+            m_pair_entries.emplace_back(entry);
+        }
+        for (size_t key = 0; key < num_pair_keys; ++key)
+        {
+            m_pair_bucket_starts[key + 1] += m_pair_bucket_starts[key];
+        }
+
+        // Every lead byte ends up in exactly one group, so a candidate is only ever found by one pass
+        m_lead_byte_groups.clear();
+        const auto& lead_byte_values = lead_bytes.get_values();
+        if (lead_byte_values.size() > ScanKernel::max_simd_byte_set_size * max_lead_byte_groups)
+        {
+            m_lead_byte_groups.emplace_back(lead_bytes);
+        }
+        else
+        {
+            for (size_t i = 0; i < lead_byte_values.size(); ++i)
+            {
+                if (i % ScanKernel::max_simd_byte_set_size == 0)
+                {
+                    m_lead_byte_groups.emplace_back();
+                }
+                m_lead_byte_groups.back().add(lead_byte_values[i]);
+            }
+        }
+
+        m_is_built = true;
+    }
+
+    auto MultiPatternMatcher::scan(std::span<const uint8_t> data, const OnMatchFound& on_match_found) const -> bool
+    {
+        if (!m_is_built)
+        {
+            throw std::runtime_error{"[MultiPatternMatcher::scan] 'build' must be called before scanning"};
+        }
+
+        const uint8_t* data_start = data.data();
+        const size_t data_size = data.size();
+
+        auto check_candidate = [&](const BucketEntry& entry, size_t anchor_position) -> bool {
+            if (anchor_position < entry.anchor_offset)
+            {
+                return false;
+            }
+
+            const size_t match_offset = anchor_position - entry.anchor_offset;
+            const auto& pattern = m_patterns[entry.pattern_index];
+            if (match_offset + pattern.size() > data_size || !pattern.matches(data_start + match_offset))
+            {
+                return false;
+            }
+
+            return on_match_found(entry.pattern_index, data_start + match_offset);
+        };
+
+        if (!m_unanchored_patterns.empty())
+        {
+            for (size_t offset = 0; offset < data_size; ++offset)
+            {
+                for (const auto pattern_index : m_unanchored_patterns)
+                {
+                    if (check_candidate(BucketEntry{pattern_index, 0}, offset))
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+
+        for (const auto& lead_bytes : m_lead_byte_groups)
+        {
+            size_t offset = 0;
+            while (offset < data_size)
+            {
+                const uint8_t* found = ScanKernel::find_first_of(data.subspan(offset), lead_bytes);
+                if (!found)
+                {
+                    break;
+                }
+
+                const size_t anchor_position = found - data_start;
+                const uint8_t lead_byte = *found;
+
+                if (anchor_position + 1 < data_size)
+                {
+                    const uint32_t key = make_pair_key(lead_byte, found[1]);
+                    if (m_pair_filter[key / 64] & (1ull << (key % 64)))
+                    {
+                        for (uint32_t i = m_pair_bucket_starts[key]; i < m_pair_bucket_starts[key + 1]; ++i)
+                        {
+                            if (check_candidate(m_pair_entries[i], anchor_position))
+                            {
+                                return true;
+                            }
+                        }
+                    }
+                }
+
+                for (const auto& entry : m_byte_buckets[lead_byte])
+                {
+                    if (check_candidate(entry, anchor_position))
+                    {
+                        return true;
+                    }
+                }
+
+                offset = anchor_position + 1;
+            }
+        }
+
+        return false;
+    }
+} // namespace RC
@@ -0,0 +1,131 @@
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include <SigScanner/PackedSignature.hpp>
+
+namespace RC
+{
+    static auto is_nibble(char symbol) -> bool
+    {
+        return symbol == '?' || Internal::hex_char_to_nibble(symbol) != -1;
+    }
+
+    auto normalize_signature(std::string_view signature) -> std::string
+    {
+        // Signatures with a '/' between bytes have a space between the two nibbles of each byte, so a lone '?' there is already one nibble
+        if (signature.find('/') != std::string_view::npos)
+        {
+            return std::string{signature};
+        }
+
+        std::string normalized_signature{};
+        normalized_signature.reserve(signature.size());
+        for (size_t i = 0; i < signature.size(); ++i)
+        {
+            normalized_signature.push_back(signature[i]);
+            if (signature[i] == '?' && (i == 0 || !is_nibble(signature[i - 1])) && (i + 1 == signature.size() || !is_nibble(signature[i + 1])))
+            {
+                normalized_signature.push_back('?');
+            }
+        }
+        return normalized_signature;
+    }
+
+    auto make_packed_signature(std::string_view signature) -> PackedSignature
+    {
+        PackedSignature packed_signature{};
+        packed_signature.bytes.reserve(signature.size() / 2);
+        packed_signature.mask.reserve(signature.size() / 2);
+
+        const bool has_whole_bytes = Internal::for_each_signature_byte(signature, [&](uint8_t byte, uint8_t mask) {
+            packed_signature.bytes.push_back(byte);
+            packed_signature.mask.push_back(mask);
+        });
+
+        if (!has_whole_bytes)
+        {
+            throw std::runtime_error{"[make_packed_signature] The signature contains an odd number of nibbles.\nSignature: " + std::string{signature}};
+        }
+
+        if (packed_signature.empty())
+        {
+            throw std::runtime_error{"[make_packed_signature] The signature is empty.\nSignature: " + std::string{signature}};
+        }
+
+        std::tie(packed_signature.anchor_offset, packed_signature.second_anchor_offset) = Internal::find_default_anchors(packed_signature.mask);
+        return packed_signature;
+    }
+
+    auto make_exact_signature(std::span<const uint8_t> bytes) -> PackedSignature
+    {
+        if (bytes.empty())
+        {
+            throw std::runtime_error{"[make_exact_signature] The signature is empty."};
+        }
+
+        PackedSignature packed_signature{};
+        packed_signature.bytes.assign(bytes.begin(), bytes.end());
+        packed_signature.mask.assign(bytes.size(), 0xFF);
+        packed_signature.anchor_offset = 0;
+        packed_signature.second_anchor_offset = bytes.size() - 1;
+        return packed_signature;
+    }
+
+    auto count_byte_frequencies(std::span<const uint8_t> data, ByteFrequencies& byte_frequencies) -> void
+    {
+        // Counting into four tables avoids the stall when the same byte value is counted several times in a row, which is common in padding
+        std::array<ByteFrequencies, 4> partial_frequencies{};
+        size_t offset = 0;
+        for (; offset + 4 <= data.size(); offset += 4)
+        {
+            ++partial_frequencies[0][data[offset]];
+            ++partial_frequencies[1][data[offset + 1]];
+            ++partial_frequencies[2][data[offset + 2]];
+            ++partial_frequencies[3][data[offset + 3]];
+        }
+        for (; offset < data.size(); ++offset)
+        {
+            ++partial_frequencies[0][data[offset]];
+        }
+
+        for (size_t byte = 0; byte < byte_frequencies.size(); ++byte)
+        {
+            byte_frequencies[byte] += partial_frequencies[0][byte] + partial_frequencies[1][byte] + partial_frequencies[2][byte] + partial_frequencies[3][byte];
+        }
+    }
+
+    auto choose_rarest_anchors(PackedSignature& signature, const ByteFrequencies& byte_frequencies) -> void
+    {
+        if (!signature.has_anchor())
+        {
+            return;
+        }
+
+        // Ties go to the earlier byte
+        size_t rarest_offset = PackedSignature::NoAnchor;
+        size_t second_rarest_offset = PackedSignature::NoAnchor;
+        for (size_t i = 0; i < signature.size(); ++i)
+        {
+            if (signature.mask[i] != 0xFF)
+            {
+                continue;
+            }
+
+            const auto frequency = byte_frequencies[signature.bytes[i]];
+            if (rarest_offset == PackedSignature::NoAnchor || frequency < byte_frequencies[signature.bytes[rarest_offset]])
+            {
+                second_rarest_offset = rarest_offset;
+                rarest_offset = i;
+            }
+            else if (second_rarest_offset == PackedSignature::NoAnchor || frequency < byte_frequencies[signature.bytes[second_rarest_offset]])
+            {
+                second_rarest_offset = i;
+            }
+        }
+
+        signature.anchor_offset = rarest_offset;
+        signature.second_anchor_offset = second_rarest_offset != PackedSignature::NoAnchor ? second_rarest_offset : rarest_offset;
+    }
+} // namespace RC
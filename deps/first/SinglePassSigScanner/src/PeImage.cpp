@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+#include <SigScanner/PeImage.hpp>
+
+namespace RC
+{
+    template <typename T>
+    static auto read_at(std::span<const uint8_t> data, size_t offset) -> T
+    {
+        if (offset > data.size() || data.size() - offset < sizeof(T))
+        {
+            throw std::runtime_error{"[parse_pe_headers] The PE headers are truncated"};
+        }
+
+        T value{};
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        return value;
+    }
+
+    auto PeHeaders::find_section(std::string_view name) const -> const PeSection*
+    {
+        for (const auto& section : sections)
+        {
+            if (section.name == name)
+            {
+                return &section;
+            }
+        }
+        return nullptr;
+    }
+
+    // The part of the raw data of a section that ends up in the image, raw data is padded to the file alignment and can be longer than the section
+    static auto get_mapped_raw_size(const PeSection& section) -> uint32_t
+    {
+        return section.virtual_size ? std::min(section.raw_data_size, section.virtual_size) : section.raw_data_size;
+    }
+
+    auto PeHeaders::file_offset_to_rva(uint32_t file_offset) const -> std::optional<uint32_t>
+    {
+        // The headers are mapped as-is at the start of the image
+        if (file_offset < size_of_headers)
+        {
+            return file_offset;
+        }
+
+        for (const auto& section : sections)
+        {
+            if (file_offset >= section.raw_data_offset && file_offset - section.raw_data_offset < get_mapped_raw_size(section))
+            {
+                return section.virtual_address + (file_offset - section.raw_data_offset);
+            }
+        }
+        return {};
+    }
+
+    auto PeHeaders::rva_to_file_offset(uint32_t rva) const -> std::optional<uint32_t>
+    {
+        if (rva < size_of_headers)
+        {
+            return rva;
+        }
+
+        // Bytes past the raw data of a section are zero-filled when the image is loaded, so they aren't in the file
+        for (const auto& section : sections)
+        {
+            if (rva >= section.virtual_address && rva - section.virtual_address < get_mapped_raw_size(section))
+            {
+                return section.raw_data_offset + (rva - section.virtual_address);
+            }
+        }
+        return {};
+    }
+
+    auto parse_pe_headers(std::span<const uint8_t> data) -> PeHeaders
+    {
+        // IMAGE_DOS_HEADER::e_magic & e_lfanew
+        if (read_at<uint16_t>(data, 0) != 0x5A4D)
+        {
+            throw std::runtime_error{"[parse_pe_headers] Missing 'MZ' signature"};
+        }
+        const size_t nt_headers_offset = read_at<uint32_t>(data, 0x3C);
+
+        if (read_at<uint32_t>(data, nt_headers_offset) != 0x00004550)
+        {
+            throw std::runtime_error{"[parse_pe_headers] Missing 'PE' signature"};
+        }
+
+        // IMAGE_FILE_HEADER
+        const size_t file_header_offset = nt_headers_offset + 4;
+        const uint16_t number_of_sections = read_at<uint16_t>(data, file_header_offset + 2);
+        const uint16_t size_of_optional_header = read_at<uint16_t>(data, file_header_offset + 16);
+
+        PeHeaders headers{};
+        headers.time_date_stamp = read_at<uint32_t>(data, file_header_offset + 4);
+
+        // IMAGE_OPTIONAL_HEADER, these two fields are at the same offset for PE32 and PE32+
+        const size_t optional_header_offset = file_header_offset + 20;
+        headers.size_of_image = read_at<uint32_t>(data, optional_header_offset + 56);
+        headers.size_of_headers = read_at<uint32_t>(data, optional_header_offset + 60);
+
+        // IMAGE_SECTION_HEADER
+        const size_t section_headers_offset = optional_header_offset + size_of_optional_header;
+        for (size_t i = 0; i < number_of_sections; ++i)
+        {
+            const size_t section_offset = section_headers_offset + i * 40;
+            auto name = read_at<std::array<char, 8>>(data, section_offset);
+
+            auto& section = headers.sections.emplace_back();
+            section.name.assign(name.data(), strnlen(name.data(), name.size()));
+            section.virtual_size = read_at<uint32_t>(data, section_offset + 8);
+            section.virtual_address = read_at<uint32_t>(data, section_offset + 12);
+            section.raw_data_size = read_at<uint32_t>(data, section_offset + 16);
+            section.raw_data_offset = read_at<uint32_t>(data, section_offset + 20);
+            section.characteristics = read_at<uint32_t>(data, section_offset + 36);
+        }
+
+        return headers;
+    }
+
+    static constexpr uint64_t hash_prime_1 = 0x9E3779B185EBCA87ull;
+    static constexpr uint64_t hash_prime_2 = 0xC2B2AE3D27D4EB4Full;
+    static constexpr uint64_t hash_prime_3 = 0x165667B19E3779F9ull;
+
+    static auto hash_round(uint64_t accumulator, uint64_t input) -> uint64_t
+    {
+        return std::rotl(accumulator + input * hash_prime_2, 31) * hash_prime_1;
+    }
+
+    auto hash_bytes(std::span<const uint8_t> data) -> uint64_t
+    {
+        // Four independent lanes keep the multipliers busy, this hashes several GB/s which is far faster than scanning the same memory
+        uint64_t lanes[4]{hash_prime_1 + hash_prime_2, hash_prime_2, 0, 0 - hash_prime_1};
+
+        const uint8_t* current = data.data();
+        const uint8_t* const end = data.data() + data.size();
+        for (; end - current >= 32; current += 32)
+        {
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                uint64_t word{};
+                std::memcpy(&word, current + lane * 8, sizeof(word));
+                lanes[lane] = hash_round(lanes[lane], word);
+            }
+        }
+
+        uint64_t hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+        hash += data.size();
+
+        for (; current < end; ++current)
+        {
+            hash = std::rotl(hash ^ (*current * hash_prime_3), 11) * hash_prime_1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= hash_prime_2;
+        hash ^= hash >> 29;
+        hash *= hash_prime_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+} // namespace RC
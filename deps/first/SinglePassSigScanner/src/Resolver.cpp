@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <SigScanner/Resolver.hpp>
+
+namespace RC
+{
+    static auto trim(std::string_view text) -> std::string_view
+    {
+        const auto first = text.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos)
+        {
+            return {};
+        }
+        const auto last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+
+    // Splits off the first word of 'text', 'text' is left with whatever comes after it
+    static auto take_word(std::string_view& text) -> std::string_view
+    {
+        text = trim(text);
+        const auto word_end = std::min(text.find_first_of(" \t"), text.size());
+        const auto word = text.substr(0, word_end);
+        text = trim(text.substr(word_end));
+        return word;
+    }
+
+    static auto parse_number(std::string_view text, std::string_view step) -> int64_t
+    {
+        int base = 10;
+        if (text.starts_with("0x") || text.starts_with("0X"))
+        {
+            text.remove_prefix(2);
+            base = 16;
+        }
+
+        int64_t number{};
+        const auto result = std::from_chars(text.data(), text.data() + text.size(), number, base);
+        if (text.empty() || result.ec != std::errc{} || result.ptr != text.data() + text.size())
+        {
+            throw std::runtime_error{"[Resolver::parse] Expected a number.\nStep: " + std::string{step}};
+        }
+        return number;
+    }
+
+    auto Resolver::parse(std::string_view text) -> Resolver
+    {
+        Resolver resolver{};
+
+        while (!text.empty())
+        {
+            const auto step_end = std::min(text.find_first_of(";\n"), text.size());
+            const auto step = trim(text.substr(0, step_end));
+            text.remove_prefix(std::min(step_end + 1, text.size()));
+            if (step.empty())
+            {
+                continue;
+            }
+
+            auto arguments = step;
+            const auto operation = take_word(arguments);
+            auto& parsed_step = resolver.m_steps.emplace_back();
+
+            auto expect_no_arguments = [&] {
+                if (!arguments.empty())
+                {
+                    throw std::runtime_error{"[Resolver::parse] Didn't expect any arguments.\nStep: " + std::string{step}};
+                }
+            };
+
+            if (operation == "add" || operation == "sub")
+            {
+                parsed_step.operation = Operation::Add;
+                parsed_step.value = parse_number(take_word(arguments), step);
+                if (operation == "sub")
+                {
+                    parsed_step.value = -parsed_step.value;
+                }
+                expect_no_arguments();
+            }
+            else if (operation == "deref")
+            {
+                parsed_step.operation = Operation::Deref;
+                expect_no_arguments();
+            }
+            else if (operation == "rip")
+            {
+                parsed_step.operation = Operation::RipRelative;
+                parsed_step.value = parse_number(take_word(arguments), step);
+                parsed_step.instruction_size = parse_number(take_word(arguments), step);
+                expect_no_arguments();
+            }
+            else if (operation == "call")
+            {
+                parsed_step.operation = Operation::Call;
+                expect_no_arguments();
+            }
+            else if (operation == "jmp")
+            {
+                parsed_step.operation = Operation::Jmp;
+                expect_no_arguments();
+            }
+            else if (operation == "expect")
+            {
+                parsed_step.operation = Operation::Expect;
+                parsed_step.expected_bytes = make_packed_signature(arguments);
+            }
+            else
+            {
+                throw std::runtime_error{"[Resolver::parse] Unknown step, expected one of add, sub, deref, rip, call, jmp or expect.\nStep: " + std::string{step}};
+            }
+        }
+
+        return resolver;
+    }
+
+    auto Resolver::resolve(uint8_t* match_address, const IsReadable& is_readable) const -> uint8_t*
+    {
+        // Unsigned arithmetic so that a step that goes out of bounds is a failed read instead of undefined behavior
+        auto address = reinterpret_cast<uintptr_t>(match_address);
+
+        auto can_read = [&](uintptr_t read_address, size_t size) {
+            return read_address != 0 && (!is_readable || is_readable(reinterpret_cast<const uint8_t*>(read_address), size));
+        };
+
+        auto read_int32 = [](uintptr_t read_address) {
+            int32_t value{};
+            std::memcpy(&value, reinterpret_cast<const void*>(read_address), sizeof(value));
+            return value;
+        };
+
+        for (const auto& step : m_steps)
+        {
+            switch (step.operation)
+            {
+            case Operation::Add:
+                address += static_cast<uintptr_t>(step.value);
+                break;
+            case Operation::Deref:
+                if (!can_read(address, sizeof(uintptr_t)))
+                {
+                    return nullptr;
+                }
+                std::memcpy(&address, reinterpret_cast<const void*>(address), sizeof(uintptr_t));
+                break;
+            case Operation::RipRelative:
+                if (!can_read(address + step.value, sizeof(int32_t)))
+                {
+                    return nullptr;
+                }
+                address += static_cast<uintptr_t>(step.instruction_size + read_int32(address + step.value));
+                break;
+            case Operation::Call:
+                if (!can_read(address, 5) || *reinterpret_cast<const uint8_t*>(address) != 0xE8)
+                {
+                    return nullptr;
+                }
+                address += static_cast<uintptr_t>(5 + static_cast<int64_t>(read_int32(address + 1)));
+                break;
+            case Operation::Jmp:
+                if (can_read(address, 5) && *reinterpret_cast<const uint8_t*>(address) == 0xE9)
+                {
+                    address += static_cast<uintptr_t>(5 + static_cast<int64_t>(read_int32(address + 1)));
+                }
+                else if (can_read(address, 2) && *reinterpret_cast<const uint8_t*>(address) == 0xEB)
+                {
+                    address += static_cast<uintptr_t>(2 + static_cast<int64_t>(*reinterpret_cast<const int8_t*>(address + 1)));
+                }
+                else
+                {
+                    return nullptr;
+                }
+                break;
+            case Operation::Expect:
+                if (!can_read(address, step.expected_bytes.size()) || !step.expected_bytes.matches(reinterpret_cast<const uint8_t*>(address)))
+                {
+                    return nullptr;
+                }
+                break;
+            }
+        }
+
+        return reinterpret_cast<uint8_t*>(address);
+    }
+} // namespace RC
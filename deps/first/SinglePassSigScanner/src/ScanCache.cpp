@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <stdexcept>
+
+#include <SigScanner/PeImage.hpp>
+#include <SigScanner/ScanCache.hpp>
+
+namespace RC
+{
+    // Bump this whenever the layout of the file changes, old files are then ignored instead of misread
+    static constexpr std::array<char, 8> scan_cache_magic{'S', 'P', 'S', 'S', 'C', 'A', 'C', 'H'};
+    static constexpr uint32_t scan_cache_version = 1;
+
+    auto make_module_identity(const uint8_t* image_base, const IsReadable& is_readable) -> ModuleIdentity
+    {
+        if (!image_base)
+        {
+            throw std::runtime_error{"[make_module_identity] The image base is null"};
+        }
+
+        // The headers of every module fit in the first page, the section headers are also in there unless the module is very unusual
+        if (!is_readable(image_base, 0x1000))
+        {
+            throw std::runtime_error{"[make_module_identity] The headers of the module can't be read"};
+        }
+        auto headers = parse_pe_headers({image_base, 0x1000});
+        if (headers.size_of_headers > 0x1000)
+        {
+            if (!is_readable(image_base, headers.size_of_headers))
+            {
+                throw std::runtime_error{"[make_module_identity] The headers of the module can't be read"};
+            }
+            headers = parse_pe_headers({image_base, headers.size_of_headers});
+        }
+
+        ModuleIdentity identity{};
+        identity.time_date_stamp = headers.time_date_stamp;
+        identity.size_of_image = headers.size_of_image;
+
+        for (const auto& section : headers.sections)
+        {
+            if ((section.characteristics & (PeHeaders::SectionContainsCode | PeHeaders::SectionIsExecutable)) == 0 ||
+                section.virtual_address >= headers.size_of_image)
+            {
+                continue;
+            }
+
+            const size_t section_size = std::min<size_t>(section.virtual_size, headers.size_of_image - section.virtual_address);
+            if (!is_readable(image_base + section.virtual_address, section_size))
+            {
+                throw std::runtime_error{"[make_module_identity] A code section of the module can't be read"};
+            }
+            identity.code_hash = identity.code_hash * 31 + hash_bytes({image_base + section.virtual_address, section_size});
+        }
+
+        return identity;
+    }
+
+    template <typename T>
+    static auto read_value(std::ifstream& file, T& value) -> bool
+    {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    template <typename T>
+    static auto write_value(std::ofstream& file, const T& value) -> void
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    auto ScanCache::load(const std::filesystem::path& cache_file) -> bool
+    {
+        m_modules.clear();
+
+        std::ifstream file{cache_file, std::ios::binary};
+        if (!file)
+        {
+            return false;
+        }
+
+        std::array<char, 8> magic{};
+        uint32_t version{};
+        uint32_t num_modules{};
+        if (!read_value(file, magic) || magic != scan_cache_magic || !read_value(file, version) || version != scan_cache_version ||
+            !read_value(file, num_modules))
+        {
+            return false;
+        }
+
+        for (uint32_t module_index = 0; module_index < num_modules; ++module_index)
+        {
+            uint32_t scan_target{};
+            ModuleEntry module{};
+            uint32_t num_keys{};
+            if (!read_value(file, scan_target) || !read_value(file, module.identity.time_date_stamp) || !read_value(file, module.identity.size_of_image) ||
+                !read_value(file, module.identity.code_hash) || !read_value(file, num_keys))
+            {
+                m_modules.clear();
+                return false;
+            }
+
+            for (uint32_t key_index = 0; key_index < num_keys; ++key_index)
+            {
+                uint64_t signatures_key{};
+                uint32_t num_matches{};
+                if (!read_value(file, signatures_key) || !read_value(file, num_matches))
+                {
+                    m_modules.clear();
+                    return false;
+                }
+
+                auto& matches = module.matches[signatures_key];
+                for (uint32_t match_index = 0; match_index < num_matches; ++match_index)
+                {
+                    auto& match = matches.emplace_back();
+                    if (!read_value(file, match.signature_index) || !read_value(file, match.offset))
+                    {
+                        m_modules.clear();
+                        return false;
+                    }
+                }
+            }
+
+            m_modules.emplace(scan_target, std::move(module));
+        }
+
+        return true;
+    }
+
+    auto ScanCache::save(const std::filesystem::path& cache_file) const -> void
+    {
+        if (cache_file.has_parent_path())
+        {
+            std::filesystem::create_directories(cache_file.parent_path());
+        }
+
+        std::ofstream file{cache_file, std::ios::binary | std::ios::trunc};
+        if (!file)
+        {
+            throw std::runtime_error{"[ScanCache::save] Could not open '" + cache_file.string() + "' for writing"};
+        }
+
+        write_value(file, scan_cache_magic);
+        write_value(file, scan_cache_version);
+        write_value(file, static_cast<uint32_t>(m_modules.size()));
+        for (const auto& [scan_target, module] : m_modules)
+        {
+            write_value(file, scan_target);
+            write_value(file, module.identity.time_date_stamp);
+            write_value(file, module.identity.size_of_image);
+            write_value(file, module.identity.code_hash);
+            write_value(file, static_cast<uint32_t>(module.matches.size()));
+            for (const auto& [signatures_key, matches] : module.matches)
+            {
+                write_value(file, signatures_key);
+                write_value(file, static_cast<uint32_t>(matches.size()));
+                for (const auto& match : matches)
+                {
+                    write_value(file, match.signature_index);
+                    write_value(file, match.offset);
+                }
+            }
+        }
+
+        if (!file)
+        {
+            throw std::runtime_error{"[ScanCache::save] Could not write to '" + cache_file.string() + "'"};
+        }
+    }
+
+    auto ScanCache::find(uint32_t scan_target, const ModuleIdentity& identity, uint64_t signatures_key) const -> const std::vector<CachedMatch>*
+    {
+        auto module = m_modules.find(scan_target);
+        if (module == m_modules.end() || module->second.identity != identity)
+        {
+            return nullptr;
+        }
+
+        auto matches = module->second.matches.find(signatures_key);
+        return matches == module->second.matches.end() ? nullptr : &matches->second;
+    }
+
+    auto ScanCache::store(uint32_t scan_target, const ModuleIdentity& identity, uint64_t signatures_key, std::vector<CachedMatch> matches) -> void
+    {
+        auto& module = m_modules[scan_target];
+        if (module.identity != identity)
+        {
+            module = ModuleEntry{.identity = identity};
+        }
+
+        module.matches[signatures_key] = std::move(matches);
+    }
+} // namespace RC
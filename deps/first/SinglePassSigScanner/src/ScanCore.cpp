@@ -0,0 +1,1395 @@
+// The matching core of SinglePassScanner
+// Nothing in this file is allowed to depend on Windows, the code that queries the memory of the current process lives in SinglePassSigScanner.cpp
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include <Profiler/Profiler.hpp>
+#include <SigScanner/MultiPatternMatcher.hpp>
+#include <SigScanner/PeImage.hpp>
+#include <SigScanner/ScanKernel.hpp>
+#include <SigScanner/ScanThreadPool.hpp>
+#include <SigScanner/SinglePassSigScanner.hpp>
+
+namespace RC
+{
+    uint32_t SinglePassScanner::m_num_threads = 8;
+    SinglePassScanner::ScanMethod SinglePassScanner::m_scan_method = ScanMethod::Simd;
+    uint32_t SinglePassScanner::m_multithreading_module_size_threshold = 0x1000000;
+    uint32_t SinglePassScanner::m_chunk_size = 0x100000;
+    std::mutex SinglePassScanner::m_scanner_mutex{};
+    std::mutex SinglePassScanner::m_module_scan_stats_mutex{};
+    std::vector<ModuleScanStats> SinglePassScanner::m_module_scan_stats{};
+    std::mutex SinglePassScanner::m_scan_cache_mutex{};
+    std::filesystem::path SinglePassScanner::m_scan_cache_file{};
+    ScanCache SinglePassScanner::m_scan_cache{};
+    bool SinglePassScanner::m_scan_cache_is_dirty{};
+    std::unordered_map<const uint8_t*, ModuleIdentity> SinglePassScanner::m_module_identities{};
+    std::mutex SinglePassScanner::m_module_headers_mutex{};
+    std::unordered_map<const uint8_t*, PeHeaders> SinglePassScanner::m_module_headers{};
+
+    static auto ConvertHexCharToInt(char ch) -> int
+    {
+        if (ch >= '0' && ch <= '9') return ch - '0';
+        if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+        if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+        return -1;
+    }
+
+    auto SinglePassScanner::string_to_vector(std::string_view signature) -> std::vector<int>
+    {
+        std::vector<int> bytes;
+        char* const start = const_cast<char*>(signature.data());
+        char* const end = const_cast<char*>(signature.data()) + strlen(signature.data());
+
+        for (char* current = start; current < end; current++)
+        {
+            if (*current == '?')
+            {
+                bytes.push_back(-1);
+            }
+            else if (std::isxdigit(*current))
+            {
+                bytes.push_back(ConvertHexCharToInt(*current));
+            }
+        }
+
+        return bytes;
+    }
+
+    auto SinglePassScanner::string_to_vector(const std::vector<SignatureData>& signatures) -> std::vector<std::vector<int>>
+    {
+        std::vector<std::vector<int>> vector_of_signatures;
+        vector_of_signatures.reserve(signatures.size());
+
+        for (const auto& signature_data : signatures)
+        {
+            vector_of_signatures.emplace_back(string_to_vector(signature_data.signature));
+        }
+
+        return vector_of_signatures;
+    }
+
+    struct PatternData
+    {
+        std::vector<uint8_t> pattern{};
+        std::vector<uint8_t> mask{};
+        SignatureContainer* signature_container{};
+
+        // The byte that std::find looks for, it never contains any wildcards
+        size_t anchor_offset{};
+    };
+
+    static auto CharToByte(char symbol) -> uint8_t
+    {
+        if (symbol >= 'a' && symbol <= 'z')
+        {
+            return symbol - 'a' + 0xA;
+        }
+        else if (symbol >= 'A' && symbol <= 'Z')
+        {
+            return symbol - 'A' + 0xA;
+        }
+        else if (symbol >= '0' && symbol <= '9')
+        {
+            return symbol - '0';
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    static auto make_mask(std::string_view pattern, SignatureContainer& signature_container, const ByteFrequencies* byte_frequencies) -> PatternData
+    {
+        PatternData pattern_data{};
+
+        for (size_t i = 0; i < pattern.length(); i++)
+        {
+            char symbol = pattern[i];
+            char next_symbol = ((i + 1) < pattern.length()) ? pattern[i + 1] : 0;
+            if (symbol == ' ')
+            {
+                continue;
+            }
+
+            if (symbol == '?' && next_symbol != '?' && !std::isxdigit(next_symbol))
+            {
+                // A lone '?' is a wildcard for the whole byte
+                pattern_data.pattern.push_back(0x00);
+                pattern_data.mask.push_back(0x00);
+                continue;
+            }
+
+            // Either half of a byte can be a wildcard, for example "4?" or "?8"
+            uint8_t mask = (symbol == '?' ? 0x00 : 0xF0) | (next_symbol == '?' ? 0x00 : 0x0F);
+            uint8_t byte = CharToByte(symbol) << 4 | CharToByte(next_symbol);
+
+            pattern_data.pattern.push_back(byte & mask);
+            pattern_data.mask.push_back(mask);
+
+            ++i;
+        }
+
+        // The anchor is what std::find looks for so it can't contain any wildcards
+        // It's the first byte without wildcards, or the least common one if it's known how common each byte is
+        auto anchor = std::ranges::find(pattern_data.mask, 0xFF);
+        if (anchor == pattern_data.mask.end())
+        {
+            throw std::runtime_error{"[make_mask] A pattern must contain at least one byte without wildcards.\nPattern: " + std::string{pattern}};
+        }
+        pattern_data.anchor_offset = anchor - pattern_data.mask.begin();
+
+        if (byte_frequencies)
+        {
+            for (size_t i = pattern_data.anchor_offset + 1; i < pattern_data.mask.size(); ++i)
+            {
+                if (pattern_data.mask[i] == 0xFF && (*byte_frequencies)[pattern_data.pattern[i]] < (*byte_frequencies)[pattern_data.pattern[pattern_data.anchor_offset]])
+                {
+                    pattern_data.anchor_offset = i;
+                }
+            }
+        }
+
+        pattern_data.signature_container = &signature_container;
+        return pattern_data;
+    }
+
+    static auto format_aob_string(std::string& str) -> void
+    {
+        if (str.size() < 4)
+        {
+            return;
+        }
+        if (str[3] != '/')
+        {
+            return;
+        }
+
+        std::erase_if(str, [&](const char c) {
+            return c == ' ';
+        });
+
+        std::ranges::transform(str, str.begin(), [&str](const char c) {
+            return c == '/' ? ' ' : c;
+        });
+    }
+
+    auto SinglePassScanner::format_aob_strings(std::vector<SignatureContainer>& signature_containers) -> void
+    {
+        std::lock_guard<std::mutex> safe_scope(m_scanner_mutex);
+        for (auto& signature_container : signature_containers)
+        {
+            for (auto& signature : signature_container.signatures)
+            {
+                format_aob_string(signature.signature);
+            }
+        }
+    }
+
+    auto SinglePassScanner::pack_signatures(std::vector<SignatureContainer>& signature_containers) -> void
+    {
+        std::lock_guard<std::mutex> safe_scope(m_scanner_mutex);
+        for (auto& signature_container : signature_containers)
+        {
+            for (auto& signature : signature_container.signatures)
+            {
+                if (signature.packed_signature.empty())
+                {
+                    signature.packed_signature = make_packed_signature(signature.signature);
+                }
+            }
+        }
+    }
+
+    auto SinglePassScanner::dispatch_match(SignatureContainer& container, size_t signature_index, uint8_t* match_address, size_t match_size) -> bool
+    {
+        // Checking for the second time if the container is refusing more calls
+        // This is required when multi-threading is enabled
+        if (container.ignore)
+        {
+            return true;
+        }
+
+        // One of the signatures have found a full match so lets forward the details to the callable
+        container.index_into_signatures = signature_index;
+        container.match_address = match_address;
+        container.match_signature_size = match_size;
+
+        container.ignore = container.on_match_found(container);
+
+        // One more than the limit is kept so that the cache can tell that the limit was exceeded
+        if (container.dispatched_matches.size() <= max_cached_matches_per_container)
+        {
+            container.dispatched_matches.emplace_back(SignatureContainerLight{.index_into_signatures = signature_index, .match_address = match_address});
+        }
+
+        // Store results if the container at the containers request
+        if (container.store_results)
+        {
+            container.result_store.emplace_back(SignatureContainerLight{.index_into_signatures = signature_index, .match_address = match_address});
+        }
+
+        return container.ignore;
+    }
+
+    struct PatternOwner
+    {
+        size_t container_index{};
+        size_t signature_index{};
+    };
+
+    // Everything that a scan method needs that can be computed once per scan instead of once per chunk
+    // Read-only once prepared, so it's shared between all threads working on the same scan
+    struct SinglePassScanner::PreparedSignatures
+    {
+        ScanMethod scan_method{};
+
+        // Chunks are extended by this much minus one so that matches that start near the end of a chunk are still found
+        size_t max_signature_size{};
+
+        // ScanMethod::Scalar
+        std::vector<std::vector<std::vector<int>>> nibble_signatures{};
+
+        // ScanMethod::StdFind
+        std::vector<std::vector<PatternData>> pattern_datas{};
+
+        // ScanMethod::Simd
+        std::vector<std::vector<PackedSignature>> packed_signatures{};
+
+        // ScanMethod::MultiPattern, each pattern index maps back to its container & signature
+        MultiPatternMatcher matcher{};
+        std::vector<PatternOwner> pattern_owners{};
+    };
+
+    // Calls 'callable' with the part of every region that a match starting inside [start_address, end_address) can occupy
+    // Matches must start before 'end_address' but are allowed to extend past it as long as they're inside the region
+    // The callable returns false to stop early
+    template <typename Callable>
+    static auto for_each_region_in_range(std::span<const ScanRegion> regions, uint8_t* start_address, uint8_t* end_address, size_t max_signature_size, Callable callable)
+            -> void
+    {
+        const size_t overlap = max_signature_size > 0 ? max_signature_size - 1 : 0;
+
+        // The regions are sorted by address so the first region that ends after 'start_address' can be binary searched for
+        auto region = std::ranges::upper_bound(regions, start_address, std::less{}, &ScanRegion::end_address);
+        for (; region != regions.end() && region->start_address < end_address; ++region)
+        {
+            uint8_t* scan_start = std::max(region->start_address, start_address);
+            uint8_t* scan_end = region->end_address;
+            if (scan_end > end_address && static_cast<size_t>(scan_end - end_address) > overlap)
+            {
+                scan_end = end_address + overlap;
+            }
+
+            if (!callable(scan_start, scan_end))
+            {
+                break;
+            }
+        }
+    }
+
+    // True if every byte of [address, address + size) is inside 'regions', the range can span regions that are right next to each other
+    static auto is_inside_regions(std::span<const ScanRegion> regions, const uint8_t* address, size_t size) -> bool
+    {
+        const uint8_t* end = address + size;
+        const uint8_t* covered_until = address;
+        for (auto region = std::ranges::upper_bound(regions, address, std::less{}, &ScanRegion::end_address);
+             region != regions.end() && region->start_address <= covered_until && covered_until < end;
+             ++region)
+        {
+            covered_until = region->end_address;
+        }
+        return covered_until >= end;
+    }
+
+    static auto is_in_section(const SignatureContainer& container, std::optional<ScanSection> scan_section) -> bool
+    {
+        return !scan_section || container.get_scan_section() == *scan_section;
+    }
+
+    // Counts the bytes of evenly spaced samples of the readable parts of [start_address, end_address)
+    // A few hundred KB is plenty to tell which bytes are rare, counting all of the code of a big game would take longer than the time it saves
+    static auto sample_byte_frequencies(std::span<const ScanRegion> regions, uint8_t* start_address, uint8_t* end_address) -> ByteFrequencies
+    {
+        static constexpr size_t sample_size = 0x1000;
+        static constexpr size_t max_num_samples = 64;
+
+        ByteFrequencies byte_frequencies{};
+        const size_t range_size = end_address - start_address;
+        const size_t stride = std::max(range_size / max_num_samples, sample_size);
+        for (size_t sample_offset = 0; sample_offset < range_size; sample_offset += stride)
+        {
+            uint8_t* sample_start = start_address + sample_offset;
+            uint8_t* sample_end = start_address + std::min(sample_offset + sample_size, range_size);
+            for (auto region = std::ranges::upper_bound(regions, sample_start, std::less{}, &ScanRegion::end_address);
+                 region != regions.end() && region->start_address < sample_end;
+                 ++region)
+            {
+                uint8_t* readable_start = std::max(region->start_address, sample_start);
+                uint8_t* readable_end = std::min(region->end_address, sample_end);
+                count_byte_frequencies({readable_start, static_cast<size_t>(readable_end - readable_start)}, byte_frequencies);
+            }
+        }
+        return byte_frequencies;
+    }
+
+    auto SinglePassScanner::prepare_signatures(std::vector<SignatureContainer>& signature_containers,
+                                               std::optional<ScanSection> scan_section,
+                                               const ByteFrequencies* byte_frequencies,
+                                               ScanMethod scan_method) -> PreparedSignatures
+    {
+        ProfilerScope();
+
+        PreparedSignatures prepared{};
+        prepared.scan_method = scan_method;
+
+        // Containers that belong to a different section get an empty list of signatures so that the indices still line up
+
+        switch (prepared.scan_method)
+        {
+        case ScanMethod::Scalar:
+            // TODO: Nasty nasty nasty. Come up with a better solution... wtf
+            // It should ideally be able to work with the char* directly instead of converting to to vectors of ints
+            // The reason why working directly with the char* is a problem is that it's expensive to convert a hex char to an int
+            // This should not be done in the scan loops because this operation is very slow
+            prepared.nibble_signatures.reserve(signature_containers.size());
+            for (const auto& container : signature_containers)
+            {
+                auto& nibble_container = prepared.nibble_signatures.emplace_back();
+                if (is_in_section(container, scan_section))
+                {
+                    nibble_container = string_to_vector(container.signatures);
+                }
+                for (const auto& nibble_signature : nibble_container)
+                {
+                    prepared.max_signature_size = std::max(prepared.max_signature_size, nibble_signature.size() / 2);
+                }
+            }
+            break;
+        case ScanMethod::StdFind:
+            format_aob_strings(signature_containers);
+            for (auto& signature_container : signature_containers)
+            {
+                auto& pattern_data = prepared.pattern_datas.emplace_back();
+                if (!is_in_section(signature_container, scan_section))
+                {
+                    continue;
+                }
+
+                for (auto& signature : signature_container.signatures)
+                {
+                    const auto& data = pattern_data.emplace_back(make_mask(signature.signature, signature_container, byte_frequencies));
+                    prepared.max_signature_size = std::max(prepared.max_signature_size, data.pattern.size());
+                }
+            }
+            break;
+        case ScanMethod::Simd:
+            pack_signatures(signature_containers);
+            prepared.packed_signatures.reserve(signature_containers.size());
+            for (const auto& container : signature_containers)
+            {
+                auto& packed_container = prepared.packed_signatures.emplace_back();
+                if (!is_in_section(container, scan_section))
+                {
+                    continue;
+                }
+
+                packed_container.reserve(container.signatures.size());
+                for (const auto& signature_data : container.signatures)
+                {
+                    auto& packed_signature = packed_container.emplace_back(signature_data.packed_signature);
+                    if (byte_frequencies)
+                    {
+                        choose_rarest_anchors(packed_signature, *byte_frequencies);
+                    }
+                    prepared.max_signature_size = std::max(prepared.max_signature_size, packed_signature.size());
+                }
+            }
+            break;
+        case ScanMethod::MultiPattern:
+            // One matcher for every signature in every container
+            pack_signatures(signature_containers);
+            for (size_t container_index = 0; container_index < signature_containers.size(); ++container_index)
+            {
+                const auto& container = signature_containers[container_index];
+                if (container.ignore || !is_in_section(container, scan_section))
+                {
+                    // Either already done, for example because its matches were replayed from the scan cache, or scanned for by another job
+                    continue;
+                }
+
+                for (size_t signature_index = 0; signature_index < container.signatures.size(); ++signature_index)
+                {
+                    prepared.matcher.add_pattern(container.signatures[signature_index].packed_signature);
+                    prepared.pattern_owners.emplace_back(PatternOwner{container_index, signature_index});
+                }
+            }
+            prepared.matcher.build(byte_frequencies);
+            prepared.max_signature_size = prepared.matcher.get_max_pattern_size();
+            break;
+        }
+
+        return prepared;
+    }
+
+    auto SinglePassScanner::scan_chunk(const PreparedSignatures& prepared,
+                                       uint8_t* start_address,
+                                       uint8_t* end_address,
+                                       std::span<const ScanRegion> regions,
+                                       std::vector<SignatureContainer>& signature_containers,
+                                       const ScanCancellation& cancellation,
+                                       ChunkMatches& matches) -> void
+    {
+        switch (prepared.scan_method)
+        {
+        case ScanMethod::Scalar:
+            scan_chunk_scalar(prepared, start_address, end_address, regions, cancellation, matches);
+            break;
+        case ScanMethod::StdFind:
+            scan_chunk_stdfind(prepared, start_address, end_address, regions, cancellation, matches);
+            break;
+        case ScanMethod::Simd:
+            scan_chunk_simd(prepared, start_address, end_address, regions, signature_containers, cancellation, matches);
+            break;
+        case ScanMethod::MultiPattern:
+            scan_chunk_multipattern(prepared, start_address, end_address, regions, cancellation, matches);
+            break;
+        }
+
+        // Every scan method finds matches in a different order, sorting them here is what makes the dispatch order the same for all of them
+        std::ranges::sort(matches, [](const ChunkMatch& a, const ChunkMatch& b) {
+            if (a.match_address != b.match_address)
+            {
+                return a.match_address < b.match_address;
+            }
+            return a.container_index != b.container_index ? a.container_index < b.container_index : a.signature_index < b.signature_index;
+        });
+    }
+
+    auto SinglePassScanner::make_scan_cancellation(const std::vector<SignatureContainer>& signature_containers, std::optional<ScanSection> scan_section)
+            -> std::unique_ptr<ScanCancellation>
+    {
+        auto cancellation = std::make_unique<ScanCancellation>();
+        cancellation->is_container_done = std::make_unique<std::atomic<bool>[]>(signature_containers.size());
+        for (size_t container_index = 0; container_index < signature_containers.size(); ++container_index)
+        {
+            const auto& container = signature_containers[container_index];
+            const bool is_done = container.ignore || !is_in_section(container, scan_section);
+            cancellation->is_container_done[container_index] = is_done;
+            cancellation->num_containers_left += is_done ? 0 : 1;
+        }
+        return cancellation;
+    }
+
+    auto SinglePassScanner::dispatch_matches(const ChunkMatches& matches, std::vector<SignatureContainer>& signature_containers, ScanCancellation& cancellation)
+            -> void
+    {
+        for (const auto& match : matches)
+        {
+            if (cancellation.is_done(match.container_index))
+            {
+                continue;
+            }
+
+            if (dispatch_match(signature_containers[match.container_index], match.signature_index, match.match_address, match.match_size))
+            {
+                // Every thread that's still scanning for this container sees this the next time it checks
+                cancellation.is_container_done[match.container_index] = true;
+                --cancellation.num_containers_left;
+            }
+        }
+    }
+
+    auto SinglePassScanner::scan_regions(uint8_t* start_address,
+                                         uint8_t* end_address,
+                                         std::span<const ScanRegion> regions,
+                                         std::vector<SignatureContainer>& signature_containers,
+                                         ScanMethod scan_method) -> void
+    {
+        ProfilerScope();
+
+        const auto byte_frequencies = sample_byte_frequencies(regions, start_address, end_address);
+        const auto prepared = prepare_signatures(signature_containers, {}, &byte_frequencies, scan_method);
+        auto cancellation = make_scan_cancellation(signature_containers, {});
+        ChunkMatches matches{};
+        scan_chunk(prepared, start_address, end_address, regions, signature_containers, *cancellation, matches);
+
+        std::lock_guard<std::mutex> safe_scope(m_scanner_mutex);
+        dispatch_matches(matches, signature_containers, *cancellation);
+    }
+
+    auto SinglePassScanner::get_thread_pool() -> std::shared_ptr<ScanThreadPool>
+    {
+        static std::mutex thread_pool_mutex{};
+        static std::shared_ptr<ScanThreadPool> thread_pool{};
+
+        // The pool is kept alive between scans, it's only recreated if 'm_num_threads' has changed since the last scan
+        // Scans that are still using the old pool keep it alive until they're done
+        std::lock_guard<std::mutex> lock(thread_pool_mutex);
+        const uint32_t num_threads = std::max(m_num_threads, 1u);
+        if (!thread_pool || thread_pool->get_num_threads() != num_threads)
+        {
+            thread_pool = std::make_shared<ScanThreadPool>(num_threads);
+        }
+        return thread_pool;
+    }
+
+    static auto count_readable_bytes(std::span<const ScanRegion> regions, uint8_t* start_address, uint8_t* end_address) -> size_t
+    {
+        size_t num_bytes{};
+        for (auto region = std::ranges::upper_bound(regions, start_address, std::less{}, &ScanRegion::end_address);
+             region != regions.end() && region->start_address < end_address;
+             ++region)
+        {
+            num_bytes += std::min(region->end_address, end_address) - std::max(region->start_address, start_address);
+        }
+        return num_bytes;
+    }
+
+    auto SinglePassScanner::scan_jobs(std::span<ScanJob> jobs) -> void
+    {
+        ProfilerScope();
+
+        struct ChunkTask
+        {
+            size_t job_index{};
+            uint8_t* start_address{};
+            uint8_t* end_address{};
+        };
+
+        struct JobState
+        {
+            std::unique_ptr<ScanCancellation> cancellation{};
+
+            // The chunks of a job are consecutive tasks, 'next_task_to_dispatch' only moves forward once that chunk has been scanned
+            size_t first_task{};
+            size_t end_task{};
+            size_t next_task_to_dispatch{};
+
+            std::atomic<int64_t> scan_time{};
+            std::atomic<int64_t> first_chunk_start{std::numeric_limits<int64_t>::max()};
+            std::atomic<int64_t> last_chunk_end{std::numeric_limits<int64_t>::min()};
+            std::atomic<size_t> num_bytes_avoided{};
+        };
+
+        // Each job is split into small chunks instead of one slice per thread so that the pool can balance the work
+        // Each chunk only reports matches that start inside of it, but reads up to the longest signature past its end
+        // That way matches that straddle two chunks are found exactly once
+        const size_t chunk_size = std::max<size_t>(m_chunk_size, 0x1000);
+        std::vector<PreparedSignatures> prepared{};
+        prepared.reserve(jobs.size());
+        std::vector<JobState> job_states(jobs.size());
+        std::vector<ChunkTask> chunk_tasks{};
+        size_t total_size{};
+        for (size_t job_index = 0; job_index < jobs.size(); ++job_index)
+        {
+            auto& job = jobs[job_index];
+            auto& job_state = job_states[job_index];
+            const size_t range_size = job.end_address - job.start_address;
+            total_size += range_size;
+
+            // The frequencies are sampled per job, which byte is rare depends on whether the job covers code or data
+            const auto byte_frequencies = sample_byte_frequencies(job.regions, job.start_address, job.end_address);
+            prepared.emplace_back(prepare_signatures(*job.signature_containers, job.scan_section, &byte_frequencies, m_scan_method));
+            job_state.cancellation = make_scan_cancellation(*job.signature_containers, job.scan_section);
+            job_state.first_task = chunk_tasks.size();
+            job_state.next_task_to_dispatch = chunk_tasks.size();
+
+            if (job_state.cancellation->is_done())
+            {
+                // Nothing left to scan for in this job, for example because every match was replayed from the scan cache
+                job_state.end_task = chunk_tasks.size();
+                job_state.num_bytes_avoided = count_readable_bytes(job.regions, job.start_address, job.end_address);
+                continue;
+            }
+
+            for (uint8_t* chunk_start = job.start_address; chunk_start < job.end_address;)
+            {
+                uint8_t* chunk_end = static_cast<size_t>(job.end_address - chunk_start) > chunk_size ? chunk_start + chunk_size : job.end_address;
+                chunk_tasks.emplace_back(ChunkTask{job_index, chunk_start, chunk_end});
+                chunk_start = chunk_end;
+            }
+            job_state.end_task = chunk_tasks.size();
+        }
+
+        // Every chunk has its own buffer so that the threads never have to wait for each other while scanning
+        // The buffers are dispatched in address order as soon as every chunk before them has been dispatched, that way a container can stop the
+        // scan as soon as it's found what it's looking for instead of only after everything has been scanned
+        std::vector<ChunkMatches> chunk_matches(chunk_tasks.size());
+        std::unique_ptr<bool[]> is_chunk_scanned = std::make_unique<bool[]>(chunk_tasks.size());
+        std::mutex dispatch_mutex{};
+
+        auto scan_chunk_at = [&](size_t task_index) {
+            const auto& chunk_task = chunk_tasks[task_index];
+            const auto& job = jobs[chunk_task.job_index];
+            auto& job_state = job_states[chunk_task.job_index];
+
+            if (job_state.cancellation->is_done())
+            {
+                // Every container of the job got what it wanted from an earlier chunk
+                job_state.num_bytes_avoided += count_readable_bytes(job.regions, chunk_task.start_address, chunk_task.end_address);
+            }
+            else
+            {
+                const auto start_time = std::chrono::steady_clock::now().time_since_epoch().count();
+                scan_chunk(prepared[chunk_task.job_index],
+                           chunk_task.start_address,
+                           chunk_task.end_address,
+                           job.regions,
+                           *job.signature_containers,
+                           *job_state.cancellation,
+                           chunk_matches[task_index]);
+                const auto end_time = std::chrono::steady_clock::now().time_since_epoch().count();
+
+                job_state.scan_time += end_time - start_time;
+                for (auto first = job_state.first_chunk_start.load(); start_time < first && !job_state.first_chunk_start.compare_exchange_weak(first, start_time);)
+                {
+                }
+                for (auto last = job_state.last_chunk_end.load(); end_time > last && !job_state.last_chunk_end.compare_exchange_weak(last, end_time);)
+                {
+                }
+            }
+
+            // Callbacks are never called at the same time, even for different jobs, because they might share state
+            std::lock_guard<std::mutex> lock(dispatch_mutex);
+            is_chunk_scanned[task_index] = true;
+            for (; job_state.next_task_to_dispatch < job_state.end_task && is_chunk_scanned[job_state.next_task_to_dispatch]; ++job_state.next_task_to_dispatch)
+            {
+                auto& matches = chunk_matches[job_state.next_task_to_dispatch];
+                dispatch_matches(matches, *job.signature_containers, *job_state.cancellation);
+                ChunkMatches{}.swap(matches);
+            }
+        };
+
+        if (total_size < m_multithreading_module_size_threshold || m_num_threads <= 1)
+        {
+            // Too little memory to make it overall faster to scan with multiple threads
+            // It's still scanned in chunks because every signature is then compared against a chunk while it's still in the cache
+            for (size_t task_index = 0; task_index < chunk_tasks.size(); ++task_index)
+            {
+                scan_chunk_at(task_index);
+            }
+        }
+        else
+        {
+            get_thread_pool()->run(chunk_tasks.size(), scan_chunk_at);
+        }
+
+        for (size_t job_index = 0; job_index < jobs.size(); ++job_index)
+        {
+            const auto& job_state = job_states[job_index];
+            jobs[job_index].scan_time = std::chrono::steady_clock::duration{job_state.scan_time.load()};
+            jobs[job_index].wall_time = job_state.last_chunk_end >= job_state.first_chunk_start
+                                                ? std::chrono::steady_clock::duration{job_state.last_chunk_end - job_state.first_chunk_start}
+                                                : std::chrono::steady_clock::duration{};
+            jobs[job_index].num_bytes_avoided = job_state.num_bytes_avoided;
+        }
+    }
+
+    static auto parse_pe_headers_or_empty(uint8_t* start_address, uint8_t* end_address) -> PeHeaders
+    {
+        try
+        {
+            const size_t headers_size = std::min<size_t>(end_address - start_address, 0x1000);
+            return parse_pe_headers({start_address, headers_size});
+        }
+        catch (std::runtime_error&)
+        {
+            // Not a PE image, every section is then scanned as if it was the entire module
+            return {};
+        }
+    }
+
+    auto SinglePassScanner::get_module_headers(uint8_t* module_start, uint8_t* module_end) -> const PeHeaders&
+    {
+        // References to the elements of an unordered_map stay valid when more elements are added
+        std::lock_guard<std::mutex> lock(m_module_headers_mutex);
+        auto module_headers = m_module_headers.find(module_start);
+        if (module_headers == m_module_headers.end())
+        {
+            module_headers = m_module_headers.emplace(module_start, parse_pe_headers_or_empty(module_start, module_end)).first;
+        }
+        return module_headers->second;
+    }
+
+    static auto is_section_in(const PeSection& section, ScanSection scan_section) -> bool
+    {
+        const bool is_code = section.characteristics & (PeHeaders::SectionContainsCode | PeHeaders::SectionIsExecutable);
+        const bool is_read_only_data = !is_code && (section.characteristics & PeHeaders::SectionContainsInitializedData) &&
+                                       (section.characteristics & PeHeaders::SectionIsReadable) && !(section.characteristics & PeHeaders::SectionIsWritable);
+        return scan_section == ScanSection::All || (scan_section == ScanSection::Code && is_code) || (scan_section == ScanSection::ReadOnlyData && is_read_only_data);
+    }
+
+    // The sections that the containers that aren't ignored yet are restricted to, in the order that they first show up in
+    static auto get_scan_sections(const std::vector<SignatureContainer>& signature_containers) -> std::vector<ScanSection>
+    {
+        std::vector<ScanSection> scan_sections{};
+        for (const auto& container : signature_containers)
+        {
+            if (!container.is_ignored() && std::ranges::find(scan_sections, container.get_scan_section()) == scan_sections.end())
+            {
+                scan_sections.emplace_back(container.get_scan_section());
+            }
+        }
+        return scan_sections;
+    }
+
+    // Returns the parts of 'regions' that are inside of a section of the module that belongs to 'scan_section', sorted by address
+    // Every region is returned as-is if 'scan_section' is 'All' or if the module doesn't have any sections
+    static auto restrict_regions_to_section(uint8_t* module_start, const PeHeaders& headers, std::span<const ScanRegion> regions, ScanSection scan_section)
+            -> std::vector<ScanRegion>
+    {
+        if (scan_section == ScanSection::All || headers.sections.empty())
+        {
+            return {regions.begin(), regions.end()};
+        }
+
+        std::vector<ScanRegion> section_regions{};
+        for (const auto& section : headers.sections)
+        {
+            if (!is_section_in(section, scan_section))
+            {
+                continue;
+            }
+
+            // Only the parts of the section that are actually readable are scanned
+            uint8_t* section_start = module_start + section.virtual_address;
+            uint8_t* section_end = section_start + (section.virtual_size ? section.virtual_size : section.raw_data_size);
+            for (const auto& region : regions)
+            {
+                uint8_t* start_address = std::max(region.start_address, section_start);
+                uint8_t* end_address = std::min(region.end_address, section_end);
+                if (start_address < end_address)
+                {
+                    section_regions.emplace_back(ScanRegion{start_address, end_address});
+                }
+            }
+        }
+
+        std::ranges::sort(section_regions, std::less{}, &ScanRegion::start_address);
+        return section_regions;
+    }
+
+    auto SinglePassScanner::split_job_by_section(const ScanJob& job) -> std::vector<ScanJob>
+    {
+        const auto scan_sections = get_scan_sections(*job.signature_containers);
+
+        std::vector<ScanJob> section_jobs{};
+        if (scan_sections.empty() || (scan_sections.size() == 1 && scan_sections[0] == ScanSection::All))
+        {
+            section_jobs.emplace_back(job);
+            return section_jobs;
+        }
+
+        const auto& headers = get_module_headers(job.start_address, job.end_address);
+        for (const auto scan_section : scan_sections)
+        {
+            section_jobs.emplace_back(ScanJob{job.start_address,
+                                              job.end_address,
+                                              restrict_regions_to_section(job.start_address, headers, job.regions, scan_section),
+                                              job.signature_containers,
+                                              scan_section});
+        }
+
+        return section_jobs;
+    }
+
+    auto SinglePassScanner::scan_pe_file(std::span<const uint8_t> file_data, std::vector<SignatureContainer>& signature_containers) -> PeHeaders
+    {
+        ProfilerScope();
+
+        auto headers = parse_pe_headers(file_data);
+
+        uint8_t* file_start = const_cast<uint8_t*>(file_data.data());
+        uint8_t* file_end = file_start + file_data.size();
+
+        // Every section is scanned where its raw data is in the file, 'PeHeaders::file_offset_to_rva' translates the matches afterwards
+        // Each section is its own region so that a match can't run from the end of one section into the next, they aren't next to each other once loaded
+        std::vector<ScanJob> jobs{};
+        for (const auto scan_section : get_scan_sections(signature_containers))
+        {
+            auto& job = jobs.emplace_back(ScanJob{file_start, file_end, {}, &signature_containers, scan_section});
+            if (scan_section == ScanSection::All)
+            {
+                job.regions.emplace_back(ScanRegion{file_start, file_end});
+                continue;
+            }
+
+            for (const auto& section : headers.sections)
+            {
+                if (!is_section_in(section, scan_section) || section.raw_data_offset >= file_data.size())
+                {
+                    continue;
+                }
+
+                const size_t section_size = std::min<size_t>(section.virtual_size ? std::min(section.raw_data_size, section.virtual_size) : section.raw_data_size,
+                                                             file_data.size() - section.raw_data_offset);
+                if (section_size > 0)
+                {
+                    job.regions.emplace_back(ScanRegion{file_start + section.raw_data_offset, file_start + section.raw_data_offset + section_size});
+                }
+            }
+            std::ranges::sort(job.regions, std::less{}, &ScanRegion::start_address);
+        }
+
+        scan_jobs(jobs);
+
+        for (auto& container : signature_containers)
+        {
+            container.on_scan_finished(container);
+        }
+
+        return headers;
+    }
+
+    auto SinglePassScanner::scan_strings(uint8_t* module_start,
+                                         const PeHeaders& headers,
+                                         std::span<const ScanRegion> regions,
+                                         std::span<const std::wstring_view> strings_to_scan_for,
+                                         ScanSection scan_section) -> std::vector<std::vector<void*>>
+    {
+        ProfilerScope();
+
+        std::vector<std::vector<void*>> matches(strings_to_scan_for.size());
+
+        // Every string is an exact signature, the matcher then finds all of them in one pass
+        MultiPatternMatcher matcher{};
+        std::vector<size_t> string_indices{};
+        for (size_t string_index = 0; string_index < strings_to_scan_for.size(); ++string_index)
+        {
+            const auto string = strings_to_scan_for[string_index];
+            if (string.empty())
+            {
+                continue;
+            }
+
+            matcher.add_pattern(make_exact_signature({reinterpret_cast<const uint8_t*>(string.data()), string.size() * sizeof(wchar_t)}));
+            string_indices.emplace_back(string_index);
+        }
+
+        if (string_indices.empty())
+        {
+            return matches;
+        }
+
+        auto section_regions = restrict_regions_to_section(module_start, headers, regions, scan_section);
+        if (section_regions.empty())
+        {
+            return matches;
+        }
+
+        // Half of every wide string is usually zeroes, which are also the most common byte in data sections
+        // Anchoring on the rarest bytes keeps the matcher from stopping at every zero
+        const auto byte_frequencies = sample_byte_frequencies(section_regions, section_regions.front().start_address, section_regions.back().end_address);
+        matcher.build(&byte_frequencies);
+
+        // Neighboring regions are scanned as one so that strings that cross from one region into the next are found
+        for (size_t region_index = 0; region_index < section_regions.size();)
+        {
+            uint8_t* start_address = section_regions[region_index].start_address;
+            uint8_t* end_address = section_regions[region_index].end_address;
+            for (++region_index; region_index < section_regions.size() && section_regions[region_index].start_address == end_address; ++region_index)
+            {
+                end_address = section_regions[region_index].end_address;
+            }
+
+            matcher.scan({start_address, static_cast<size_t>(end_address - start_address)}, [&](size_t pattern_index, const uint8_t* match_address) {
+                matches[string_indices[pattern_index]].emplace_back(const_cast<uint8_t*>(match_address));
+                return false;
+            });
+        }
+
+        // The matcher reports matches in the order that their anchors are found in
+        for (auto& string_matches : matches)
+        {
+            std::ranges::sort(string_matches);
+        }
+
+        return matches;
+    }
+
+    auto SinglePassScanner::string_scan(std::span<const uint8_t> data, std::span<const std::wstring_view> strings_to_scan_for, ScanSection scan_section)
+            -> std::vector<std::vector<void*>>
+    {
+        if (data.empty())
+        {
+            return std::vector<std::vector<void*>>(strings_to_scan_for.size());
+        }
+
+        uint8_t* start_address = const_cast<uint8_t*>(data.data());
+        uint8_t* end_address = start_address + data.size();
+        const ScanRegion region{start_address, end_address};
+
+        // Not memoized like the headers of loaded modules, a different buffer can end up at the same address later
+        const auto headers = scan_section == ScanSection::All ? PeHeaders{} : parse_pe_headers_or_empty(start_address, end_address);
+        return scan_strings(start_address, headers, {&region, 1}, strings_to_scan_for, scan_section);
+    }
+
+    auto SinglePassScanner::scan_range(uint8_t* start_address,
+                                       uint8_t* end_address,
+                                       std::span<const ScanRegion> regions,
+                                       std::vector<SignatureContainer>& signature_containers) -> void
+    {
+        ScanJob job{start_address, end_address, {regions.begin(), regions.end()}, &signature_containers};
+        scan_jobs({&job, 1});
+    }
+
+    auto SinglePassScanner::record_module_scan_stats(ScanTarget scan_target, const ScanJob& job) -> void
+    {
+        std::lock_guard<std::mutex> lock(m_module_scan_stats_mutex);
+
+        auto stats = std::ranges::find(m_module_scan_stats, scan_target, &ModuleScanStats::scan_target);
+        if (stats == m_module_scan_stats.end())
+        {
+            stats = m_module_scan_stats.insert(m_module_scan_stats.end(), ModuleScanStats{.scan_target = scan_target});
+        }
+
+        ++stats->num_scans;
+        stats->num_bytes_scanned += count_readable_bytes(job.regions, job.start_address, job.end_address) - job.num_bytes_avoided;
+        stats->num_bytes_avoided += job.num_bytes_avoided;
+        stats->scan_time += job.scan_time;
+        stats->wall_time += job.wall_time;
+    }
+
+    auto SinglePassScanner::get_module_scan_stats() -> std::vector<ModuleScanStats>
+    {
+        std::vector<ModuleScanStats> module_scan_stats{};
+        {
+            std::lock_guard<std::mutex> lock(m_module_scan_stats_mutex);
+            module_scan_stats = m_module_scan_stats;
+        }
+
+        std::ranges::sort(module_scan_stats, std::greater{}, &ModuleScanStats::wall_time);
+        return module_scan_stats;
+    }
+
+    static auto make_signatures_key(const std::vector<SignatureData>& signatures) -> uint64_t
+    {
+        std::string all_signatures{};
+        for (const auto& signature_data : signatures)
+        {
+            all_signatures.append(signature_data.signature);
+            all_signatures.push_back('\0');
+        }
+        return hash_bytes({reinterpret_cast<const uint8_t*>(all_signatures.data()), all_signatures.size()});
+    }
+
+    auto SinglePassScanner::set_scan_cache_file(std::filesystem::path cache_file) -> void
+    {
+        std::lock_guard<std::mutex> lock(m_scan_cache_mutex);
+
+        m_scan_cache_file = std::move(cache_file);
+        m_scan_cache = {};
+        m_scan_cache_is_dirty = false;
+        if (!m_scan_cache_file.empty())
+        {
+            m_scan_cache.load(m_scan_cache_file);
+        }
+    }
+
+    auto SinglePassScanner::replay_cached_matches(ScanTarget scan_target, const ScanJob& job) -> void
+    {
+        ProfilerScope();
+
+        std::lock_guard<std::mutex> lock(m_scan_cache_mutex);
+        if (m_scan_cache_file.empty())
+        {
+            return;
+        }
+
+        // The key is computed before the scan because the StdFind method rewrites the signatures of the containers
+        for (auto& container : *job.signature_containers)
+        {
+            container.signatures_key = make_signatures_key(container.signatures);
+        }
+        pack_signatures(*job.signature_containers);
+
+        const auto* identity = get_module_identity(job);
+        if (!identity)
+        {
+            return;
+        }
+
+        for (auto& container : *job.signature_containers)
+        {
+            // Nothing is stored for containers without matches anymore, but older cache files can still have them
+            // Those are scanned for like any other miss, a container must never be told that there's nothing to find without a scan
+            const auto* cached_matches = m_scan_cache.find(static_cast<uint32_t>(scan_target), *identity, container.signatures_key);
+            if (!cached_matches || cached_matches->empty())
+            {
+                continue;
+            }
+
+            // Verify every match before dispatching any of them, the container must either see all of its cached matches or be scanned normally
+            std::vector<size_t> match_sizes{};
+            for (const auto& cached_match : *cached_matches)
+            {
+                if (cached_match.signature_index >= container.signatures.size())
+                {
+                    break;
+                }
+
+                const auto& signature = container.signatures[cached_match.signature_index].packed_signature;
+                const uint8_t* match_address = job.start_address + cached_match.offset;
+                if (cached_match.offset >= static_cast<size_t>(job.end_address - job.start_address) || !is_inside_regions(job.regions, match_address, signature.size()) ||
+                    !signature.matches(match_address))
+                {
+                    break;
+                }
+                match_sizes.emplace_back(signature.size());
+            }
+
+            if (match_sizes.size() != cached_matches->size())
+            {
+                continue;
+            }
+
+            for (size_t match_index = 0; match_index < cached_matches->size(); ++match_index)
+            {
+                const auto& cached_match = (*cached_matches)[match_index];
+                if (dispatch_match(container, cached_match.signature_index, job.start_address + cached_match.offset, match_sizes[match_index]))
+                {
+                    break;
+                }
+            }
+
+            container.ignore = true;
+            container.was_replayed_from_cache = true;
+        }
+    }
+
+    auto SinglePassScanner::get_module_identity(const ScanJob& job) -> const ModuleIdentity*
+    {
+        auto is_readable = [&](const uint8_t* address, size_t size) {
+            return is_inside_regions(job.regions, address, size);
+        };
+
+        if (!job.start_address || !is_readable(job.start_address, 0x1000))
+        {
+            return nullptr;
+        }
+
+        try
+        {
+            // Only the headers are parsed to check whether the memoized identity is still for the same module, the code isn't hashed again
+            auto identity = m_module_identities.find(job.start_address);
+            if (identity != m_module_identities.end())
+            {
+                const auto headers = parse_pe_headers({job.start_address, 0x1000});
+                if (headers.time_date_stamp == identity->second.time_date_stamp && headers.size_of_image == identity->second.size_of_image)
+                {
+                    return &identity->second;
+                }
+            }
+
+            return &(m_module_identities[job.start_address] = make_module_identity(job.start_address, is_readable));
+        }
+        catch (std::exception&)
+        {
+            // Not a PE image or not readable, so there's nothing to identify it by
+            m_module_identities.erase(job.start_address);
+            return nullptr;
+        }
+    }
+
+    auto SinglePassScanner::store_scan_results(ScanTarget scan_target, const ScanJob& job) -> void
+    {
+        std::lock_guard<std::mutex> lock(m_scan_cache_mutex);
+        if (m_scan_cache_file.empty())
+        {
+            return;
+        }
+
+        const auto identity = m_module_identities.find(job.start_address);
+        if (identity == m_module_identities.end())
+        {
+            return;
+        }
+
+        for (const auto& container : *job.signature_containers)
+        {
+            if (container.was_replayed_from_cache || container.dispatched_matches.empty() ||
+                container.dispatched_matches.size() > max_cached_matches_per_container)
+            {
+                continue;
+            }
+
+            std::vector<CachedMatch> cached_matches{};
+            for (const auto& match : container.dispatched_matches)
+            {
+                cached_matches.emplace_back(CachedMatch{static_cast<uint32_t>(match.index_into_signatures), static_cast<uint32_t>(match.match_address - job.start_address)});
+            }
+
+            m_scan_cache.store(static_cast<uint32_t>(scan_target), identity->second, container.signatures_key, std::move(cached_matches));
+            m_scan_cache_is_dirty = true;
+        }
+    }
+
+    auto SinglePassScanner::save_scan_cache() -> void
+    {
+        std::lock_guard<std::mutex> lock(m_scan_cache_mutex);
+        if (m_scan_cache_file.empty() || !m_scan_cache_is_dirty)
+        {
+            return;
+        }
+
+        try
+        {
+            m_scan_cache.save(m_scan_cache_file);
+            m_scan_cache_is_dirty = false;
+        }
+        catch (std::exception&)
+        {
+            // A cache that can't be written only means that the next launch has to scan again
+        }
+    }
+
+    auto SinglePassScanner::scan_module(ScanTarget scan_target, const ScanJob& job) -> void
+    {
+        replay_cached_matches(scan_target, job);
+
+        auto section_jobs = split_job_by_section(job);
+        scan_jobs(section_jobs);
+        for (const auto& section_job : section_jobs)
+        {
+            record_module_scan_stats(scan_target, section_job);
+        }
+
+        store_scan_results(scan_target, job);
+        save_scan_cache();
+
+        for (auto& container : *job.signature_containers)
+        {
+            container.on_scan_finished(container);
+        }
+    }
+
+    auto SinglePassScanner::scan_image(std::span<const uint8_t> image, ScanTarget scan_target, std::vector<SignatureContainer>& signature_containers) -> void
+    {
+        if (image.empty())
+        {
+            return;
+        }
+
+        uint8_t* start_address = const_cast<uint8_t*>(image.data());
+        uint8_t* end_address = start_address + image.size();
+        scan_module(scan_target, ScanJob{start_address, end_address, {ScanRegion{start_address, end_address}}, &signature_containers});
+    }
+
+    auto SinglePassScanner::scan(std::span<const uint8_t> data, std::vector<SignatureContainer>& signature_containers) -> void
+    {
+        if (data.empty())
+        {
+            return;
+        }
+
+        uint8_t* start_address = const_cast<uint8_t*>(data.data());
+        uint8_t* end_address = start_address + data.size();
+        const ScanRegion region{start_address, end_address};
+
+        scan_range(start_address, end_address, {&region, 1}, signature_containers);
+
+        for (auto& container : signature_containers)
+        {
+            container.on_scan_finished(container);
+        }
+    }
+
+    auto SinglePassScanner::scan_chunk_scalar(const PreparedSignatures& prepared,
+                                              uint8_t* start_address,
+                                              uint8_t* end_address,
+                                              std::span<const ScanRegion> regions,
+                                              const ScanCancellation& cancellation,
+                                              ChunkMatches& matches) -> void
+    {
+        ProfilerScope();
+
+        const auto& vector_of_sigs = prepared.nibble_signatures;
+
+        // Loop everything
+        for_each_region_in_range(regions, start_address, end_address, prepared.max_signature_size, [&](uint8_t* scan_start, uint8_t* region_end) {
+            for (uint8_t* region_start = scan_start; region_start < region_end && region_start < end_address; ++region_start)
+            {
+                if (cancellation.is_done())
+                {
+                    return false;
+                }
+
+                for (size_t container_index = 0; const auto& int_container : vector_of_sigs)
+                {
+                    for (size_t signature_index = 0; const auto& sig : int_container)
+                    {
+                        // If the container is refusing more calls then skip to the next container
+                        if (cancellation.is_done(container_index))
+                        {
+                            break;
+                        }
+
+                        // Skip if we're about to dereference uninitialized memory
+                        if (region_start + sig.size() / 2 > region_end)
+                        {
+                            break;
+                        }
+
+                        for (size_t sig_i = 0; sig_i < sig.size(); sig_i += 2)
+                        {
+                            if ((sig.at(sig_i) != -1 && sig.at(sig_i) != HI_NIBBLE(*(region_start + (sig_i / 2)))) ||
+                                (sig.at(sig_i + 1) != -1 && sig.at(sig_i + 1) != LO_NIBBLE(*(region_start + (sig_i / 2)))))
+                            {
+                                break;
+                            }
+
+                            if (sig_i + 2 == sig.size())
+                            {
+                                matches.emplace_back(ChunkMatch{region_start, container_index, signature_index, sig.size() / 2});
+                                break;
+                            }
+                        }
+
+                        ++signature_index;
+                    }
+
+                    ++container_index;
+                }
+            }
+            return true;
+        });
+    }
+
+    auto SinglePassScanner::scan_chunk_stdfind(const PreparedSignatures& prepared,
+                                               uint8_t* start_address,
+                                               uint8_t* end_address,
+                                               std::span<const ScanRegion> regions,
+                                               const ScanCancellation& cancellation,
+                                               ChunkMatches& matches) -> void
+    {
+        ProfilerScope();
+
+        // Loop everything
+        for_each_region_in_range(regions, start_address, end_address, prepared.max_signature_size, [&](uint8_t* scan_start, uint8_t* region_end) {
+            for (size_t container_index = 0; const auto& patterns : prepared.pattern_datas)
+            {
+                for (size_t signature_index = 0; const auto& pattern_data : patterns)
+                {
+                    // If the container is refusing more calls then skip to the next container
+                    if (cancellation.is_done(container_index))
+                    {
+                        break;
+                    }
+
+                    // Skip patterns that can't fit inside what's left of the region
+                    if (static_cast<size_t>(region_end - scan_start) < pattern_data.pattern.size())
+                    {
+                        ++signature_index;
+                        continue;
+                    }
+
+                    // Searching for the anchor instead of the first byte, every candidate starts 'anchor_offset' bytes before where the anchor was found
+                    const size_t anchor_offset = pattern_data.anchor_offset;
+                    auto it = scan_start + anchor_offset;
+                    auto end = std::min(end_address, region_end - pattern_data.pattern.size() + 1) + anchor_offset;
+                    uint8_t needle = pattern_data.pattern[anchor_offset];
+
+                    while (it < end && end != (it = std::find(it, end, needle)) && !cancellation.is_done(container_index))
+                    {
+                        uint8_t* candidate = it - anchor_offset;
+                        bool found = true;
+                        for (size_t pattern_offset = 0; pattern_offset < pattern_data.pattern.size(); ++pattern_offset)
+                        {
+                            if ((candidate[pattern_offset] & pattern_data.mask[pattern_offset]) != pattern_data.pattern[pattern_offset])
+                            {
+                                found = false;
+                                break;
+                            }
+                        }
+
+                        if (found)
+                        {
+                            matches.emplace_back(ChunkMatch{candidate, container_index, signature_index, pattern_data.pattern.size()});
+                        }
+
+                        it++;
+                    }
+
+                    ++signature_index;
+                }
+                ++container_index;
+            }
+            return !cancellation.is_done();
+        });
+    }
+
+    auto SinglePassScanner::scan_chunk_simd(const PreparedSignatures& prepared,
+                                            uint8_t* start_address,
+                                            uint8_t* end_address,
+                                            std::span<const ScanRegion> regions,
+                                            std::vector<SignatureContainer>& signature_containers,
+                                            const ScanCancellation& cancellation,
+                                            ChunkMatches& matches) -> void
+    {
+        ProfilerScope();
+
+        for_each_region_in_range(regions, start_address, end_address, prepared.max_signature_size, [&](uint8_t* scan_start, uint8_t* region_end) {
+            for (size_t container_index = 0; container_index < signature_containers.size(); ++container_index)
+            {
+                // If the container is refusing more calls then skip to the next container
+                if (cancellation.is_done(container_index))
+                {
+                    continue;
+                }
+
+                for (size_t signature_index = 0; signature_index < prepared.packed_signatures[container_index].size(); ++signature_index)
+                {
+                    const auto& signature = prepared.packed_signatures[container_index][signature_index];
+                    uint8_t* search_start = scan_start;
+
+                    while (search_start < end_address && !cancellation.is_done(container_index))
+                    {
+                        auto match = const_cast<uint8_t*>(ScanKernel::find({search_start, region_end}, signature));
+                        if (!match || match >= end_address)
+                        {
+                            break;
+                        }
+
+                        matches.emplace_back(ChunkMatch{match, container_index, signature_index, signature.size()});
+                        search_start = match + 1;
+                    }
+                }
+            }
+            return !cancellation.is_done();
+        });
+    }
+
+    auto SinglePassScanner::scan_chunk_multipattern(const PreparedSignatures& prepared,
+                                                    uint8_t* start_address,
+                                                    uint8_t* end_address,
+                                                    std::span<const ScanRegion> regions,
+                                                    const ScanCancellation& cancellation,
+                                                    ChunkMatches& matches) -> void
+    {
+        ProfilerScope();
+
+        const auto& matcher = prepared.matcher;
+        const auto& pattern_owners = prepared.pattern_owners;
+
+        for_each_region_in_range(regions, start_address, end_address, prepared.max_signature_size, [&](uint8_t* scan_start, uint8_t* region_end) {
+            matcher.scan({scan_start, region_end}, [&](size_t pattern_index, const uint8_t* match_address) {
+                const auto& owner = pattern_owners[pattern_index];
+                if (match_address < end_address && !cancellation.is_done(owner.container_index))
+                {
+                    matches.emplace_back(ChunkMatch{const_cast<uint8_t*>(match_address),
+                                                    owner.container_index,
+                                                    owner.signature_index,
+                                                    matcher.get_patterns()[pattern_index].size()});
+                }
+                return cancellation.is_done();
+            });
+            return !cancellation.is_done();
+        });
+    }
+} // namespace RC
@@ -0,0 +1,445 @@
+#include <atomic>
+#include <bit>
+#include <cstring>
+
+#include <SigScanner/ScanKernel.hpp>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define RC_SPSS_IS_X86 1
+#else
+#define RC_SPSS_IS_X86 0
+#endif
+
+#if RC_SPSS_IS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// MSVC allows AVX2 intrinsics in any function, Clang & GCC require the function to be marked
+#if defined(__clang__) || defined(__GNUC__)
+#define RC_SPSS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define RC_SPSS_TARGET_AVX2
+#endif
+
+namespace RC::ScanKernel
+{
+    static auto find_scalar(const uint8_t* data, size_t data_size, const PackedSignature& signature) -> const uint8_t*
+    {
+        const size_t signature_size = signature.size();
+        if (signature_size == 0 || data_size < signature_size)
+        {
+            return nullptr;
+        }
+
+        const size_t last_offset = data_size - signature_size;
+
+        if (!signature.has_anchor())
+        {
+            // Nothing to search for, every offset has to be compared
+            for (size_t offset = 0; offset <= last_offset; ++offset)
+            {
+                if (signature.matches(data + offset))
+                {
+                    return data + offset;
+                }
+            }
+            return nullptr;
+        }
+
+        const size_t anchor_offset = signature.anchor_offset;
+        const size_t second_anchor_offset = signature.second_anchor_offset;
+        const uint8_t anchor = signature.bytes[anchor_offset];
+        const uint8_t second_anchor = signature.bytes[second_anchor_offset];
+
+        // Search for the anchor byte in the range of bytes where it can appear for a match that fits inside the data
+        const uint8_t* search_start = data + anchor_offset;
+        const uint8_t* search_end = data + anchor_offset + last_offset + 1;
+        while (search_start < search_end)
+        {
+            auto found = static_cast<const uint8_t*>(std::memchr(search_start, anchor, search_end - search_start));
+            if (!found)
+            {
+                return nullptr;
+            }
+
+            const uint8_t* candidate = found - anchor_offset;
+            if (candidate[second_anchor_offset] == second_anchor && signature.matches(candidate))
+            {
+                return candidate;
+            }
+
+            search_start = found + 1;
+        }
+
+        return nullptr;
+    }
+
+    static auto find_first_of_scalar(const uint8_t* data, size_t data_size, const ByteSet& bytes) -> const uint8_t*
+    {
+        const auto& values = bytes.get_values();
+        if (values.size() == 1)
+        {
+            return static_cast<const uint8_t*>(std::memchr(data, values[0], data_size));
+        }
+
+        for (size_t offset = 0; offset < data_size; ++offset)
+        {
+            if (bytes.contains(data[offset]))
+            {
+                return data + offset;
+            }
+        }
+
+        return nullptr;
+    }
+
+#if RC_SPSS_IS_X86
+    static auto matches_sse2(const uint8_t* data, const PackedSignature& signature) -> bool
+    {
+        const size_t signature_size = signature.size();
+        size_t i = 0;
+        for (; i + 16 <= signature_size; i += 16)
+        {
+            const __m128i memory = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(signature.mask.data() + i));
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(signature.bytes.data() + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(memory, mask), bytes)) != 0xFFFF)
+            {
+                return false;
+            }
+        }
+
+        for (; i < signature_size; ++i)
+        {
+            if ((data[i] & signature.mask[i]) != signature.bytes[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static auto find_sse2(const uint8_t* data, size_t data_size, const PackedSignature& signature) -> const uint8_t*
+    {
+        const size_t signature_size = signature.size();
+        if (!signature.has_anchor() || data_size < signature_size)
+        {
+            return find_scalar(data, data_size, signature);
+        }
+
+        const size_t anchor_offset = signature.anchor_offset;
+        const size_t second_anchor_offset = signature.second_anchor_offset;
+        const __m128i anchor = _mm_set1_epi8(static_cast<char>(signature.bytes[anchor_offset]));
+        const __m128i second_anchor = _mm_set1_epi8(static_cast<char>(signature.bytes[second_anchor_offset]));
+
+        // Every offset in [offset, offset + 16) is a potential start of a match
+        // The loads never go past the end of the data because both anchors are inside the signature
+        const size_t num_candidate_offsets = data_size - signature_size + 1;
+        size_t offset = 0;
+        for (; offset + 16 <= num_candidate_offsets; offset += 16)
+        {
+            const __m128i first_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset + anchor_offset));
+            const __m128i second_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset + second_anchor_offset));
+            auto candidates = static_cast<uint32_t>(
+                    _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(anchor, first_block), _mm_cmpeq_epi8(second_anchor, second_block))));
+
+            while (candidates)
+            {
+                const uint8_t* candidate = data + offset + std::countr_zero(candidates);
+                if (matches_sse2(candidate, signature))
+                {
+                    return candidate;
+                }
+                candidates &= candidates - 1;
+            }
+        }
+
+        return find_scalar(data + offset, data_size - offset, signature);
+    }
+
+    RC_SPSS_TARGET_AVX2 static auto matches_avx2(const uint8_t* data, const PackedSignature& signature) -> bool
+    {
+        const size_t signature_size = signature.size();
+        size_t i = 0;
+        for (; i + 32 <= signature_size; i += 32)
+        {
+            const __m256i memory = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(signature.mask.data() + i));
+            const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(signature.bytes.data() + i));
+            if (static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(memory, mask), bytes))) != 0xFFFFFFFF)
+            {
+                return false;
+            }
+        }
+
+        for (; i + 16 <= signature_size; i += 16)
+        {
+            const __m128i memory = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(signature.mask.data() + i));
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(signature.bytes.data() + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(memory, mask), bytes)) != 0xFFFF)
+            {
+                return false;
+            }
+        }
+
+        for (; i < signature_size; ++i)
+        {
+            if ((data[i] & signature.mask[i]) != signature.bytes[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    RC_SPSS_TARGET_AVX2 static auto find_avx2(const uint8_t* data, size_t data_size, const PackedSignature& signature) -> const uint8_t*
+    {
+        const size_t signature_size = signature.size();
+        if (!signature.has_anchor() || data_size < signature_size)
+        {
+            return find_scalar(data, data_size, signature);
+        }
+
+        const size_t anchor_offset = signature.anchor_offset;
+        const size_t second_anchor_offset = signature.second_anchor_offset;
+        const __m256i anchor = _mm256_set1_epi8(static_cast<char>(signature.bytes[anchor_offset]));
+        const __m256i second_anchor = _mm256_set1_epi8(static_cast<char>(signature.bytes[second_anchor_offset]));
+
+        const size_t num_candidate_offsets = data_size - signature_size + 1;
+        size_t offset = 0;
+        for (; offset + 32 <= num_candidate_offsets; offset += 32)
+        {
+            const __m256i first_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset + anchor_offset));
+            const __m256i second_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset + second_anchor_offset));
+            auto candidates = static_cast<uint32_t>(
+                    _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(anchor, first_block), _mm256_cmpeq_epi8(second_anchor, second_block))));
+
+            while (candidates)
+            {
+                const uint8_t* candidate = data + offset + std::countr_zero(candidates);
+                if (matches_avx2(candidate, signature))
+                {
+                    return candidate;
+                }
+                candidates &= candidates - 1;
+            }
+        }
+
+        return find_sse2(data + offset, data_size - offset, signature);
+    }
+
+    static auto find_first_of_sse2(const uint8_t* data, size_t data_size, const ByteSet& bytes) -> const uint8_t*
+    {
+        const auto& values = bytes.get_values();
+        if (values.size() <= 1 || values.size() > max_simd_byte_set_size)
+        {
+            return find_first_of_scalar(data, data_size, bytes);
+        }
+
+        __m128i needles[max_simd_byte_set_size]{};
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            needles[i] = _mm_set1_epi8(static_cast<char>(values[i]));
+        }
+
+        size_t offset = 0;
+        for (; offset + 16 <= data_size; offset += 16)
+        {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+            __m128i any_equal = _mm_cmpeq_epi8(block, needles[0]);
+            for (size_t i = 1; i < values.size(); ++i)
+            {
+                any_equal = _mm_or_si128(any_equal, _mm_cmpeq_epi8(block, needles[i]));
+            }
+
+            if (const auto hits = static_cast<uint32_t>(_mm_movemask_epi8(any_equal)); hits)
+            {
+                return data + offset + std::countr_zero(hits);
+            }
+        }
+
+        return find_first_of_scalar(data + offset, data_size - offset, bytes);
+    }
+
+    RC_SPSS_TARGET_AVX2 static auto find_first_of_avx2(const uint8_t* data, size_t data_size, const ByteSet& bytes) -> const uint8_t*
+    {
+        const auto& values = bytes.get_values();
+        if (values.size() <= 1 || values.size() > max_simd_byte_set_size)
+        {
+            return find_first_of_scalar(data, data_size, bytes);
+        }
+
+        __m256i needles[max_simd_byte_set_size]{};
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            needles[i] = _mm256_set1_epi8(static_cast<char>(values[i]));
+        }
+
+        size_t offset = 0;
+        for (; offset + 32 <= data_size; offset += 32)
+        {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+            __m256i any_equal = _mm256_cmpeq_epi8(block, needles[0]);
+            for (size_t i = 1; i < values.size(); ++i)
+            {
+                any_equal = _mm256_or_si256(any_equal, _mm256_cmpeq_epi8(block, needles[i]));
+            }
+
+            if (const auto hits = static_cast<uint32_t>(_mm256_movemask_epi8(any_equal)); hits)
+            {
+                return data + offset + std::countr_zero(hits);
+            }
+        }
+
+        return find_first_of_sse2(data + offset, data_size - offset, bytes);
+    }
+
+    static auto cpuid(uint32_t leaf, uint32_t sub_leaf, uint32_t (&registers)[4]) -> void
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int raw_registers[4]{};
+        __cpuidex(raw_registers, static_cast<int>(leaf), static_cast<int>(sub_leaf));
+        for (size_t i = 0; i < 4; ++i)
+        {
+            registers[i] = static_cast<uint32_t>(raw_registers[i]);
+        }
+#else
+        __cpuid_count(leaf, sub_leaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+    }
+
+    static auto xgetbv0() -> uint64_t
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return _xgetbv(0);
+#else
+        uint32_t eax{};
+        uint32_t edx{};
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+    }
+
+    static auto detect_best_instruction_set() -> InstructionSet
+    {
+        uint32_t registers[4]{};
+        cpuid(0, 0, registers);
+        const uint32_t max_leaf = registers[0];
+
+        cpuid(1, 0, registers);
+        const bool has_sse2 = registers[3] & (1u << 26);
+        const bool has_osxsave = registers[2] & (1u << 27);
+        const bool has_avx = registers[2] & (1u << 28);
+
+        // The OS must also save the upper halves of the YMM registers on context switches
+        const bool os_supports_avx = has_osxsave && has_avx && (xgetbv0() & 0x6) == 0x6;
+
+        if (os_supports_avx && max_leaf >= 7)
+        {
+            cpuid(7, 0, registers);
+            if (registers[1] & (1u << 5))
+            {
+                return InstructionSet::AVX2;
+            }
+        }
+
+        return has_sse2 ? InstructionSet::SSE2 : InstructionSet::Scalar;
+    }
+#else
+    static auto detect_best_instruction_set() -> InstructionSet
+    {
+        return InstructionSet::Scalar;
+    }
+#endif
+
+    static auto is_supported(InstructionSet instruction_set) -> bool
+    {
+        return static_cast<int>(instruction_set) <= static_cast<int>(get_best_supported_instruction_set());
+    }
+
+    static std::atomic<InstructionSet> s_instruction_set{get_best_supported_instruction_set()};
+
+    auto instruction_set_to_string(InstructionSet instruction_set) -> const char*
+    {
+        switch (instruction_set)
+        {
+        case InstructionSet::Scalar:
+            return "Scalar";
+        case InstructionSet::SSE2:
+            return "SSE2";
+        case InstructionSet::AVX2:
+            return "AVX2";
+        }
+
+        return "Unknown";
+    }
+
+    auto get_best_supported_instruction_set() -> InstructionSet
+    {
+        static const InstructionSet best_instruction_set = detect_best_instruction_set();
+        return best_instruction_set;
+    }
+
+    auto get_instruction_set() -> InstructionSet
+    {
+        return s_instruction_set.load(std::memory_order_relaxed);
+    }
+
+    auto set_instruction_set(InstructionSet instruction_set) -> void
+    {
+        s_instruction_set.store(is_supported(instruction_set) ? instruction_set : get_best_supported_instruction_set(), std::memory_order_relaxed);
+    }
+
+    auto find(std::span<const uint8_t> data, const PackedSignature& signature) -> const uint8_t*
+    {
+        return find(data, signature, get_instruction_set());
+    }
+
+    auto find(std::span<const uint8_t> data, const PackedSignature& signature, InstructionSet instruction_set) -> const uint8_t*
+    {
+        if (!is_supported(instruction_set))
+        {
+            instruction_set = get_best_supported_instruction_set();
+        }
+
+        switch (instruction_set)
+        {
+#if RC_SPSS_IS_X86
+        case InstructionSet::AVX2:
+            return find_avx2(data.data(), data.size(), signature);
+        case InstructionSet::SSE2:
+            return find_sse2(data.data(), data.size(), signature);
+#endif
+        default:
+            return find_scalar(data.data(), data.size(), signature);
+        }
+    }
+
+    auto find_first_of(std::span<const uint8_t> data, const ByteSet& bytes) -> const uint8_t*
+    {
+        if (bytes.empty() || data.empty())
+        {
+            return nullptr;
+        }
+
+        switch (get_instruction_set())
+        {
+#if RC_SPSS_IS_X86
+        case InstructionSet::AVX2:
+            return find_first_of_avx2(data.data(), data.size(), bytes);
+        case InstructionSet::SSE2:
+            return find_first_of_sse2(data.data(), data.size(), bytes);
+#endif
+        default:
+            return find_first_of_scalar(data.data(), data.size(), bytes);
+        }
+    }
+} // namespace RC::ScanKernel
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <utility>
+
+#include <Profiler/Profiler.hpp>
+#include <SigScanner/ScanThreadPool.hpp>
+
+namespace RC
+{
+    ScanThreadPool::ScanThreadPool(uint32_t num_threads)
+    {
+        num_threads = std::max(num_threads, 1u);
+
+        for (uint32_t i = 0; i < num_threads; ++i)
+        {
+            m_queues.emplace_back(std::make_unique<TaskQueue>());
+        }
+
+        for (uint32_t i = 1; i < num_threads; ++i)
+        {
+            m_threads.emplace_back(&ScanThreadPool::thread_main, this, i);
+        }
+    }
+
+    ScanThreadPool::~ScanThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_state_mutex);
+            m_is_stopping = true;
+        }
+        m_work_available.notify_all();
+
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    auto ScanThreadPool::run(size_t num_tasks, const Task& task) -> void
+    {
+        if (num_tasks == 0)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> run_lock(m_run_mutex);
+
+        // Every queue starts out with a contiguous block of tasks so that each thread mostly works on memory that's next to each other
+        const size_t num_queues = m_queues.size();
+        for (size_t queue_index = 0; queue_index < num_queues; ++queue_index)
+        {
+            std::lock_guard<std::mutex> queue_lock(m_queues[queue_index]->mutex);
+            for (size_t task_index = num_tasks * queue_index / num_queues; task_index < num_tasks * (queue_index + 1) / num_queues; ++task_index)
+            {
+                m_queues[queue_index]->task_indices.emplace_back(task_index);
+            }
+        }
+
+        m_num_remaining_tasks = num_tasks;
+        {
+            std::lock_guard<std::mutex> lock(m_state_mutex);
+            m_task = &task;
+            m_exception = nullptr;
+            ++m_generation;
+        }
+        m_work_available.notify_all();
+
+        work_until_out_of_tasks(0, task);
+
+        // Threads that picked up this generation must be done with 'task' before it goes out of scope
+        std::exception_ptr exception{};
+        {
+            std::unique_lock<std::mutex> lock(m_state_mutex);
+            m_work_finished.wait(lock, [&] {
+                return m_num_remaining_tasks == 0 && m_num_active_threads == 0;
+            });
+            m_task = nullptr;
+            exception = std::exchange(m_exception, nullptr);
+        }
+
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    auto ScanThreadPool::thread_main(size_t queue_index) -> void
+    {
+        ProfilerSetThreadName("UE4SS-ScannerWorkThread");
+
+        uint64_t last_generation{};
+        while (true)
+        {
+            const Task* task{};
+            {
+                std::unique_lock<std::mutex> lock(m_state_mutex);
+                m_work_available.wait(lock, [&] {
+                    return m_is_stopping || (m_generation != last_generation && m_task);
+                });
+
+                if (m_is_stopping)
+                {
+                    return;
+                }
+
+                last_generation = m_generation;
+                task = m_task;
+                ++m_num_active_threads;
+            }
+
+            work_until_out_of_tasks(queue_index, *task);
+
+            {
+                std::lock_guard<std::mutex> lock(m_state_mutex);
+                --m_num_active_threads;
+            }
+            m_work_finished.notify_all();
+        }
+    }
+
+    auto ScanThreadPool::work_until_out_of_tasks(size_t queue_index, const Task& task) -> void
+    {
+        size_t task_index{};
+        while (pop_task(queue_index, task_index))
+        {
+            try
+            {
+                task(task_index);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(m_state_mutex);
+                if (!m_exception)
+                {
+                    m_exception = std::current_exception();
+                }
+            }
+
+            if (--m_num_remaining_tasks == 0)
+            {
+                // Taking the lock makes sure that 'run' is either not waiting yet or is already waiting, otherwise the notification could be lost
+                std::lock_guard<std::mutex> lock(m_state_mutex);
+                m_work_finished.notify_all();
+            }
+        }
+    }
+
+    auto ScanThreadPool::pop_task(size_t queue_index, size_t& task_index) -> bool
+    {
+        // Tasks are taken from the front of our own queue, which keeps this thread moving forward through memory
+        {
+            auto& queue = *m_queues[queue_index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.task_indices.empty())
+            {
+                task_index = queue.task_indices.front();
+                queue.task_indices.pop_front();
+                return true;
+            }
+        }
+
+        // Tasks are stolen from the back of other queues, which is the memory that their owners would've gotten to last
+        for (size_t offset = 1; offset < m_queues.size(); ++offset)
+        {
+            auto& queue = *m_queues[(queue_index + offset) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.task_indices.empty())
+            {
+                task_index = queue.task_indices.back();
+                queue.task_indices.pop_back();
+                return true;
+            }
+        }
+
+        return false;
+    }
+} // namespace RC
@@ -1,6 +1,8 @@
+#include <condition_variable>
+#include <deque>
 #include <format>
-#include <future>
 #include <regex>
+#include <thread>
 
 #define NOMINMAX
 #include <Windows.h>
@@ -13,11 +15,8 @@ namespace RC
 {
     ScanTargetArray SigScannerStaticData::m_modules_info;
     bool SigScannerStaticData::m_is_modular;
-
-    uint32_t SinglePassScanner::m_num_threads = 8;
-    SinglePassScanner::ScanMethod SinglePassScanner::m_scan_method = ScanMethod::Scalar;
-    uint32_t SinglePassScanner::m_multithreading_module_size_threshold = 0x1000000;
-    std::mutex SinglePassScanner::m_scanner_mutex{};
+    std::mutex SinglePassScanner::m_pending_containers_mutex{};
+    std::vector<SinglePassScanner::PendingContainers> SinglePassScanner::m_pending_containers{};
 
     auto WIN_MODULEINFO::operator=(MODULEINFO other) -> WIN_MODULEINFO&
     {
@@ -316,192 +315,90 @@ namespace RC
         return ScanTargetToString(static_cast<ScanTarget>(scan_target));
     }
 
-    static auto ConvertHexCharToInt(char ch) -> int
+    // Returns the committed & readable regions that overlap [start_address, end_address)
+    // The regions aren't clipped, matches are allowed to extend past 'end_address' as long as they're inside a region
+    static auto get_readable_regions(uint8_t* start_address, uint8_t* end_address) -> std::vector<ScanRegion>
     {
-        if (ch >= '0' && ch <= '9') return ch - '0';
-        if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
-        if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
-        return -1;
-    }
+        std::vector<ScanRegion> regions{};
 
-    auto SinglePassScanner::string_to_vector(std::string_view signature) -> std::vector<int>
-    {
-        std::vector<int> bytes;
-        char* const start = const_cast<char*>(signature.data());
-        char* const end = const_cast<char*>(signature.data()) + strlen(signature.data());
+        MEMORY_BASIC_INFORMATION memory_info{};
+        DWORD protect_flags = PAGE_GUARD | PAGE_NOCACHE | PAGE_NOACCESS;
 
-        for (char* current = start; current < end; current++)
+        uint8_t* i = start_address;
+        while (i < end_address && VirtualQuery(i, &memory_info, sizeof(memory_info)))
         {
-            if (*current == '?')
-            {
-                bytes.push_back(-1);
-            }
-            else if (std::isxdigit(*current))
+            uint8_t* region_start = static_cast<uint8_t*>(memory_info.BaseAddress);
+            uint8_t* region_end = region_start + memory_info.RegionSize;
+            i = region_end;
+
+            // If the "protect flags" or state are undesired for this region then skip to the next region
+            if (memory_info.Protect & protect_flags || !(memory_info.State & MEM_COMMIT))
             {
-                bytes.push_back(ConvertHexCharToInt(*current));
+                continue;
             }
+
+            regions.emplace_back(ScanRegion{region_start, region_end});
         }
 
-        return bytes;
+        return regions;
     }
 
-    auto SinglePassScanner::string_to_vector(const std::vector<SignatureData>& signatures) -> std::vector<std::vector<int>>
+    auto SinglePassScanner::string_scan(std::wstring_view string_to_scan_for, ScanTarget scan_target) -> void*
     {
-        std::vector<std::vector<int>> vector_of_signatures;
-        vector_of_signatures.reserve(signatures.size());
-
-        for (const auto& signature_data : signatures)
-        {
-            vector_of_signatures.emplace_back(string_to_vector(signature_data.signature));
-        }
-
-        return vector_of_signatures;
+        const auto matches = string_scan(std::span{&string_to_scan_for, 1}, scan_target);
+        return matches[0].empty() ? nullptr : matches[0][0];
     }
 
-    auto SinglePassScanner::string_scan(std::wstring_view string_to_scan_for, ScanTarget scan_target) -> void*
+    auto SinglePassScanner::string_scan(std::span<const std::wstring_view> strings_to_scan_for, ScanTarget scan_target, ScanSection scan_section)
+            -> std::vector<std::vector<void*>>
     {
         auto module = SigScannerStaticData::m_modules_info[scan_target];
 
         auto start_address = static_cast<uint8_t*>(module.lpBaseOfDll);
         auto end_address = static_cast<uint8_t*>(module.lpBaseOfDll) + module.SizeOfImage;
 
+        const auto regions = get_readable_regions(start_address, end_address);
+        return scan_strings(start_address, get_module_headers(start_address, end_address), regions, strings_to_scan_for, scan_section);
+    }
+
+    auto SinglePassScanner::is_readable(const uint8_t* address, size_t size) -> bool
+    {
         MEMORY_BASIC_INFORMATION memory_info{};
         DWORD protect_flags = PAGE_GUARD | PAGE_NOCACHE | PAGE_NOACCESS;
 
-        void* address_found{};
-
-        for (uint8_t* i = start_address; i < end_address; ++i)
+        // The range can cross into the next region, in which case that region has to be readable as well
+        const uint8_t* end_address = address + size;
+        for (const uint8_t* i = address; i < end_address;)
         {
-            if (VirtualQuery(i, &memory_info, sizeof(memory_info)))
+            if (!VirtualQuery(i, &memory_info, sizeof(memory_info)) || memory_info.Protect & protect_flags || !(memory_info.State & MEM_COMMIT))
             {
-                if (memory_info.Protect & protect_flags || !(memory_info.State & MEM_COMMIT))
-                {
-                    i += memory_info.RegionSize;
-                    continue;
-                }
-
-                uint8_t* region_end = static_cast<uint8_t*>(memory_info.BaseAddress) + memory_info.RegionSize;
-
-                for (uint8_t* region_start = static_cast<uint8_t*>(memory_info.BaseAddress); region_start < region_end; ++region_start)
-                {
-                    if (region_start > end_address || region_start + string_to_scan_for.size() > end_address)
-                    {
-                        break;
-                    }
-
-                    std::wstring_view maybe_string = std::wstring_view((const wchar_t*)region_start, string_to_scan_for.size());
-                    if (maybe_string == string_to_scan_for)
-                    {
-                        address_found = region_start;
-                        break;
-                    }
-                }
-
-                if (address_found)
-                {
-                    break;
-                }
-                i = static_cast<uint8_t*>(memory_info.BaseAddress) + memory_info.RegionSize;
+                return false;
             }
+            i = static_cast<const uint8_t*>(memory_info.BaseAddress) + memory_info.RegionSize;
         }
-
-        return address_found;
-    }
-
-    struct PatternData
-    {
-        std::vector<uint8_t> pattern{};
-        std::vector<uint8_t> mask{};
-        SignatureContainer* signature_container{};
-    };
-
-    static auto CharToByte(char symbol) -> uint8_t
-    {
-        if (symbol >= 'a' && symbol <= 'z')
-        {
-            return symbol - 'a' + 0xA;
-        }
-        else if (symbol >= 'A' && symbol <= 'Z')
-        {
-            return symbol - 'A' + 0xA;
-        }
-        else if (symbol >= '0' && symbol <= '9')
-        {
-            return symbol - '0';
-        }
-        else
-        {
-            return 0;
-        }
+        return true;
     }
 
-    static auto make_mask(std::string_view pattern, SignatureContainer& signature_container, const size_t data_size) -> PatternData
+    // Null addresses mean the start or the end of the address space of the process
+    static auto get_readable_process_regions(uint8_t*& start_address, uint8_t*& end_address, SYSTEM_INFO& info) -> std::vector<ScanRegion>
     {
-        PatternData pattern_data{};
-
-        if (pattern.length() < 1 || pattern[0] == '?')
-        {
-            throw std::runtime_error{std::format("[make_mask] A pattern cannot start with a wildcard.\nPattern: {}", pattern)};
-        }
-
-        for (size_t i = 0; i < pattern.length(); i++)
+        if (!start_address)
         {
-            char symbol = pattern[i];
-            char next_symbol = ((i + 1) < pattern.length()) ? pattern[i + 1] : 0;
-            if (symbol == ' ')
-            {
-                continue;
-            }
-
-            if (symbol == '?')
-            {
-                pattern_data.pattern.push_back(0x00);
-                pattern_data.mask.push_back(0x00);
-
-                if (next_symbol == '?')
-                {
-                    ++i;
-                }
-                continue;
-            }
-
-            uint8_t byte = CharToByte(symbol) << 4 | CharToByte(next_symbol);
-
-            pattern_data.pattern.push_back(byte);
-            pattern_data.mask.push_back(0xff);
-
-            ++i;
+            start_address = static_cast<uint8_t*>(info.lpMinimumApplicationAddress);
         }
-
-        static constexpr size_t Alignment = 32;
-        size_t count = (size_t)std::ceil((float)data_size / Alignment);
-        size_t padding_size = count * Alignment - data_size;
-
-        for (size_t i = 0; i < padding_size; i++)
+        if (!end_address)
         {
-            pattern_data.pattern.push_back(0x00);
-            pattern_data.mask.push_back(0x00);
+            end_address = static_cast<uint8_t*>(info.lpMaximumApplicationAddress);
         }
 
-        pattern_data.signature_container = &signature_container;
-        return pattern_data;
+        return get_readable_regions(start_address, end_address);
     }
 
     auto SinglePassScanner::scanner_work_thread(uint8_t* start_address, uint8_t* end_address, SYSTEM_INFO& info, std::vector<SignatureContainer>& signature_containers)
             -> void
     {
-        ProfilerSetThreadName("UE4SS-ScannerWorkThread");
-        ProfilerScope();
-
-        switch (m_scan_method)
-        {
-        case ScanMethod::Scalar:
-            scanner_work_thread_scalar(start_address, end_address, info, signature_containers);
-            break;
-        case ScanMethod::StdFind:
-            scanner_work_thread_stdfind(start_address, end_address, info, signature_containers);
-            break;
-        }
+        auto regions = get_readable_process_regions(start_address, end_address, info);
+        scan_regions(start_address, end_address, regions, signature_containers, m_scan_method);
     }
 
     auto SinglePassScanner::scanner_work_thread_scalar(uint8_t* start_address,
@@ -509,370 +406,337 @@ namespace RC
                                                        SYSTEM_INFO& info,
                                                        std::vector<SignatureContainer>& signature_containers) -> void
     {
-        ProfilerScope();
-        if (!start_address)
-        {
-            start_address = static_cast<uint8_t*>(info.lpMinimumApplicationAddress);
-        }
-        if (!end_address)
+        auto regions = get_readable_process_regions(start_address, end_address, info);
+        scan_regions(start_address, end_address, regions, signature_containers, ScanMethod::Scalar);
+    }
+
+    auto SinglePassScanner::scanner_work_thread_stdfind(uint8_t* start_address,
+                                                        uint8_t* end_address,
+                                                        SYSTEM_INFO& info,
+                                                        std::vector<SignatureContainer>& signature_containers) -> void
+    {
+        auto regions = get_readable_process_regions(start_address, end_address, info);
+        scan_regions(start_address, end_address, regions, signature_containers, ScanMethod::StdFind);
+    }
+
+    auto SinglePassScanner::start_scan(SignatureContainerMap& signature_containers) -> void
+    {
+        // If not modular then the containers get merged into one scan target
+        // That way there are no extra scans
+        // If modular then loop the containers and retrieve the scan target for each and scan each module separately
+
+        if (!SigScannerStaticData::m_is_modular)
         {
-            start_address = static_cast<uint8_t*>(info.lpMaximumApplicationAddress);
-        }
+            MODULEINFO merged_module_info{};
+            std::vector<SignatureContainer> merged_containers;
 
-        MEMORY_BASIC_INFORMATION memory_info{};
-        DWORD protect_flags = PAGE_GUARD | PAGE_NOCACHE | PAGE_NOACCESS;
+            for (const auto& [scan_target, outer_container] : signature_containers)
+            {
+                merged_module_info = *std::bit_cast<MODULEINFO*>(&SigScannerStaticData::m_modules_info[scan_target]);
+                for (const auto& signature_container : outer_container)
+                {
+                    merged_containers.emplace_back(signature_container);
+                }
+            }
 
-        // TODO: Nasty nasty nasty. Come up with a better solution... wtf
-        // It should ideally be able to work with the char* directly instead of converting to to vectors of ints
-        // The reason why working directly with the char* is a problem is that it's expensive to convert a hex char to an int
-        // Also look at the comments below
-        std::vector<std::vector<std::vector<int>>> vector_of_sigs;
+            if (merged_containers.empty())
+            {
+                throw std::runtime_error{"[SinglePassScanner::start_scan] Could not merge containers. Either there were not containers to merge or there was "
+                                         "an internal error."};
+            }
 
-        // const std::regex signature_validity_regex(R"(^([0-9A-F\?] )([0-9A-F\?]\/[0-9A-F\?] )*([0-9A-F\?])$)");
+            uint8_t* module_start_address = static_cast<uint8_t*>(merged_module_info.lpBaseOfDll);
+            uint8_t* module_end_address = static_cast<uint8_t*>(module_start_address + merged_module_info.SizeOfImage);
 
-        // Making a vector here to be identical to the SignatureContainer vector
-        // The difference is that it stores the sigs converted from char* to std::vector<int>
-        // This makes it easier to work with even if it's wasteful
-        // This should not be done in the nested loops below because this operation is very slow
-        vector_of_sigs.reserve(signature_containers.size());
-        for (const auto& container : signature_containers)
-        {
-            // Only continue if the signature is properly formatted
-            // Bring this code back when both:
-            // A. The regex has been updated to take into consideration.
-            // B. The threads have been synced before the scan to verify that all threads are scanning for valid signatures.
-            // for (const auto& signature_data : container.signatures)
-            //{
-            //    if (!std::regex_search(signature_data.signature, signature_validity_regex))
-            //    {
-            //        throw std::runtime_error{std::format("[SinglePassSigScanner::start_scan] A signature is improperly formatted. Signature: {}", signature_data.signature)};
-            //    }
-            //}
-
-            // Signatures for this container
-            vector_of_sigs.emplace_back(string_to_vector(container.signatures));
-        }
+            ScanJob job{module_start_address, module_end_address, get_readable_regions(module_start_address, module_end_address), &merged_containers};
 
-        // Loop everything
-        for (uint8_t* i = start_address; i < end_address; ++i)
+            // Every scan target is part of the main executable when the game isn't modular
+            scan_module(ScanTarget::MainExe, job);
+        }
+        else
         {
-            // Populate memory_info if VirtualQuery doesn't fail
-            if (VirtualQuery(i, &memory_info, sizeof(memory_info)))
+            // Every module is scanned at the same time, the chunks of all modules are handed to the thread pool together
+            // That way the threads are kept busy even though most modules are far too small to be worth splitting up on their own
+            std::vector<ScanTarget> scan_targets{};
+            std::vector<ScanJob> jobs{};
+            std::vector<ScanTarget> section_job_scan_targets{};
+            std::vector<ScanJob> section_jobs{};
+            for (auto& [scan_target, signature_container] : signature_containers)
             {
-                // If the "protect flags" or state are undesired for this region then skip to the next iteration of the loop
-                if (memory_info.Protect & protect_flags || !(memory_info.State & MEM_COMMIT))
+                uint8_t* module_start_address = static_cast<uint8_t*>(SigScannerStaticData::m_modules_info[scan_target].lpBaseOfDll);
+                uint8_t* module_end_address = static_cast<uint8_t*>(module_start_address + SigScannerStaticData::m_modules_info[scan_target].SizeOfImage);
+
+                scan_targets.emplace_back(scan_target);
+                auto& job = jobs.emplace_back(
+                        ScanJob{module_start_address, module_end_address, get_readable_regions(module_start_address, module_end_address), &signature_container});
+                replay_cached_matches(scan_target, job);
+
+                for (auto& section_job : split_job_by_section(job))
                 {
-                    i += memory_info.RegionSize;
-                    continue;
+                    section_job_scan_targets.emplace_back(scan_target);
+                    section_jobs.emplace_back(std::move(section_job));
                 }
+            }
 
-                uint8_t* region_end = static_cast<uint8_t*>(memory_info.BaseAddress) + memory_info.RegionSize;
+            scan_jobs(section_jobs);
 
-                for (uint8_t* region_start = static_cast<uint8_t*>(memory_info.BaseAddress); region_start < region_end; ++region_start)
-                {
-                    if (region_start > end_address)
-                    {
-                        break;
-                    }
+            for (size_t job_index = 0; job_index < section_jobs.size(); ++job_index)
+            {
+                record_module_scan_stats(section_job_scan_targets[job_index], section_jobs[job_index]);
+            }
 
-                    bool skip_to_next_container{};
+            for (size_t job_index = 0; job_index < jobs.size(); ++job_index)
+            {
+                store_scan_results(scan_targets[job_index], jobs[job_index]);
+            }
+            save_scan_cache();
 
-                    for (size_t container_index = 0; const auto& int_container : vector_of_sigs)
-                    {
-                        for (size_t signature_index = 0; const auto& sig : int_container)
-                        {
-                            // If the container is refusing more calls then skip to the next container
-                            if (signature_containers[container_index].ignore)
-                            {
-                                break;
-                            }
-
-                            // Skip if we're about to dereference uninitialized memory
-                            if (region_start + sig.size() > region_end)
-                            {
-                                break;
-                            }
-
-                            for (size_t sig_i = 0; sig_i < sig.size(); sig_i += 2)
-                            {
-                                if (sig.at(sig_i) != -1 && sig.at(sig_i) != HI_NIBBLE(*(byte*)(region_start + (sig_i / 2))) ||
-                                    sig.at(sig_i + 1) != -1 && sig.at(sig_i + 1) != LO_NIBBLE(*(byte*)(region_start + (sig_i / 2))))
-                                {
-                                    break;
-                                }
-
-                                if (sig_i + 2 == sig.size())
-                                {
-                                    {
-                                        std::lock_guard<std::mutex> safe_scope(m_scanner_mutex);
-
-                                        // Checking for the second time if the container is refusing more calls
-                                        // This is required when multi-threading is enabled
-                                        if (signature_containers[container_index].ignore)
-                                        {
-                                            skip_to_next_container = true;
-                                            break;
-                                        }
-
-                                        // One of the signatures have found a full match so lets forward the details to the callable
-                                        signature_containers[container_index].index_into_signatures = signature_index;
-                                        signature_containers[container_index].match_address = region_start;
-                                        signature_containers[container_index].match_signature_size = sig.size() / 2;
-
-                                        skip_to_next_container = signature_containers[container_index].on_match_found(signature_containers[container_index]);
-                                        signature_containers[container_index].ignore = skip_to_next_container;
-
-                                        // Store results if the container at the containers request
-                                        if (signature_containers[container_index].store_results)
-                                        {
-                                            signature_containers[container_index].result_store.emplace_back(
-                                                    SignatureContainerLight{.index_into_signatures = signature_index, .match_address = region_start});
-                                        }
-                                    }
-
-                                    break;
-                                }
-                            }
-
-                            if (skip_to_next_container)
-                            {
-                                // A match was found and signaled to skip to the next container
-                                break;
-                            }
-
-                            ++signature_index;
-                        }
-
-                        ++container_index;
-                    }
+            for (const auto& job : jobs)
+            {
+                for (auto& container : *job.signature_containers)
+                {
+                    container.on_scan_finished(container);
                 }
-
-                i = static_cast<uint8_t*>(memory_info.BaseAddress) + memory_info.RegionSize;
             }
         }
     }
 
-    static auto format_aob_string(std::string& str) -> void
+    auto SinglePassScanner::scan_module_for_pending_containers(void* module_handle, std::vector<SignatureContainer>& signature_containers) -> void
     {
-        if (str.size() < 4)
+        MODULEINFO module_info{};
+        if (GetModuleInformation(GetCurrentProcess(), static_cast<HMODULE>(module_handle), &module_info, sizeof(module_info)))
         {
-            return;
+            uint8_t* module_start_address = static_cast<uint8_t*>(module_info.lpBaseOfDll);
+            uint8_t* module_end_address = module_start_address + module_info.SizeOfImage;
+
+            ScanJob job{module_start_address, module_end_address, get_readable_regions(module_start_address, module_end_address), &signature_containers};
+            auto section_jobs = split_job_by_section(job);
+            scan_jobs(section_jobs);
         }
-        if (str[3] != '/')
+
+        for (auto& container : signature_containers)
         {
-            return;
+            container.on_scan_finished(container);
         }
-
-        std::erase_if(str, [&](const char c) {
-            return c == ' ';
-        });
-
-        std::ranges::transform(str, str.begin(), [&str](const char c) {
-            return c == '/' ? ' ' : c;
-        });
     }
 
-    auto SinglePassScanner::format_aob_strings(std::vector<SignatureContainer>& signature_containers) -> void
+    auto SinglePassScanner::add_pending_containers(std::wstring module_name, std::vector<SignatureContainer> signature_containers) -> void
     {
-        std::lock_guard<std::mutex> safe_scope(m_scanner_mutex);
-        for (auto& signature_container : signature_containers)
+        HMODULE module{};
         {
-            for (auto& signature : signature_container.signatures)
+            // The lock is held until the containers are queued so that a module that's loaded in the meantime can't be missed
+            std::lock_guard<std::mutex> lock(m_pending_containers_mutex);
+            module = GetModuleHandleW(module_name.c_str());
+            if (!module)
             {
-                format_aob_string(signature.signature);
+                m_pending_containers.emplace_back(PendingContainers{std::move(module_name), std::move(signature_containers)});
+                return;
             }
         }
+
+        scan_module_for_pending_containers(module, signature_containers);
     }
 
-    auto SinglePassScanner::scanner_work_thread_stdfind(uint8_t* start_address,
-                                                        uint8_t* end_address,
-                                                        SYSTEM_INFO& info,
-                                                        std::vector<SignatureContainer>& signature_containers) -> void
+    auto SinglePassScanner::scan_loaded_module(void* module_handle) -> void
     {
-        ProfilerScope();
-
-        if (!start_address)
+        if (!module_handle)
         {
-            start_address = static_cast<uint8_t*>(info.lpMinimumApplicationAddress);
-        }
-        if (!end_address)
-        {
-            start_address = static_cast<uint8_t*>(info.lpMaximumApplicationAddress);
+            return;
         }
 
-        format_aob_strings(signature_containers);
-
-        std::vector<std::vector<PatternData>> pattern_datas{};
-        for (auto& signature_container : signature_containers)
+        wchar_t module_path[MAX_PATH]{};
+        if (!GetModuleFileNameW(static_cast<HMODULE>(module_handle), module_path, MAX_PATH))
         {
-            auto& pattern_data = pattern_datas.emplace_back();
-            for (auto& signature : signature_container.signatures)
-            {
-                pattern_data.emplace_back(make_mask(signature.signature, signature_container, end_address - start_address));
-            }
+            return;
         }
+        const auto module_name = std::filesystem::path{module_path}.filename().wstring();
 
-        // Loop everything
-        for (size_t container_index = 0; const auto& patterns : pattern_datas)
+        // Every set of containers that's waiting for this module is taken out of the queue first so that it's only ever scanned once
+        // All of them are then scanned for in a single pass
+        std::vector<SignatureContainer> signature_containers{};
         {
-            for (size_t signature_index = 0; const auto& pattern_data : patterns)
-            {
-                // If the container is refusing more calls then skip to the next container
-                if (pattern_data.signature_container->ignore)
+            std::lock_guard<std::mutex> lock(m_pending_containers_mutex);
+            std::erase_if(m_pending_containers, [&](PendingContainers& pending_containers) {
+                if (CompareStringOrdinal(pending_containers.module_name.c_str(), -1, module_name.c_str(), -1, TRUE) != CSTR_EQUAL)
                 {
-                    break;
+                    return false;
                 }
 
-                auto it = start_address;
-                auto end = it + (end_address - start_address) - (pattern_data.pattern.size()) + 1;
-                uint8_t needle = pattern_data.pattern[0];
-
-                bool skip_to_next_container{};
-                while (end != (it = std::find(it, end, needle)))
+                for (auto& container : pending_containers.signature_containers)
                 {
-                    bool found = true;
-                    for (size_t pattern_offset = 0; pattern_offset < pattern_data.pattern.size(); ++pattern_offset)
-                    {
-                        if ((it[pattern_offset] & pattern_data.mask[pattern_offset]) != pattern_data.pattern[pattern_offset])
-                        {
-                            found = false;
-                            break;
-                        }
-                    }
-
-                    if (found)
-                    {
-                        {
-                            std::lock_guard<std::mutex> safe_scope(m_scanner_mutex);
-
-                            // Checking for the second time if the container is refusing more calls
-                            // This is required when multi-threading is enabled
-                            if (pattern_data.signature_container->ignore)
-                            {
-                                skip_to_next_container = true;
-                                break;
-                            }
-
-                            // One of the signatures have found a full match so lets forward the details to the callable
-                            pattern_data.signature_container->index_into_signatures = signature_index;
-                            pattern_data.signature_container->match_address = it;
-                            pattern_data.signature_container->match_signature_size = pattern_data.pattern.size();
-
-                            skip_to_next_container = pattern_data.signature_container->on_match_found(*pattern_data.signature_container);
-                            pattern_data.signature_container->ignore = skip_to_next_container;
-
-                            // Store results if the container at the containers request
-                            if (pattern_data.signature_container->store_results)
-                            {
-                                pattern_data.signature_container->result_store.emplace_back(
-                                        SignatureContainerLight{.index_into_signatures = signature_index, .match_address = it});
-                            }
-                        }
-                    }
-
-                    it++;
+                    signature_containers.emplace_back(std::move(container));
                 }
+                return true;
+            });
+        }
 
-                if (skip_to_next_container)
-                {
-                    // A match was found and signaled to skip to the next container
-                    break;
-                }
+        if (!signature_containers.empty())
+        {
+            scan_module_for_pending_containers(module_handle, signature_containers);
+        }
+    }
 
-                ++signature_index;
-            }
-            ++container_index;
+    auto SinglePassScanner::get_pending_module_names() -> std::vector<std::wstring>
+    {
+        std::lock_guard<std::mutex> lock(m_pending_containers_mutex);
+
+        std::vector<std::wstring> module_names{};
+        for (const auto& pending_containers : m_pending_containers)
+        {
+            module_names.emplace_back(pending_containers.module_name);
         }
+        return module_names;
     }
 
-    auto SinglePassScanner::start_scan(SignatureContainerMap& signature_containers) -> void
+    // ntdll doesn't have an import library or a header for these, they're documented at 'LdrDllNotification' on MSDN
+    // Only the base of the module is needed, the names are left as opaque pointers so that winternl.h isn't needed
+    struct LdrDllNotificationData
+    {
+        ULONG flags;
+        const void* full_dll_name;
+        const void* base_dll_name;
+        void* dll_base;
+        ULONG size_of_image;
+    };
+    using LdrDllNotificationFunction = VOID(NTAPI*)(ULONG reason, const LdrDllNotificationData* data, PVOID context);
+    using LdrRegisterDllNotificationFunction = LONG(NTAPI*)(ULONG flags, LdrDllNotificationFunction callback, PVOID context, PVOID* cookie);
+    using LdrUnregisterDllNotificationFunction = LONG(NTAPI*)(PVOID cookie);
+    static constexpr ULONG LdrDllNotificationReasonLoaded = 1;
+
+    // The loader reports modules while it holds the loader lock, nothing that can take the loader lock or 'm_pending_containers_mutex' is done there
+    // 'add_pending_containers' holds that mutex while it calls GetModuleHandleW, so taking it from the notification could deadlock
+    struct ModuleLoadWatcher
     {
-        SYSTEM_INFO info{};
-        GetSystemInfo(&info);
+        std::mutex mutex{};
+        std::condition_variable condition{};
+        std::deque<void*> loaded_modules{};
+        bool should_stop{};
+        std::thread thread{};
 
-        // If not modular then the containers get merged into one scan target
-        // That way there are no extra scans
-        // If modular then loop the containers and retrieve the scan target for each and pass everything to the do_scan() lambda
+        // Only held while registering and unregistering, 'mutex' is taken by the notifications and can't be held while calling into the loader
+        std::mutex registration_mutex{};
+        void* cookie{};
 
-        if (!SigScannerStaticData::m_is_modular)
+        static auto get() -> ModuleLoadWatcher&
         {
-            MODULEINFO merged_module_info{};
-            std::vector<SignatureContainer> merged_containers;
+            static ModuleLoadWatcher watcher{};
+            return watcher;
+        }
 
-            for (const auto& [scan_target, outer_container] : signature_containers)
+        static VOID NTAPI on_dll_notification(ULONG reason, const LdrDllNotificationData* data, PVOID context)
+        {
+            if (reason != LdrDllNotificationReasonLoaded || !data)
             {
-                merged_module_info = *std::bit_cast<MODULEINFO*>(&SigScannerStaticData::m_modules_info[scan_target]);
-                for (const auto& signature_container : outer_container)
-                {
-                    merged_containers.emplace_back(signature_container);
-                }
+                return;
             }
 
-            if (merged_containers.empty())
+            auto& watcher = *static_cast<ModuleLoadWatcher*>(context);
             {
-                throw std::runtime_error{"[SinglePassScanner::start_scan] Could not merge containers. Either there were not containers to merge or there was "
-                                         "an internal error."};
+                std::lock_guard<std::mutex> lock(watcher.mutex);
+                watcher.loaded_modules.emplace_back(data->dll_base);
             }
+            watcher.condition.notify_one();
+        }
 
-            uint8_t* module_start_address = static_cast<uint8_t*>(merged_module_info.lpBaseOfDll);
+        auto stop_thread() -> void
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                should_stop = true;
+                loaded_modules.clear();
+            }
+            condition.notify_one();
 
-            if (merged_module_info.SizeOfImage >= m_multithreading_module_size_threshold)
+            if (thread.joinable())
             {
-                // Module is large enough to make it overall faster to scan with multiple threads
-                std::vector<std::future<void>> scan_threads;
+                thread.join();
+            }
+        }
 
-                // Higher values are better for debugging
-                // You will get a bigger diminishing returns the faster your computer is (especially in release mode)
-                uint32_t range = merged_module_info.SizeOfImage / m_num_threads;
+        auto thread_main() -> void
+        {
+            ProfilerSetThreadName("UE4SS-ModuleLoadScanner");
 
-                // Calculating the ranges for each thread to scan and starting the scan
-                uint32_t last_range{};
-                for (uint32_t thread_id = 0; thread_id < m_num_threads; ++thread_id)
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true)
+            {
+                condition.wait(lock, [&] {
+                    return should_stop || !loaded_modules.empty();
+                });
+                if (should_stop)
                 {
-                    scan_threads.emplace_back(std::async(std::launch::async,
-                                                         &scanner_work_thread,
-                                                         module_start_address + last_range,
-                                                         module_start_address + last_range + range,
-                                                         std::ref(info),
-                                                         std::ref(merged_containers)));
-
-                    last_range += range;
+                    return;
                 }
 
-                for (const auto& scan_thread : scan_threads)
+                void* module_base = loaded_modules.front();
+                loaded_modules.pop_front();
+                lock.unlock();
+
+                // The module is pinned while it's scanned, and skipped if it was unloaded again before this thread got to it
+                HMODULE module{};
+                if (GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS, static_cast<LPCWSTR>(module_base), &module))
                 {
-                    scan_thread.wait();
+                    try
+                    {
+                        SinglePassScanner::scan_loaded_module(module);
+                    }
+                    catch (std::exception&)
+                    {
+                        // A callback threw, that container is on its own but the thread must keep scanning the modules after it
+                    }
+                    FreeLibrary(module);
                 }
-            }
-            else
-            {
-                // Module is too small to make it overall faster to scan with multiple threads
-                uint8_t* module_end_address = static_cast<uint8_t*>(module_start_address + merged_module_info.SizeOfImage);
-                scanner_work_thread(module_start_address, module_end_address, info, merged_containers);
-            }
 
-            for (auto& container : merged_containers)
-            {
-                container.on_scan_finished(container);
+                lock.lock();
             }
         }
-        else
+    };
+
+    auto SinglePassScanner::start_watching_module_loads() -> bool
+    {
+        auto& watcher = ModuleLoadWatcher::get();
+        std::lock_guard<std::mutex> registration_lock(watcher.registration_mutex);
+        if (watcher.cookie)
         {
-            // This ranged for loop is performing a copy of unordered_map<ScanTarget, vector<SignatureContainer>>
-            // Is this required ? Would it be worth trying to avoid copying here ?
-            // Right now it can't be auto& or const auto& because the do_scan function takes a non-const since it needs to mutate the values inside the vector
-            for (auto& [scan_target, signature_container] : signature_containers)
-            {
-                uint8_t* module_start_address = static_cast<uint8_t*>(SigScannerStaticData::m_modules_info[scan_target].lpBaseOfDll);
-                uint8_t* module_end_address = static_cast<uint8_t*>(module_start_address + SigScannerStaticData::m_modules_info[scan_target].SizeOfImage);
+            return true;
+        }
+
+        HMODULE ntdll = GetModuleHandleW(L"ntdll.dll");
+        auto register_dll_notification =
+                ntdll ? reinterpret_cast<LdrRegisterDllNotificationFunction>(GetProcAddress(ntdll, "LdrRegisterDllNotification")) : nullptr;
+        if (!register_dll_notification)
+        {
+            return false;
+        }
 
-                scanner_work_thread(module_start_address, module_end_address, info, signature_container);
+        watcher.should_stop = false;
+        watcher.thread = std::thread{&ModuleLoadWatcher::thread_main, &watcher};
+        if (register_dll_notification(0, &ModuleLoadWatcher::on_dll_notification, &watcher, &watcher.cookie) < 0)
+        {
+            watcher.cookie = nullptr;
+            watcher.stop_thread();
+            return false;
+        }
 
-                for (auto& container : signature_container)
-                {
-                    container.on_scan_finished(container);
-                }
-            }
+        return true;
+    }
+
+    auto SinglePassScanner::stop_watching_module_loads() -> void
+    {
+        auto& watcher = ModuleLoadWatcher::get();
+        std::lock_guard<std::mutex> registration_lock(watcher.registration_mutex);
+        if (!watcher.cookie)
+        {
+            return;
+        }
+
+        // Unregistering waits for the loader lock, which a notification that's waiting for 'watcher.mutex' holds, so that mutex must not be held here
+        HMODULE ntdll = GetModuleHandleW(L"ntdll.dll");
+        if (auto unregister_dll_notification = reinterpret_cast<LdrUnregisterDllNotificationFunction>(GetProcAddress(ntdll, "LdrUnregisterDllNotification")))
+        {
+            unregister_dll_notification(watcher.cookie);
         }
+        watcher.cookie = nullptr;
+        watcher.stop_thread();
     }
-} // namespace RC
\ No newline at end of file
+} // namespace RC